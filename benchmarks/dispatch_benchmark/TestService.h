@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+#include <iostream>
+
+using namespace Ichor;
+
+constexpr uint64_t EVENT_COUNT = 5'000'000;
+constexpr uint64_t PUSH_BATCH_SIZE = 1'000;
+constexpr uint64_t OTHER_EVENT_TYPES = 16;
+static_assert(EVENT_COUNT % PUSH_BATCH_SIZE == 0);
+
+template <uint64_t N>
+struct DispatchEvent final : public Event {
+    explicit DispatchEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority) {}
+    ~DispatchEvent() final = default;
+
+    static constexpr uint64_t TYPE = typeNameHash<DispatchEvent<N>>();
+    static constexpr std::string_view NAME = typeName<DispatchEvent<N>>();
+};
+
+// Handles DispatchEvent<0> and registers handlers and, optionally, interceptors for other event types, so that dispatch has to look up the right ones
+class TestService final : public Service<TestService> {
+public:
+    TestService(Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        _registerInterceptors = Ichor::any_cast<bool>(getProperties()["Interceptors"]);
+    }
+    ~TestService() final = default;
+
+    StartBehaviour start() final {
+        _handlers.push_back(getManager()->registerEventHandler<DispatchEvent<0>>(this));
+        registerOtherHandlers(std::make_index_sequence<OTHER_EVENT_TYPES>{});
+
+        // push the events once this service is active, instead of while it is still starting
+        getManager()->pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), INTERNAL_EVENT_PRIORITY + 1, [this](DependencyManager *dm) {
+            for(uint64_t i = 0; i < EVENT_COUNT; i += PUSH_BATCH_SIZE) {
+                dm->pushEvents<DispatchEvent<0>>(getServiceId(), PUSH_BATCH_SIZE, [](uint64_t) { return std::tuple{}; });
+            }
+            dm->pushEvent<QuitEvent>(getServiceId());
+            _start = std::chrono::steady_clock::now();
+        });
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+        std::cout << fmt::format("Dispatched {:L} events {} interceptors in {:L} µs, {:L} ns per event\n", _handled, _registerInterceptors ? "with" : "without", ns / 1'000, static_cast<uint64_t>(ns) / std::max<uint64_t>(_handled, 1));
+        _handlers.clear();
+        _interceptors.clear();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    template <uint64_t N>
+    Generator<bool> handleEvent(DispatchEvent<N> const * const) {
+        _handled++;
+        co_return (bool)AllowOthersHandling;
+    }
+
+    template <uint64_t N>
+    bool preInterceptEvent(DispatchEvent<N> const * const) {
+        return AllowOthersHandling;
+    }
+
+    template <uint64_t N>
+    void postInterceptEvent(DispatchEvent<N> const * const, bool) {
+    }
+
+private:
+    template <std::size_t... Ns>
+    void registerOtherHandlers(std::index_sequence<Ns...>) {
+        (_handlers.push_back(getManager()->registerEventHandler<DispatchEvent<Ns + 1>>(this)), ...);
+        if(_registerInterceptors) {
+            (_interceptors.push_back(getManager()->registerEventInterceptor<DispatchEvent<Ns + 1>>(this)), ...);
+        }
+    }
+
+    std::vector<EventHandlerRegistration> _handlers{};
+    std::vector<EventInterceptorRegistration> _interceptors{};
+    std::chrono::steady_clock::time_point _start{};
+    uint64_t _handled{};
+    bool _registerInterceptors{};
+};
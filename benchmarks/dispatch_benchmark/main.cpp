@@ -0,0 +1,20 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <iostream>
+
+// Measures the cost of dispatching an event to its handler, excluding the cost of pushing it
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    for(uint64_t i = 0; i < 6; i++) {
+        std::pmr::unsynchronized_pool_resource resourceOne{};
+        std::pmr::unsynchronized_pool_resource resourceTwo{};
+        DependencyManager dm{&resourceOne, &resourceTwo};
+        auto logMgr = dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+        logMgr->setLogLevel(LogLevel::WARN);
+        dm.createServiceManager<TestService>(Properties{{"Interceptors", Ichor::make_any<bool>(dm.getMemoryResource(), i % 2 == 1)}});
+        dm.start();
+    }
+
+    return 0;
+}
@@ -4,9 +4,14 @@
 #include <ichor/optional_bundles/logging_bundle/Logger.h>
 #include <ichor/Service.h>
 #include <ichor/LifecycleManager.h>
+#include <iostream>
 
 using namespace Ichor;
 
+constexpr uint64_t EVENT_COUNT = 5'000'000;
+constexpr uint64_t PUSH_BATCH_SIZE = 1'000;
+static_assert(EVENT_COUNT % PUSH_BATCH_SIZE == 0);
+
 struct UselessEvent final : public Event {
     explicit UselessEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept :
             Event(TYPE, NAME, _id, _originatingService, _priority) {}
@@ -16,6 +21,67 @@ struct UselessEvent final : public Event {
     static constexpr std::string_view NAME = typeName<UselessEvent>();
 };
 
+// Handles every UselessEvent, either with a coroutine or with a plain function
+template <bool Synchronous>
+class HandlerService final : public Service<HandlerService<Synchronous>> {
+public:
+    HandlerService() = default;
+    ~HandlerService() final = default;
+
+    StartBehaviour start() final {
+        _registration = this->getManager()->template registerEventHandler<UselessEvent>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _registration.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    Generator<bool> handleEvent(UselessEvent const * const) requires (!Synchronous) {
+        _handled++;
+        co_return (bool)AllowOthersHandling;
+    }
+
+    bool handleEvent(UselessEvent const * const) requires Synchronous {
+        _handled++;
+        return AllowOthersHandling;
+    }
+
+private:
+    EventHandlerRegistration _registration{};
+    uint64_t _handled{};
+};
+
+// Yields once per event, resuming it has to interleave with the events that are still queued
+class YieldingHandlerService final : public Service<YieldingHandlerService> {
+public:
+    YieldingHandlerService() = default;
+    ~YieldingHandlerService() final = default;
+
+    StartBehaviour start() final {
+        _registration = this->getManager()->template registerEventHandler<UselessEvent>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _registration.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    Generator<bool> handleEvent(UselessEvent const * const) {
+        _handled++;
+        co_yield (bool)AllowOthersHandling;
+        _resumed++;
+        co_return (bool)AllowOthersHandling;
+    }
+
+private:
+    EventHandlerRegistration _registration{};
+    uint64_t _handled{};
+    uint64_t _resumed{};
+};
+
 class TestService final : public Service<TestService> {
 public:
     TestService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
@@ -24,16 +90,20 @@ public:
     ~TestService() final = default;
     StartBehaviour start() final {
         auto start = std::chrono::steady_clock::now();
-        for(uint32_t i = 0; i < 5'000'000; i++) {
-            getManager()->pushEvent<UselessEvent>(getServiceId());
+        for(uint64_t i = 0; i < EVENT_COUNT; i += PUSH_BATCH_SIZE) {
+            getManager()->pushEvents<UselessEvent>(getServiceId(), PUSH_BATCH_SIZE, [](uint64_t) { return std::tuple{}; });
         }
-        auto end = std::chrono::steady_clock::now();
+        _insertEnd = std::chrono::steady_clock::now();
         getManager()->pushEvent<QuitEvent>(getServiceId());
-        ICHOR_LOG_WARN(_logger, "Inserted events in {:L} µs", std::chrono::duration_cast<std::chrono::microseconds>(end-start).count());
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(_insertEnd - start).count();
+        std::cout << fmt::format("Inserted events in {:L} µs ({:L} events/s)\n", us, EVENT_COUNT * 1'000'000 / static_cast<uint64_t>(std::max<int64_t>(us, 1)));
         return Ichor::StartBehaviour::SUCCEEDED;
     }
 
     StartBehaviour stop() final {
+        // the quit event is processed after all inserted events, so this measures draining the queue
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _insertEnd).count();
+        std::cout << fmt::format("Drained events in {:L} µs ({:L} events/s)\n", us, EVENT_COUNT * 1'000'000 / static_cast<uint64_t>(std::max<int64_t>(us, 1)));
         return Ichor::StartBehaviour::SUCCEEDED;
     }
 
@@ -47,4 +117,5 @@ public:
 
 private:
     ILogger *_logger{nullptr};
+    std::chrono::steady_clock::time_point _insertEnd{};
 };
\ No newline at end of file
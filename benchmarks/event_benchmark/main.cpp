@@ -17,14 +17,43 @@
 #include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
 #include <iostream>
 
-int main() {
-    std::locale::global(std::locale("en_US.UTF-8"));
+// Counts allocations, to verify that events are stored inline in the event queue instead of allocated one by one
+class CountingMemoryResource final : public std::pmr::memory_resource {
+public:
+    explicit CountingMemoryResource(std::pmr::memory_resource *upstream) noexcept : _upstream(upstream) {}
+
+    [[nodiscard]] uint64_t getAllocations() const noexcept {
+        return _allocations;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) final {
+        _allocations++;
+        return _upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) final {
+        _upstream->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource *_upstream;
+    uint64_t _allocations{};
+};
+
+void runBenchmark(EventQueueType queueType, std::string_view queueName) {
+    std::cout << fmt::format("Using {} event queue\n", queueName);
 
     {
         auto start = std::chrono::steady_clock::now();
         std::pmr::unsynchronized_pool_resource resourceOne{};
         std::pmr::unsynchronized_pool_resource resourceTwo{};
-        DependencyManager dm{&resourceOne, &resourceTwo};
+        CountingMemoryResource countingOne{&resourceOne};
+        CountingMemoryResource countingTwo{&resourceTwo};
+        DependencyManager dm{&countingOne, &countingTwo, queueType};
         auto logMgr = dm.createServiceManager<FRAMEWORK_LOGGER_TYPE, IFrameworkLogger>({}, 10);
         logMgr->setLogLevel(LogLevel::INFO);
 
@@ -36,7 +65,7 @@ int main() {
         dm.createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(dm.getMemoryResource(), LogLevel::WARN)}});
         dm.start();
         auto end = std::chrono::steady_clock::now();
-        std::cout << fmt::format("Single Threaded Program ran for {:L} µs with {:L} peak memory usage\n", std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+        std::cout << fmt::format("Single Threaded Program ran for {:L} µs with {:L} peak memory usage and {:L} allocations for {:L} events\n", std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS(), countingOne.getAllocations() + countingTwo.getAllocations(), EVENT_COUNT);
     }
 
     std::array<std::pmr::unsynchronized_pool_resource, 16> memoryAllocators{};
@@ -46,7 +75,7 @@ int main() {
         std::vector<DependencyManager> managers{};
         managers.reserve(8);
         for (uint_fast32_t i = 0, j = 0; i < 8; i++, j += 2) {
-            managers.emplace_back(&memoryAllocators[j], &memoryAllocators[j + 1]);
+            managers.emplace_back(&memoryAllocators[j], &memoryAllocators[j + 1], queueType);
             threads[i] = std::thread([&managers, i] {
                 auto logMgr = managers[i].createServiceManager<FRAMEWORK_LOGGER_TYPE, IFrameworkLogger>({}, 10);
                 logMgr->setLogLevel(LogLevel::INFO);
@@ -67,6 +96,43 @@ int main() {
         std::cout << fmt::format("Multi Threaded program ran for {:L} µs with {:L} peak memory usage\n",
                                  std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
     }
+}
+
+template <typename HandlerT>
+void runHandlerBenchmark(std::string_view handlerName) {
+    std::cout << fmt::format("Using {} event handler\n", handlerName);
+
+    auto start = std::chrono::steady_clock::now();
+    std::pmr::unsynchronized_pool_resource resourceOne{};
+    std::pmr::unsynchronized_pool_resource resourceTwo{};
+    CountingMemoryResource countingOne{&resourceOne};
+    CountingMemoryResource countingTwo{&resourceTwo};
+    DependencyManager dm{&countingOne, &countingTwo};
+    auto logMgr = dm.createServiceManager<FRAMEWORK_LOGGER_TYPE, IFrameworkLogger>({}, 10);
+    logMgr->setLogLevel(LogLevel::INFO);
+
+#ifdef ICHOR_USE_SPDLOG
+    dm.createServiceManager<SpdlogSharedService, ISpdlogSharedService>();
+#endif
+
+    dm.createServiceManager<LoggerAdmin<LOGGER_TYPE>, ILoggerAdmin>();
+    dm.createServiceManager<HandlerT>();
+    dm.createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(dm.getMemoryResource(), LogLevel::WARN)}});
+    dm.start();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << fmt::format("Single Threaded Program ran for {:L} µs with {:L} allocations for {:L} handled events\n", std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), countingOne.getAllocations() + countingTwo.getAllocations(), EVENT_COUNT);
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    runHandlerBenchmark<HandlerService<false>>("coroutine");
+    runHandlerBenchmark<HandlerService<true>>("synchronous");
+    runHandlerBenchmark<YieldingHandlerService>("yielding");
+
+    runBenchmark(EventQueueType::LOCKED_MULTIMAP, "locked multimap");
+    runBenchmark(EventQueueType::PRIORITY_BUCKETS, "priority buckets");
+    runBenchmark(EventQueueType::LOCK_FREE_MPSC, "lock-free mpsc");
 
     return 0;
 }
\ No newline at end of file
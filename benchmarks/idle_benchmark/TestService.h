@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+using namespace Ichor;
+
+std::atomic<uint64_t> startedServices{};
+
+struct IdleEvent final : public Event {
+    explicit IdleEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority) {}
+    ~IdleEvent() final = default;
+
+    static constexpr uint64_t TYPE = typeNameHash<IdleEvent>();
+    static constexpr std::string_view NAME = typeName<IdleEvent>();
+};
+
+class TestService final : public Service<TestService> {
+public:
+    TestService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+    }
+    ~TestService() final = default;
+
+    StartBehaviour start() final {
+        _eventRegistration = getManager()->registerEventHandler<IdleEvent>(this);
+        startedServices.fetch_add(1, std::memory_order_acq_rel);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _eventRegistration.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    Generator<bool> handleEvent(IdleEvent const * const) {
+        co_return (bool)PreventOthersHandling;
+    }
+
+private:
+    EventHandlerRegistration _eventRegistration{};
+};
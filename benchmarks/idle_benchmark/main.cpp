@@ -0,0 +1,92 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
+#include <iostream>
+#include <ctime>
+
+// Measures how often idle managers wake up. Ideally they only wake up when an event is pushed to them.
+constexpr uint64_t MANAGER_COUNT = 8;
+constexpr auto IDLE_DURATION = std::chrono::seconds(2);
+constexpr auto TRICKLE_INTERVAL = std::chrono::milliseconds(1);
+
+void printStatistics(std::string_view phase, std::vector<DependencyManager> &dms, std::vector<EventLoopStatistics> const &before, std::chrono::steady_clock::duration duration, std::clock_t cpuStart) {
+    uint64_t parks{};
+    uint64_t notifications{};
+    for(uint64_t i = 0; i < MANAGER_COUNT; i++) {
+        auto stats = dms[i].getEventLoopStatistics();
+        parks += stats.parks - before[i].parks;
+        notifications += stats.notifications - before[i].notifications;
+    }
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    auto cpuMs = (std::clock() - cpuStart) * 1'000 / CLOCKS_PER_SEC;
+    std::cout << fmt::format("{}: {:L} wakeups/s per manager, {:L} notifications/s per manager, {:L} ms cpu time in {:L} ms\n", phase,
+                             parks * 1'000 / MANAGER_COUNT / static_cast<uint64_t>(ms), notifications * 1'000 / MANAGER_COUNT / static_cast<uint64_t>(ms), cpuMs, ms);
+}
+
+std::vector<EventLoopStatistics> getStatistics(std::vector<DependencyManager> &dms) {
+    std::vector<EventLoopStatistics> ret;
+    for(auto &dm : dms) {
+        ret.push_back(dm.getEventLoopStatistics());
+    }
+    return ret;
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    std::array<std::pmr::unsynchronized_pool_resource, MANAGER_COUNT> resourceOnes{};
+    std::array<std::pmr::unsynchronized_pool_resource, MANAGER_COUNT> resourceTwos{};
+    std::vector<DependencyManager> dms{};
+    dms.reserve(MANAGER_COUNT);
+    std::vector<std::thread> threads{};
+    threads.reserve(MANAGER_COUNT);
+
+    for(uint64_t i = 0; i < MANAGER_COUNT; i++) {
+        auto &dm = dms.emplace_back(&resourceOnes[i], &resourceTwos[i]);
+        auto logMgr = dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+        logMgr->setLogLevel(LogLevel::WARN);
+        dm.createServiceManager<TestService>();
+    }
+
+    for(uint64_t i = 0; i < MANAGER_COUNT; i++) {
+        threads.emplace_back([&dm = dms[i]] {
+            dm.start();
+        });
+    }
+
+    while(startedServices.load(std::memory_order_acquire) != MANAGER_COUNT) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for(auto &dm : dms) {
+        dm.waitForEmptyQueue();
+    }
+
+    auto before = getStatistics(dms);
+    auto cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(IDLE_DURATION);
+    printStatistics("idle", dms, before, std::chrono::steady_clock::now() - start, cpuStart);
+
+    before = getStatistics(dms);
+    cpuStart = std::clock();
+    start = std::chrono::steady_clock::now();
+    while(std::chrono::steady_clock::now() - start < IDLE_DURATION) {
+        for(auto &dm : dms) {
+            dm.pushEvent<IdleEvent>(0);
+        }
+        std::this_thread::sleep_for(TRICKLE_INTERVAL);
+    }
+    printStatistics("one event per ms", dms, before, std::chrono::steady_clock::now() - start, cpuStart);
+
+    for(auto &dm : dms) {
+        dm.pushEvent<QuitEvent>(0);
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+
+    std::cout << fmt::format("Peak memory usage {:L}\n", getPeakRSS());
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+using namespace Ichor;
+
+constexpr uint64_t EVENT_COUNT = 2'000'000;
+std::atomic<bool> consumerStarted{};
+
+struct UselessEvent final : public Event {
+    explicit UselessEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority) {}
+    ~UselessEvent() final = default;
+
+    static constexpr uint64_t TYPE = typeNameHash<UselessEvent>();
+    static constexpr std::string_view NAME = typeName<UselessEvent>();
+};
+
+class TestService final : public Service<TestService> {
+public:
+    TestService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+    }
+    ~TestService() final = default;
+
+    StartBehaviour start() final {
+        _eventRegistration = getManager()->registerEventHandler<UselessEvent>(this);
+        consumerStarted.store(true, std::memory_order_release);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _eventRegistration.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    Generator<bool> handleEvent(UselessEvent const * const) {
+        _handledEvents++;
+        if(_handledEvents == EVENT_COUNT) {
+            getManager()->pushEvent<QuitEvent>(getServiceId());
+        }
+        co_return (bool)PreventOthersHandling;
+    }
+
+private:
+    EventHandlerRegistration _eventRegistration{};
+    uint64_t _handledEvents{};
+};
@@ -0,0 +1,60 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
+#include <iostream>
+
+void runBenchmark(EventQueueType queueType, std::string_view queueName, uint64_t producerCount) {
+    consumerStarted.store(false, std::memory_order_release);
+
+    // producers allocate events from the main memory resource, which therefore has to be thread-safe
+    std::pmr::synchronized_pool_resource resourceOne{};
+    std::pmr::unsynchronized_pool_resource resourceTwo{};
+    DependencyManager dm{&resourceOne, &resourceTwo, queueType};
+    auto logMgr = dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+    logMgr->setLogLevel(LogLevel::WARN);
+    dm.createServiceManager<TestService>();
+
+    std::thread dmThread([&dm] {
+        dm.start();
+    });
+
+    while(!consumerStarted.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers{};
+    producers.reserve(producerCount);
+    for(uint64_t i = 0; i < producerCount; i++) {
+        producers.emplace_back([&dm, producerCount] {
+            for(uint64_t j = 0; j < EVENT_COUNT / producerCount; j++) {
+                dm.pushEvent<UselessEvent>(0);
+            }
+        });
+    }
+
+    for(auto &producer : producers) {
+        producer.join();
+    }
+    auto pushEnd = std::chrono::steady_clock::now();
+    dmThread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    auto pushUs = std::chrono::duration_cast<std::chrono::microseconds>(pushEnd - start).count();
+    auto totalUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << fmt::format("{} with {} producers: pushed in {:L} µs, handled in {:L} µs ({:L} events/s)\n", queueName, producerCount, pushUs, totalUs, EVENT_COUNT * 1'000'000 / static_cast<uint64_t>(std::max<int64_t>(totalUs, 1)));
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    for(uint64_t producerCount : {1, 4, 16}) {
+        runBenchmark(EventQueueType::LOCKED_MULTIMAP, "locked multimap", producerCount);
+        runBenchmark(EventQueueType::PRIORITY_BUCKETS, "priority buckets", producerCount);
+        runBenchmark(EventQueueType::LOCK_FREE_MPSC, "lock-free mpsc", producerCount);
+    }
+
+    std::cout << fmt::format("Peak memory usage {:L}\n", getPeakRSS());
+
+    return 0;
+}
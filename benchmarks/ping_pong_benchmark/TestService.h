@@ -0,0 +1,68 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/CommunicationChannel.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+using namespace Ichor;
+
+constexpr uint64_t ROUND_TRIPS = 50'000;
+std::atomic<uint64_t> startedServices{};
+std::mutex latenciesMutex{};
+std::vector<uint64_t> latencies{}; // filled by the services when they stop
+
+[[nodiscard]] inline uint64_t nowNs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct PingEvent final : public Event {
+    explicit PingEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _sentAtNs, uint64_t _remaining) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority), sentAtNs(_sentAtNs), remaining(_remaining) {}
+    ~PingEvent() final = default;
+
+    uint64_t sentAtNs;
+    uint64_t remaining;
+    static constexpr uint64_t TYPE = typeNameHash<PingEvent>();
+    static constexpr std::string_view NAME = typeName<PingEvent>();
+};
+
+// Sends every PingEvent it receives back to the other manager, recording the time between the push and the dispatch of the event
+class PingPongService final : public Service<PingPongService> {
+public:
+    PingPongService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        _otherManagerId = Ichor::any_cast<uint64_t>(getProperties()["OtherManager"]);
+        _latencies.reserve(ROUND_TRIPS);
+    }
+    ~PingPongService() final = default;
+
+    StartBehaviour start() final {
+        _eventRegistration = getManager()->registerEventHandler<PingEvent>(this);
+        startedServices.fetch_add(1, std::memory_order_acq_rel);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _eventRegistration.reset();
+        std::unique_lock lck(latenciesMutex);
+        latencies.insert(latencies.end(), _latencies.begin(), _latencies.end());
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    Generator<bool> handleEvent(PingEvent const * const evt) {
+        _latencies.push_back(nowNs() - evt->sentAtNs);
+
+        if(evt->remaining == 0) {
+            getManager()->getCommunicationChannel()->sendEventTo<QuitEvent>(_otherManagerId, getServiceId());
+            getManager()->pushEvent<QuitEvent>(getServiceId());
+        } else {
+            getManager()->getCommunicationChannel()->sendEventTo<PingEvent>(_otherManagerId, getServiceId(), nowNs(), evt->remaining - 1);
+        }
+        co_return (bool)PreventOthersHandling;
+    }
+
+private:
+    EventHandlerRegistration _eventRegistration{};
+    uint64_t _otherManagerId{};
+    std::vector<uint64_t> _latencies{};
+};
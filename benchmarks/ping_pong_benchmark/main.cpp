@@ -0,0 +1,66 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
+#include <algorithm>
+#include <iostream>
+
+// Bounces an event between two managers over a CommunicationChannel and reports the latency between pushing an event and its handler being called
+void runBenchmark(IdleStrategy strategy, std::string_view strategyName) {
+    startedServices.store(0, std::memory_order_release);
+    latencies.clear();
+
+    CommunicationChannel channel{};
+    DependencyManager dmOne{};
+    DependencyManager dmTwo{};
+    channel.addManager(&dmOne);
+    channel.addManager(&dmTwo);
+
+    for(auto *dm : {&dmOne, &dmTwo}) {
+        auto otherId = dm == &dmOne ? dmTwo.getId() : dmOne.getId();
+        auto logMgr = dm->createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+        logMgr->setLogLevel(LogLevel::WARN);
+        dm->createServiceManager<PingPongService>(Properties{{"OtherManager", Ichor::make_any<uint64_t>(dm->getMemoryResource(), otherId)}});
+        dm->setIdleStrategy(strategy);
+    }
+
+    std::thread t1([&dmOne] {
+        dmOne.start();
+    });
+    std::thread t2([&dmTwo] {
+        dmTwo.start();
+    });
+
+    while(startedServices.load(std::memory_order_acquire) != 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    dmOne.waitForEmptyQueue();
+    dmTwo.waitForEmptyQueue();
+
+    dmOne.pushEvent<PingEvent>(0, nowNs(), ROUND_TRIPS * 2);
+
+    t1.join();
+    t2.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [](double p) {
+        return latencies[static_cast<uint64_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    std::cout << fmt::format("{}: p50 {:L} ns, p99 {:L} ns, p99.9 {:L} ns, max {:L} ns over {:L} events\n", strategyName, percentile(0.5), percentile(0.99), percentile(0.999), latencies.back(), latencies.size());
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    runBenchmark(IdleStrategy::BLOCK, "block");
+    runBenchmark(IdleStrategy::SPIN_THEN_PARK, "spin then park");
+    // with fewer cores, busy polling managers have to wait for the scheduler to preempt the other manager
+    if(std::thread::hardware_concurrency() > 2) {
+        runBenchmark(IdleStrategy::BUSY_POLL, "busy poll");
+    } else {
+        std::cout << "busy poll: skipped, needs a core per manager\n";
+    }
+
+    std::cout << fmt::format("Peak memory usage {:L}\n", getPeakRSS());
+
+    return 0;
+}
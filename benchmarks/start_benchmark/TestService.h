@@ -15,7 +15,8 @@ public:
     ~TestService() final = default;
     StartBehaviour start() final {
         auto iteration = Ichor::any_cast<uint64_t>(getProperties().operator[]("Iteration"));
-        if(iteration == 9'999) {
+        auto serviceCount = Ichor::any_cast<uint64_t>(getProperties().operator[]("ServiceCount"));
+        if(iteration == serviceCount - 1) {
             getManager()->pushEvent<QuitEvent>(getServiceId());
         }
         return Ichor::StartBehaviour::SUCCEEDED;
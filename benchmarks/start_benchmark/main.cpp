@@ -17,31 +17,35 @@
 #include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
 #include <iostream>
 
-int main() {
-    std::locale::global(std::locale("en_US.UTF-8"));
-
-    {
-        auto start = std::chrono::steady_clock::now();
-        std::pmr::unsynchronized_pool_resource resourceOne{};
-        std::pmr::unsynchronized_pool_resource resourceTwo{};
-        DependencyManager dm{&resourceOne, &resourceTwo};
-        auto logMgr = dm.createServiceManager<FRAMEWORK_LOGGER_TYPE, IFrameworkLogger>({}, 10);
-        logMgr->setLogLevel(LogLevel::INFO);
+void runSingleThreaded(uint64_t serviceCount) {
+    auto start = std::chrono::steady_clock::now();
+    std::pmr::unsynchronized_pool_resource resourceOne{};
+    std::pmr::unsynchronized_pool_resource resourceTwo{};
+    DependencyManager dm{&resourceOne, &resourceTwo};
+    auto logMgr = dm.createServiceManager<FRAMEWORK_LOGGER_TYPE, IFrameworkLogger>({}, 10);
+    logMgr->setLogLevel(LogLevel::INFO);
 
 
 #ifdef ICHOR_USE_SPDLOG
-        dm.createServiceManager<SpdlogSharedService, ISpdlogSharedService>();
+    dm.createServiceManager<SpdlogSharedService, ISpdlogSharedService>();
 #endif
 
-        dm.createServiceManager<LoggerAdmin<LOGGER_TYPE>, ILoggerAdmin>();
-        for (uint64_t i = 0; i < 10'000; i++) {
-            dm.createServiceManager<TestService>(Properties{{"Iteration", Ichor::make_any<uint64_t>(dm.getMemoryResource(), i)},
-                                                                 {"LogLevel",  Ichor::make_any<LogLevel>(dm.getMemoryResource(), LogLevel::WARN)}});
-        }
-        dm.start();
-        auto end = std::chrono::steady_clock::now();
-        std::cout << fmt::format("Single Threaded Program ran for {:L} µs with {:L} peak memory usage\n", std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+    dm.createServiceManager<LoggerAdmin<LOGGER_TYPE>, ILoggerAdmin>();
+    for (uint64_t i = 0; i < serviceCount; i++) {
+        dm.createServiceManager<TestService>(Properties{{"Iteration", Ichor::make_any<uint64_t>(dm.getMemoryResource(), i)},
+                                                        {"ServiceCount", Ichor::make_any<uint64_t>(dm.getMemoryResource(), serviceCount)},
+                                                        {"LogLevel",  Ichor::make_any<LogLevel>(dm.getMemoryResource(), LogLevel::WARN)}});
     }
+    dm.start();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << fmt::format("Single Threaded Program with {:L} services ran for {:L} µs with {:L} peak memory usage\n", serviceCount, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    runSingleThreaded(10'000);
+    runSingleThreaded(100'000);
 
     std::array<std::pmr::unsynchronized_pool_resource, 16> memoryAllocators{};
     {
@@ -61,7 +65,7 @@ int main() {
 
                 managers[i].createServiceManager<LoggerAdmin<LOGGER_TYPE>, ILoggerAdmin>();
                 for (uint64_t z = 0; z < 10'000; z++) {
-                    managers[i].createServiceManager<TestService>(Properties{{"Iteration", Ichor::make_any<uint64_t>(managers[i].getMemoryResource(), z)}, {"LogLevel", Ichor::make_any<LogLevel>(managers[i].getMemoryResource(), LogLevel::WARN)}});
+                    managers[i].createServiceManager<TestService>(Properties{{"Iteration", Ichor::make_any<uint64_t>(managers[i].getMemoryResource(), z)}, {"ServiceCount", Ichor::make_any<uint64_t>(managers[i].getMemoryResource(), 10'000ull)}, {"LogLevel", Ichor::make_any<LogLevel>(managers[i].getMemoryResource(), LogLevel::WARN)}});
                 }
                 managers[i].start();
             });
@@ -75,4 +79,4 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
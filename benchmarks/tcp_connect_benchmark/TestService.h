@@ -0,0 +1,70 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+#include <ichor/optional_bundles/network_bundle/NetworkEvents.h>
+#include <ichor/optional_bundles/network_bundle/IConnectionService.h>
+#include <ichor/optional_bundles/network_bundle/IHostService.h>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
+using namespace Ichor;
+
+constexpr uint64_t MAX_SHARDS = 64;
+// amount of managers whose host is listening, clients start connecting once all of them are
+inline std::atomic<uint64_t> listeningShards{};
+inline std::array<std::atomic<uint64_t>, MAX_SHARDS> acceptedConnections{};
+
+// Sends everything received on a connection back over the same connection and counts the connections accepted by its shard
+class TestService final : public Service<TestService> {
+public:
+    TestService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        reg.registerDependency<IHostService>(this, true);
+        reg.registerDependency<IConnectionService>(this, false);
+    }
+    ~TestService() final = default;
+
+    StartBehaviour start() final {
+        _dataEventRegistration = getManager()->registerEventHandler<NetworkDataEvent>(this);
+        _shard = Ichor::any_cast<uint64_t>(getProperties()["Shard"]);
+        listeningShards.fetch_add(1, std::memory_order_release);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _dataEventRegistration.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    void addDependencyInstance(IHostService *, IService *) {
+    }
+
+    void removeDependencyInstance(IHostService *, IService *) {
+    }
+
+    void addDependencyInstance(IConnectionService *connectionService, IService *isvc) {
+        _connections.emplace(isvc->getServiceId(), connectionService);
+        acceptedConnections[_shard].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void removeDependencyInstance(IConnectionService *, IService *isvc) {
+        _connections.erase(isvc->getServiceId());
+    }
+
+    bool handleEvent(NetworkDataEvent const * const evt) {
+        auto connection = _connections.find(evt->originatingService);
+        if(connection != end(_connections)) {
+            auto data = evt->getData();
+            connection->second->sendAsync(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>{data.begin(), data.end(), getMemoryResource()});
+        }
+
+        return PreventOthersHandling;
+    }
+
+private:
+    std::unordered_map<uint64_t, IConnectionService*> _connections{};
+    EventHandlerRegistration _dataEventRegistration{};
+    uint64_t _shard{};
+};
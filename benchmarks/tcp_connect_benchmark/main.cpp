@@ -0,0 +1,125 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <ichor/optional_bundles/logging_bundle/LoggerAdmin.h>
+#include <ichor/optional_bundles/logging_bundle/NullLogger.h>
+#include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
+#include <ichor/optional_bundles/network_bundle/tcp/TcpHostService.h>
+#include <ichor/optional_bundles/network_bundle/epoll/EpollReactorService.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <thread>
+
+// Shards a port over one manager per core with SO_REUSEPORT and measures how many connections per second they handle.
+// Every client thread repeatedly connects, does a single round trip and closes the connection.
+constexpr uint16_t PORT = 8015;
+constexpr uint64_t CONNECTIONS = 8'000;
+constexpr uint64_t ROUND_TRIP_SIZE = 64;
+
+int connectToServer() {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(PORT);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(::connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        throw std::runtime_error("connect failed");
+    }
+    int setting = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+    return fd;
+}
+
+void roundTrip(int fd) {
+    std::array<uint8_t, ROUND_TRIP_SIZE> buf{};
+    if(::send(fd, buf.data(), buf.size(), 0) != static_cast<ssize_t>(buf.size())) {
+        throw std::runtime_error("send failed");
+    }
+
+    uint64_t received = 0;
+    while(received < buf.size()) {
+        auto ret = ::recv(fd, buf.data() + received, buf.size() - received, 0);
+        if(ret <= 0) {
+            throw std::runtime_error("recv failed");
+        }
+        received += static_cast<uint64_t>(ret);
+    }
+}
+
+void runBenchmark(uint64_t shards, uint64_t clients) {
+    listeningShards = 0;
+    for(auto &accepted : acceptedConnections) {
+        accepted = 0;
+    }
+
+    std::deque<DependencyManager> managers{};
+    std::vector<std::thread> threads{};
+    for(uint64_t i = 0; i < shards; i++) {
+        auto &dm = managers.emplace_back();
+        threads.emplace_back([&dm, i]() {
+            auto logMgr = dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+            logMgr->setLogLevel(LogLevel::WARN);
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<EpollReactorService, IReactor>();
+            dm.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})},
+                                                                             {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), PORT)},
+                                                                             {"ReusePort", Ichor::make_any<bool>(dm.getMemoryResource(), true)},
+                                                                             {"Backlog", Ichor::make_any<int>(dm.getMemoryResource(), 4096)}});
+            dm.createServiceManager<TestService>(Properties{{"Shard", Ichor::make_any<uint64_t>(dm.getMemoryResource(), i)}});
+            dm.start();
+        });
+    }
+
+    while(listeningShards.load(std::memory_order_acquire) != shards) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clientThreads{};
+    for(uint64_t i = 0; i < clients; i++) {
+        clientThreads.emplace_back([clients]() {
+            for(uint64_t j = 0; j < CONNECTIONS / clients; j++) {
+                int fd = connectToServer();
+                roundTrip(fd);
+                ::close(fd);
+            }
+        });
+    }
+    for(auto &t : clientThreads) {
+        t.join();
+    }
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    for(auto &dm : managers) {
+        dm.pushEvent<QuitEvent>(0);
+    }
+    for(auto &t : threads) {
+        t.join();
+    }
+
+    auto total = CONNECTIONS / clients * clients;
+    auto [minAccepted, maxAccepted] = std::minmax_element(acceptedConnections.begin(), acceptedConnections.begin() + static_cast<int64_t>(shards), [](auto const &a, auto const &b) { return a.load() < b.load(); });
+    std::cout << fmt::format("{:L} shards, {:L} clients: {:L} connections in {:L} ms, {:L} connections/s, {:L} to {:L} connections per shard\n",
+                             shards, clients, total, elapsedUs / 1'000, total * 1'000'000 / static_cast<uint64_t>(std::max<int64_t>(elapsedUs, 1)), minAccepted->load(), maxAccepted->load());
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    // half of the cores serve, the other half run clients
+    uint64_t shards = std::clamp<uint64_t>(std::thread::hardware_concurrency() / 2, 1, MAX_SHARDS);
+
+    runBenchmark(1, shards);
+    if(shards > 1) {
+        runBenchmark(shards, shards);
+    }
+
+    std::cout << fmt::format("Peak memory usage {:L}\n", getPeakRSS());
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+#include <ichor/optional_bundles/network_bundle/NetworkEvents.h>
+#include <ichor/optional_bundles/network_bundle/IConnectionService.h>
+#include <unordered_map>
+
+using namespace Ichor;
+
+// Sends everything received on a connection back over the same connection
+class TestService final : public Service<TestService> {
+public:
+    TestService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        reg.registerDependency<IConnectionService>(this, false);
+    }
+    ~TestService() final = default;
+
+    StartBehaviour start() final {
+        _dataEventRegistration = getManager()->registerEventHandler<NetworkDataEvent>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _dataEventRegistration.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    void addDependencyInstance(IConnectionService *connectionService, IService *isvc) {
+        _connections.emplace(isvc->getServiceId(), connectionService);
+    }
+
+    void removeDependencyInstance(IConnectionService *, IService *isvc) {
+        _connections.erase(isvc->getServiceId());
+    }
+
+    bool handleEvent(NetworkDataEvent const * const evt) {
+        auto connection = _connections.find(evt->originatingService);
+        if(connection != end(_connections)) {
+            auto data = evt->getData();
+            connection->second->sendAsync(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>{data.begin(), data.end(), getMemoryResource()});
+        }
+
+        return PreventOthersHandling;
+    }
+
+private:
+    std::unordered_map<uint64_t, IConnectionService*> _connections{};
+    EventHandlerRegistration _dataEventRegistration{};
+};
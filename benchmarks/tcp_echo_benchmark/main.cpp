@@ -0,0 +1,142 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <ichor/optional_bundles/logging_bundle/LoggerAdmin.h>
+#include <ichor/optional_bundles/logging_bundle/NullLogger.h>
+#include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
+#include <ichor/optional_bundles/network_bundle/tcp/TcpHostService.h>
+#include <ichor/optional_bundles/network_bundle/epoll/EpollReactorService.h>
+#ifdef ICHOR_USE_IO_URING
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringQueueService.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringHostService.h>
+#endif
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+// Echoes data through a host service running on its own manager, using plain blocking sockets as client
+constexpr uint64_t ROUND_TRIPS = 10'000;
+constexpr uint64_t ROUND_TRIP_SIZE = 64;
+constexpr uint64_t WINDOW_SIZE = 64 * 1024;
+constexpr uint64_t WINDOWS = 4'000;
+constexpr uint64_t CONNECTIONS = 2'000;
+
+int connectToServer(uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    // the server starts asynchronously
+    while(true) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if(::connect(fd, (sockaddr *)&address, sizeof(address)) == 0) {
+            int setting = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+            return fd;
+        }
+        ::close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void sendAll(int fd, std::vector<uint8_t> const &buf) {
+    uint64_t sent = 0;
+    while(sent < buf.size()) {
+        auto ret = ::send(fd, buf.data() + sent, buf.size() - sent, 0);
+        if(ret <= 0) {
+            throw std::runtime_error("send failed");
+        }
+        sent += static_cast<uint64_t>(ret);
+    }
+}
+
+void receiveAll(int fd, std::vector<uint8_t> &buf) {
+    uint64_t received = 0;
+    while(received < buf.size()) {
+        auto ret = ::recv(fd, buf.data() + received, buf.size() - received, 0);
+        if(ret <= 0) {
+            throw std::runtime_error("recv failed");
+        }
+        received += static_cast<uint64_t>(ret);
+    }
+}
+
+template <typename HostT, typename QueueT, typename QueueInterfaceT>
+void runBenchmark(std::string_view name, uint16_t port) {
+    DependencyManager dm{};
+    std::thread t([&dm, port]() {
+        auto logMgr = dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+        logMgr->setLogLevel(LogLevel::WARN);
+        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        dm.createServiceManager<QueueT, QueueInterfaceT>();
+        dm.createServiceManager<HostT, IHostService>(Properties{{"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})}, {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)}});
+        dm.createServiceManager<TestService>();
+        dm.start();
+    });
+
+    int fd = connectToServer(port);
+
+    std::vector<uint8_t> request(ROUND_TRIP_SIZE, 1);
+    std::vector<uint8_t> response(ROUND_TRIP_SIZE);
+    std::vector<uint64_t> latencies;
+    latencies.reserve(ROUND_TRIPS);
+    for(uint64_t i = 0; i < ROUND_TRIPS; i++) {
+        auto start = std::chrono::steady_clock::now();
+        sendAll(fd, request);
+        receiveAll(fd, response);
+        latencies.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[static_cast<uint64_t>(p * static_cast<double>(latencies.size() - 1))] / 1'000;
+    };
+    std::cout << fmt::format("{} {:L} round trips of {:L} bytes: p50 {:L} us, p99 {:L} us, p99.9 {:L} us, max {:L} us\n",
+                             name, ROUND_TRIPS, ROUND_TRIP_SIZE, percentile(0.5), percentile(0.99), percentile(0.999), latencies.back() / 1'000);
+
+    request.assign(WINDOW_SIZE, 2);
+    response.resize(WINDOW_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < WINDOWS; i++) {
+        sendAll(fd, request);
+        receiveAll(fd, response);
+    }
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << fmt::format("{} {:L} windows of {:L} bytes echoed in {:L} ms, {:L} MB/s\n",
+                             name, WINDOWS, WINDOW_SIZE, elapsedUs / 1'000, WINDOWS * WINDOW_SIZE / static_cast<uint64_t>(std::max<int64_t>(elapsedUs, 1)));
+    ::close(fd);
+
+    // connection churn: every connection does a single round trip
+    request.assign(ROUND_TRIP_SIZE, 3);
+    response.resize(ROUND_TRIP_SIZE);
+    start = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < CONNECTIONS; i++) {
+        fd = connectToServer(port);
+        sendAll(fd, request);
+        receiveAll(fd, response);
+        ::close(fd);
+    }
+    elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << fmt::format("{} {:L} connections in {:L} ms, {:L} connections/s\n",
+                             name, CONNECTIONS, elapsedUs / 1'000, CONNECTIONS * 1'000'000 / static_cast<uint64_t>(std::max<int64_t>(elapsedUs, 1)));
+
+    dm.pushEvent<QuitEvent>(0);
+    t.join();
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    runBenchmark<TcpHostService, EpollReactorService, IReactor>("epoll", 8013);
+#ifdef ICHOR_USE_IO_URING
+    runBenchmark<IOUringHostService, IOUringQueueService, IIOUringQueue>("io_uring", 8014);
+#endif
+
+    std::cout << fmt::format("Peak memory usage {:L}\n", getPeakRSS());
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+using namespace Ichor;
+
+std::vector<uint64_t> lateness{};
+
+// Runs a periodic timer until it fired Samples times, recording how late every expiry was
+class TestService final : public Service<TestService> {
+public:
+    TestService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        _interval = std::chrono::nanoseconds(Ichor::any_cast<uint64_t>(getProperties()["Interval"]));
+        _samples = Ichor::any_cast<uint64_t>(getProperties()["Samples"]);
+    }
+    ~TestService() final = default;
+
+    StartBehaviour start() final {
+        _first = std::chrono::steady_clock::now() + _interval;
+        _timerHandle = getManager()->addTimer(_first, _interval, Ichor::function<void()>{[this]() { onExpiry(); }, getMemoryResource()});
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        getManager()->cancelTimer(_timerHandle);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+private:
+    void onExpiry() {
+        // expiries are absolute, so a missed expiry shows up as lateness of the next one
+        auto sinceFirst = std::chrono::steady_clock::now() - _first;
+        auto expected = sinceFirst / _interval * _interval;
+        lateness.push_back(static_cast<uint64_t>((sinceFirst - expected).count()));
+
+        if(lateness.size() == _samples) {
+            getManager()->cancelTimer(_timerHandle);
+            getManager()->pushEvent<QuitEvent>(getServiceId());
+        }
+    }
+
+    std::chrono::nanoseconds _interval{};
+    uint64_t _samples{};
+    std::chrono::steady_clock::time_point _first{};
+    TimerHandle _timerHandle{};
+};
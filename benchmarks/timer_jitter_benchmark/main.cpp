@@ -0,0 +1,46 @@
+#include "TestService.h"
+#include <ichor/optional_bundles/logging_bundle/CoutFrameworkLogger.h>
+#include <ichor/optional_bundles/metrics_bundle/MemoryUsageFunctions.h>
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+
+// Runs a periodic timer on an otherwise idle manager and reports how late it fires compared to its expected expiries
+constexpr auto RUN_DURATION = std::chrono::seconds(2);
+
+void runBenchmark(std::chrono::nanoseconds interval, std::chrono::nanoseconds resolution) {
+    lateness.clear();
+    auto samples = static_cast<uint64_t>(RUN_DURATION / interval);
+    lateness.reserve(samples);
+
+    DependencyManager dm{};
+    dm.setTimerResolution(resolution);
+    auto logMgr = dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>({}, 10);
+    logMgr->setLogLevel(LogLevel::WARN);
+    dm.createServiceManager<TestService>(Properties{{"Interval", Ichor::make_any<uint64_t>(dm.getMemoryResource(), static_cast<uint64_t>(interval.count()))},
+                                                    {"Samples", Ichor::make_any<uint64_t>(dm.getMemoryResource(), samples)}});
+
+    auto cpuStart = std::clock();
+    dm.start();
+    auto cpuMs = (std::clock() - cpuStart) * 1'000 / CLOCKS_PER_SEC;
+
+    std::sort(lateness.begin(), lateness.end());
+    auto percentile = [](double p) {
+        return lateness[static_cast<uint64_t>(p * static_cast<double>(lateness.size() - 1))] / 1'000;
+    };
+    std::cout << fmt::format("interval {:L} us, resolution {:L} us: p50 {:L} us, p99 {:L} us, p99.9 {:L} us, max {:L} us late over {:L} expiries, {:L} timer wakeups, {:L} ms cpu time\n",
+                             interval.count() / 1'000, resolution.count() / 1'000, percentile(0.5), percentile(0.99), percentile(0.999), lateness.back() / 1'000, lateness.size(), dm.getEventLoopStatistics().timerWakeups, cpuMs);
+}
+
+int main() {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    for(std::chrono::nanoseconds interval : {std::chrono::nanoseconds(100'000), std::chrono::nanoseconds(1'000'000), std::chrono::nanoseconds(10'000'000)}) {
+        runBenchmark(interval, TimerWheel::DEFAULT_RESOLUTION);
+        runBenchmark(interval, std::chrono::microseconds(10));
+    }
+
+    std::cout << fmt::format("Peak memory usage {:L}\n", getPeakRSS());
+
+    return 0;
+}
@@ -64,7 +64,8 @@ public:
     }
 
     Generator<bool> handleEvent(NetworkDataEvent const * const evt) {
-        auto msg = _serializationAdmin->deserialize<TestMsg>(evt->getData());
+        auto data = evt->getData();
+        auto msg = _serializationAdmin->deserialize<TestMsg>(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>{data.begin(), data.end(), getMemoryResource()});
         ICHOR_LOG_INFO(_logger, "Received TestMsg id {} val {}", msg->id, msg->val);
         getManager()->pushEvent<QuitEvent>(getServiceId());
 
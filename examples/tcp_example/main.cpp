@@ -2,6 +2,7 @@
 #include "../common/TestMsgJsonSerializer.h"
 #include <ichor/optional_bundles/logging_bundle/LoggerAdmin.h>
 #include <ichor/optional_bundles/network_bundle/tcp/TcpHostService.h>
+#include <ichor/optional_bundles/network_bundle/epoll/EpollReactorService.h>
 #include <ichor/optional_bundles/network_bundle/ClientAdmin.h>
 #include <ichor/optional_bundles/serialization_bundle/SerializationAdmin.h>
 #ifdef ICHOR_USE_SPDLOG
@@ -34,6 +35,7 @@ int main() {
     dm.createServiceManager<LoggerAdmin<LOGGER_TYPE>, ILoggerAdmin>();
     dm.createServiceManager<SerializationAdmin, ISerializationAdmin>();
     dm.createServiceManager<TestMsgJsonSerializer, ISerializer>();
+    dm.createServiceManager<EpollReactorService, IReactor>();
     dm.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), "127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), 8001)}});
     dm.createServiceManager<ClientAdmin<TcpConnectionService>, IClientAdmin>();
     dm.createServiceManager<UsingTcpService>(Properties{{"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), "127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), 8001)}});
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <ichor/Generator.h>
+#include <ichor/Task.h>
+#include <ichor/ServiceHandle.h>
 #include <ichor/stl/Function.h>
 #include <optional>
 
@@ -11,8 +13,23 @@ namespace Ichor {
     class [[nodiscard]] EventCallbackInfo final {
     public:
         uint64_t listeningServiceId;
+        ServiceHandle listeningService; // invalid if the service was not yet known when registering
         std::optional<uint64_t> filterServiceId;
+        // only one of these is set, depending on whether the handler returns a Generator, a bool or a Task
         Ichor::function<Generator<bool>(Event const * const)> callback;
+        Ichor::function<bool(Event const * const)> synchronousCallback;
+        Ichor::function<Task<bool>(Event const * const)> asyncCallback;
+    };
+
+    /// A suspended Task waiting for an event to be processed, see DependencyManager::waitForEvent()
+    class [[nodiscard]] EventAwaiterInfo final {
+    public:
+        cppcoro::coroutine_handle<> coroutine; // resumed once a matching event has been processed
+        cppcoro::coroutine_handle<> root; // outermost task of the awaiting coroutine, destroyed if the manager or the owning service stops before resuming
+        uint64_t owningServiceId; // service whose event handler started the awaiting task, set by the manager
+        std::optional<uint64_t> filterServiceId;
+        Ichor::function<bool(Event const * const)> filter; // optional
+        Event const **event; // set to the matching event right before resuming
     };
 
     class [[nodiscard]] EventInterceptInfo final {
@@ -25,7 +42,7 @@ namespace Ichor {
 
     struct CallbackKey {
         uint64_t id;
-        uint64_t type;
+        uint64_t type; // dense event type index, see EventTypeIndex.h
 
         bool operator==(const CallbackKey &other) const {
             return id == other.id && type == other.type;
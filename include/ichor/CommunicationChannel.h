@@ -33,13 +33,28 @@ namespace Ichor {
 #ifdef DEBUG_CHANNEL
                 std::cout << "Inserting event " << typeName<EventT>() << " from manager " << originatingManager->getId() << " into manager " << manager->getId() << std::endl;
 #endif
-                manager->template pushEvent<EventT>(std::forward<Args>(args)...);
+                // every manager constructs its own event, so args cannot be forwarded
+                manager->template pushEvent<EventT>(args...);
 #ifdef DEBUG_CHANNEL
                 std::cout << "Inserted event " << typeName<EventT>() << " from manager " << originatingManager->getId() << " into manager " << manager->getId() << std::endl;
 #endif
             }
         }
 
+        /// Push count events into every manager except the originating one, using a single batch per manager. See DependencyManager::pushEvents()
+        template <typename EventT, typename F>
+        requires Derived<EventT, Event>
+        void broadcastEvents(DependencyManager *originatingManager, uint64_t originatingServiceId, uint64_t count, F&& argsFor) {
+            std::shared_lock l(_mutex);
+            for(auto &[key, manager] : _managers) {
+                if(manager->getId() == originatingManager->getId()) {
+                    continue;
+                }
+
+                manager->template pushEvents<EventT>(originatingServiceId, count, argsFor);
+            }
+        }
+
         template <typename EventT, typename... Args>
         requires Derived<EventT, Event>
         void sendEventTo(uint64_t id, Args&&... args) {
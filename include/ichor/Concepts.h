@@ -57,6 +57,18 @@ namespace Ichor {
         { impl.handleEvent(evt) } -> std::same_as<Generator<bool>>;
     };
 
+    /// Handlers that never yield can return bool directly, which avoids creating a coroutine frame for every event
+    template <class ImplT, class EventT>
+    concept ImplementsSynchronousEventHandlers = requires(ImplT impl, EventT const * const evt) {
+        { impl.handleEvent(evt) } -> std::same_as<bool>;
+    };
+
+    /// Handlers returning a Task can co_await events, see DependencyManager::waitForEvent(). The event passed to the handler is only valid until the first suspension.
+    template <class ImplT, class EventT>
+    concept ImplementsAsyncEventHandlers = requires(ImplT impl, EventT const * const evt) {
+        { impl.handleEvent(evt) } -> std::same_as<Task<bool>>;
+    };
+
 // TODO gcc 10.2 does not support the std::allocator_arg_t usage in coroutines/coroutine promises.
 //  Decide whether to keep current setup with thread_local memory_resource or implement std::allocator_arg_t in gcc
 //    template <class ImplT, class EventT>
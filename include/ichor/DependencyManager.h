@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <map>
@@ -10,17 +11,27 @@
 #include <atomic>
 #include <csignal>
 #include <condition_variable>
+#include <stdexcept>
+#include <tuple>
 #include <ichor/interfaces/IFrameworkLogger.h>
 #include <ichor/Service.h>
 #include <ichor/LifecycleManager.h>
 #include <ichor/Events.h>
+#include <ichor/EventTypeIndex.h>
 #include <ichor/Callbacks.h>
 #include <ichor/Filter.h>
+#include <ichor/ServiceRegistry.h>
 #include <ichor/DependencyRegistrations.h>
 #include <ichor/stl/RealtimeMutex.h>
 #include <ichor/stl/RealtimeReadWriteMutex.h>
 #include <ichor/stl/ConditionVariable.h>
 #include <ichor/stl/ConditionVariableAny.h>
+#include <ichor/event_queues/IEventQueue.h>
+#include <ichor/event_queues/EventLoopNotifier.h>
+#include <ichor/event_queues/PriorityBuckets.h>
+#include <ichor/event_queues/TimerWheel.h>
+#include <ichor/stl/EventSlabAllocator.h>
+#include <ichor/stl/CoroutineFrameCache.h>
 
 // prevent false positives by TSAN
 // See "ThreadSanitizer – data race detection in practice" by Serebryany et al. for more info: https://static.googleusercontent.com/media/research.google.com/en//pubs/archive/35604.pdf
@@ -56,16 +67,20 @@ namespace Ichor {
 
     class DependencyManager final {
     public:
-        DependencyManager() : _memResource(std::pmr::get_default_resource()), _eventMemResource(std::pmr::get_default_resource()) {
+        DependencyManager() : _memResource(std::pmr::get_default_resource()), _eventMemResource(std::pmr::get_default_resource()), _eventQueueType(EventQueueType::PRIORITY_BUCKETS), _eventQueue(createEventQueue(_eventQueueType, _eventMemResource)) {
         }
 
-        DependencyManager(std::pmr::memory_resource *mainMemoryResource, std::pmr::memory_resource *eventMemoryResource) : _memResource(mainMemoryResource), _eventMemResource(eventMemoryResource) {
+        DependencyManager(std::pmr::memory_resource *mainMemoryResource, std::pmr::memory_resource *eventMemoryResource) : _memResource(mainMemoryResource), _eventMemResource(eventMemoryResource), _eventQueueType(EventQueueType::PRIORITY_BUCKETS), _eventQueue(createEventQueue(_eventQueueType, _eventMemResource)) {
+        }
+
+        /// \param queueType which event queue implementation to use. LOCK_FREE_MPSC is beneficial when many threads push events into this manager, LOCKED_MULTIMAP when more than 64 different priorities are used at the same time, as PRIORITY_BUCKETS falls back to a slower sorted map for those.
+        DependencyManager(std::pmr::memory_resource *mainMemoryResource, std::pmr::memory_resource *eventMemoryResource, EventQueueType queueType) : _memResource(mainMemoryResource), _eventMemResource(eventMemoryResource), _eventQueueType(queueType), _eventQueue(createEventQueue(_eventQueueType, _eventMemResource)) {
         }
 
         // DANGEROUS COPY, EFFECTIVELY MAKES A NEW MANAGER AND STARTS OVER!!
         // Only implemented so that the manager can be easily used in STL containers before anything is using it.
         [[deprecated("DANGEROUS COPY, EFFECTIVELY MAKES A NEW MANAGER AND STARTS OVER!! The moved-from manager cannot be registered with a CommunicationChannel, or UB occurs.")]]
-        DependencyManager(const DependencyManager& other) : _memResource(other._memResource), _eventMemResource(other._eventMemResource) {
+        DependencyManager(const DependencyManager& other) : _memResource(other._memResource), _eventMemResource(other._eventMemResource), _eventQueueType(other._eventQueueType), _eventQueue(createEventQueue(_eventQueueType, _eventMemResource)), _eventBatchSize(other._eventBatchSize), _earliestDeadlineFirst(other._earliestDeadlineFirst), _idleStrategy(other._idleStrategy), _spinIterations(other._spinIterations) {
             if(other._started) {
                 std::terminate();
             }
@@ -95,7 +110,15 @@ namespace Ichor {
 
                 logAddService<Impl, Interfaces...>(cmpMgr->serviceId());
 
-                for (auto &[key, mgr] : _services) {
+                std::pmr::vector<ILifecycleManager*> providers{_memResource};
+                for (auto const &[key, registration] : cmpMgr->getDependencyRegistry()->_registrations) {
+                    appendIndexedServices(_servicesProvidingInterface, key, providers);
+                }
+                if (cmpMgr->getDependencyRegistry()->_registrations.size() > 1) {
+                    removeDuplicates(providers);
+                }
+
+                for (auto *mgr : providers) {
                     if (mgr->getServiceState() == ServiceState::ACTIVE) {
                         auto const filterProp = mgr->getProperties().find("Filter");
                         const Filter *filter = nullptr;
@@ -107,7 +130,7 @@ namespace Ichor {
                             continue;
                         }
 
-                        cmpMgr->dependencyOnline(mgr.get());
+                        cmpMgr->dependencyOnline(mgr);
                     }
                 }
 
@@ -126,7 +149,8 @@ namespace Ichor {
 
                 cmpMgr->getService().injectPriority(priority);
 
-                _services.emplace(cmpMgr->serviceId(), cmpMgr);
+                _services.insert(cmpMgr);
+                addToServiceIndices(cmpMgr.get());
 
                 return &cmpMgr->getService();
             } else {
@@ -152,7 +176,8 @@ namespace Ichor {
                     pushEventInternal<DependencyOnlineEvent>(cmpMgr->serviceId(), priority);
                 }
 
-                _services.emplace(cmpMgr->serviceId(), cmpMgr);
+                _services.insert(cmpMgr);
+                addToServiceIndices(cmpMgr.get());
 
                 return &cmpMgr->getService();
             }
@@ -172,15 +197,26 @@ namespace Ichor {
                 return 0;
             }
 
-            uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
-            _eventQueueMutex.lock();
-            _emptyQueue.store(false, std::memory_order_release);
-            [[maybe_unused]] auto it = _eventQueue.emplace(priority, Ichor::unique_ptr<Event>{new (_memResource->allocate(sizeof(EventT))) EventT(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...), Deleter{InternalDeleter<EventT>{_memResource}}});
-            TSAN_ANNOTATE_HAPPENS_BEFORE((void*)&(*it));
-            _eventQueueMutex.unlock();
-            _wakeUp.notify_all();
-            ICHOR_LOG_TRACE(_logger, "inserted event of type {} into manager {}", typeName<EventT>(), getId());
-            return eventId;
+            return pushEventInternal<EventT>(originatingServiceId, priority, std::forward<Args>(args)...);
+        }
+
+        /// Push event into event loop with specified priority and a deadline. If the event is still in the queue once the deadline has passed, it is dropped without calling any handlers or interceptors.
+        /// Dropped events are counted per type, see getMissedDeadlineCount(), and are reported with a DeadlineMissedEvent if there are handlers for it.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \tparam Args auto-deducible arguments for EventT constructor
+        /// \param originatingServiceId service that is pushing the event
+        /// \param deadline latest time at which dispatching the event is still useful
+        /// \param args arguments for EventT constructor
+        /// \return event id (can be used in completion/error handlers)
+        template <typename EventT, typename... Args>
+        requires Derived<EventT, Event>
+        uint64_t pushPrioritisedEventWithDeadline(uint64_t originatingServiceId, uint64_t priority, std::chrono::steady_clock::time_point deadline, Args&&... args){
+            if(_quit.load(std::memory_order_acquire)) {
+                ICHOR_LOG_TRACE(_logger, "inserting event of type {} into manager {}, but have to quit", typeName<EventT>(), getId());
+                return 0;
+            }
+
+            return pushEventInternalWithDeadline<EventT>(originatingServiceId, priority, deadline, std::forward<Args>(args)...);
         }
 
         /// Push event into event loop with the default priority
@@ -192,20 +228,55 @@ namespace Ichor {
         template <typename EventT, typename... Args>
         requires Derived<EventT, Event>
         uint64_t pushEvent(uint64_t originatingServiceId, Args&&... args){
+            return pushPrioritisedEvent<EventT>(originatingServiceId, INTERNAL_EVENT_PRIORITY, std::forward<Args>(args)...);
+        }
+
+        /// Push multiple events of the same type into the event loop with specified priority at once.
+        /// Compared to calling pushPrioritisedEvent() count times, the event ids are reserved with a single atomic operation, the events are inserted into the event queue in one go and the event loop is woken up at most once.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \tparam F auto-deducible callable, taking the index of the event in the batch and returning a std::tuple of the arguments for the EventT constructor
+        /// \param originatingServiceId service that is pushing the events
+        /// \param count amount of events to push
+        /// \param argsFor returns the arguments to construct the event at the given index with
+        /// \return event id of the first event, the other events have consecutive ids. 0 if nothing was pushed.
+        template <typename EventT, typename F>
+        requires Derived<EventT, Event>
+        uint64_t pushPrioritisedEvents(uint64_t originatingServiceId, uint64_t priority, uint64_t count, F&& argsFor) {
             if(_quit.load(std::memory_order_acquire)) {
-                ICHOR_LOG_TRACE(_logger, "inserting event of type {} into manager {}, but have to quit", typeName<EventT>(), getId());
+                ICHOR_LOG_TRACE(_logger, "inserting events of type {} into manager {}, but have to quit", typeName<EventT>(), getId());
                 return 0;
             }
 
-            uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
-            _eventQueueMutex.lock();
+            if(count == 0) {
+                return 0;
+            }
+
+            uint64_t firstEventId = _eventIdCounter.fetch_add(count, std::memory_order_acq_rel);
+            auto typeIndex = eventTypeIndex<EventT>();
+
+            // may be called from any thread, so this cannot use _memResource
+            std::vector<EventStackUniquePtr> events{};
+            events.reserve(count);
+            for(uint64_t i = 0; i < count; i++) {
+                std::apply([&](auto&&... args) {
+                    auto &evt = events.emplace_back(EventStackUniquePtr::create<EventT>(&_eventAllocator, firstEventId + i, originatingServiceId, priority, std::forward<decltype(args)>(args)...));
+                    evt->typeIndex = typeIndex;
+                }, argsFor(i));
+            }
+
             _emptyQueue.store(false, std::memory_order_release);
-            [[maybe_unused]] auto it = _eventQueue.emplace(INTERNAL_EVENT_PRIORITY, Ichor::unique_ptr<Event>{new (_memResource->allocate(sizeof(EventT))) EventT(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), INTERNAL_EVENT_PRIORITY, std::forward<Args>(args)...), Deleter{InternalDeleter<EventT>{_memResource}}});
-            TSAN_ANNOTATE_HAPPENS_BEFORE((void*)&(*it));
-            _eventQueueMutex.unlock();
-            _wakeUp.notify_all();
-            ICHOR_LOG_TRACE(_logger, "inserted event of type {} into manager {}", typeName<EventT>(), getId());
-            return eventId;
+            _eventQueue->pushEvents(priority, events);
+            _notifier.notify();
+            ICHOR_LOG_TRACE(_logger, "inserted {} events of type {} into manager {}", count, typeName<EventT>(), getId());
+            return firstEventId;
+        }
+
+        /// Push multiple events of the same type into the event loop with the default priority at once, see pushPrioritisedEvents()
+        /// \return event id of the first event, the other events have consecutive ids. 0 if nothing was pushed.
+        template <typename EventT, typename F>
+        requires Derived<EventT, Event>
+        uint64_t pushEvents(uint64_t originatingServiceId, uint64_t count, F&& argsFor) {
+            return pushPrioritisedEvents<EventT>(originatingServiceId, INTERNAL_EVENT_PRIORITY, count, std::forward<F>(argsFor));
         }
 
         template <typename Interface, typename Impl>
@@ -225,7 +296,7 @@ namespace Ichor {
             DependencyTrackerInfo undoRequestInfo{Ichor::function<void(Event const * const)>{[impl](Event const * const evt){ impl->handleDependencyUndoRequest(static_cast<Interface*>(nullptr), static_cast<DependencyUndoRequestEvent const *>(evt)); }, _memResource}};
 
             std::pmr::vector<DependencyRequestEvent> requests{getMemoryResource()};
-            for(auto const &[key, mgr] : _services) {
+            for(auto const &mgr : _services.managers()) {
                 auto const *depRegistry = mgr->getDependencyRegistry();
 //                ICHOR_LOG_ERROR(_logger, "register svcId {} dm {}", mgr->serviceId(), _id);
 
@@ -274,16 +345,17 @@ namespace Ichor {
         /// \param impl class that is registering handler
         /// \return RAII handler, removes registration upon destruction
         EventCompletionHandlerRegistration registerEventCompletionCallbacks(Impl *impl) {
-            CallbackKey key{impl->getServiceId(), EventT::TYPE};
-            _completionCallbacks.emplace(key, Ichor::function<void(Event const * const)>{[impl](Event const * const evt){ impl->handleCompletion(static_cast<EventT const * const>(evt)); }, _memResource});
-            _errorCallbacks.emplace(key, Ichor::function<void(Event const * const)>{[impl](Event const * const evt){ impl->handleError(static_cast<EventT const * const>(evt)); }, _memResource});
+            CallbackKey key{impl->getServiceId(), eventTypeIndex<EventT>()};
+            atTypeIndex(_completionCallbacks, key.type).emplace(key.id, Ichor::function<void(Event const * const)>{[impl](Event const * const evt){ impl->handleCompletion(static_cast<EventT const * const>(evt)); }, _memResource});
+            atTypeIndex(_errorCallbacks, key.type).emplace(key.id, Ichor::function<void(Event const * const)>{[impl](Event const * const evt){ impl->handleError(static_cast<EventT const * const>(evt)); }, _memResource});
             return EventCompletionHandlerRegistration(this, key, impl->getServicePriority());
         }
 
         template <typename EventT, typename Impl>
-        requires Derived<EventT, Event> && ImplementsEventHandlers<Impl, EventT>
+        requires Derived<EventT, Event> && (ImplementsEventHandlers<Impl, EventT> || ImplementsSynchronousEventHandlers<Impl, EventT> || ImplementsAsyncEventHandlers<Impl, EventT>)
         [[nodiscard]]
-        /// Register an event handler
+        /// Register an event handler. Handlers returning bool instead of a Generator are called without creating a coroutine.
+        /// Handlers returning a Task<bool> can co_await events. If such a handler suspends, other handlers are allowed to handle the event.
         /// \tparam EventT type of event (has to derive from Event)
         /// \tparam Impl type of class registering handler (auto-deducible)
         /// \param serviceId id of service registering handler
@@ -291,25 +363,73 @@ namespace Ichor {
         /// \param targetServiceId optional service id to filter registering for, if empty, receive all events of type EventT
         /// \return RAII handler, removes registration upon destruction
         EventHandlerRegistration registerEventHandler(Impl *impl, std::optional<uint64_t> targetServiceId = {}) {
-            auto existingHandlers = _eventCallbacks.find(EventT::TYPE);
-            if(existingHandlers == end(_eventCallbacks)) {
-                std::pmr::vector<EventCallbackInfo> v{ _memResource };
-                v.template emplace_back(EventCallbackInfo{
-                        impl->getServiceId(),
-                        targetServiceId,
-                        Ichor::function<Generator<bool>(Event const * const)>{
-                                [impl](Event const *const evt) {
-                                    return impl->handleEvent(static_cast<EventT const *const>(evt));
-                                },
-                                _memResource
-                        }
-                });
-                _eventCallbacks.emplace(EventT::TYPE, std::move(v));
+            auto typeIndex = eventTypeIndex<EventT>();
+            auto &info = atTypeIndex(_eventCallbacks, typeIndex).emplace_back(impl->getServiceId(), _services.getHandle(impl->getServiceId()), targetServiceId);
+            if constexpr (ImplementsSynchronousEventHandlers<Impl, EventT>) {
+                info.synchronousCallback = Ichor::function<bool(Event const *const)>{
+                        [impl](Event const *const evt) { return impl->handleEvent(static_cast<EventT const *const>(evt)); }, _memResource};
+            } else if constexpr (ImplementsAsyncEventHandlers<Impl, EventT>) {
+                info.asyncCallback = Ichor::function<Task<bool>(Event const *const)>{
+                        [impl](Event const *const evt) { return impl->handleEvent(static_cast<EventT const *const>(evt)); }, _memResource};
             } else {
-                existingHandlers->second.emplace_back(impl->getServiceId(), targetServiceId, Ichor::function<Generator<bool>(Event const *const)>{
-                        [impl](Event const *const evt) { return impl->handleEvent(static_cast<EventT const *const>(evt)); }, _memResource});
+                info.callback = Ichor::function<Generator<bool>(Event const *const)>{
+                        [impl](Event const *const evt) { return impl->handleEvent(static_cast<EventT const *const>(evt)); }, _memResource};
             }
-            return EventHandlerRegistration(this, CallbackKey{impl->getServiceId(), EventT::TYPE}, impl->getServicePriority());
+            return EventHandlerRegistration(this, CallbackKey{impl->getServiceId(), typeIndex}, impl->getServicePriority());
+        }
+
+        /// Awaitable returned by waitForEvent() and waitForEventProcessed(), resumes the awaiting Task with a pointer to the event.
+        /// The event is only valid until the Task suspends again.
+        template <typename EventT>
+        class [[nodiscard]] EventAwaitable final {
+        public:
+            EventAwaitable(DependencyManager *dm, uint32_t typeIndex, std::optional<uint64_t> eventId, std::optional<uint64_t> filterServiceId, Ichor::function<bool(Event const * const)> filter) noexcept :
+                _dm(dm), _typeIndex(typeIndex), _eventId(eventId), _filterServiceId(filterServiceId), _filter(std::move(filter)) {}
+
+            constexpr bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            requires std::is_base_of_v<Detail::TaskPromiseBase, Promise>
+            void await_suspend(cppcoro::coroutine_handle<Promise> awaiting) {
+                _dm->addEventAwaiter(_typeIndex, _eventId, EventAwaiterInfo{awaiting, awaiting.promise().root(), 0, _filterServiceId, std::move(_filter), &_event});
+            }
+
+            EventT const * await_resume() const noexcept {
+                return static_cast<EventT const *>(_event);
+            }
+
+        private:
+            DependencyManager *_dm;
+            uint32_t _typeIndex;
+            std::optional<uint64_t> _eventId;
+            std::optional<uint64_t> _filterServiceId;
+            Ichor::function<bool(Event const * const)> _filter;
+            Event const *_event{};
+        };
+
+        /// Suspends the awaiting Task until the next event of type EventT has been processed by this manager. Can only be awaited by Tasks run by this manager, e.g. event handlers returning Task<bool>.
+        /// Use the originating service id of a Timer to wait for its next tick.
+        /// \tparam EventT type of event (has to derive from Event). If EventT equals Event, any event resumes the Task.
+        /// \param originatingServiceId optional service id the event has to originate from
+        template <typename EventT>
+        requires Derived<EventT, Event>
+        EventAwaitable<EventT> waitForEvent(std::optional<uint64_t> originatingServiceId = {}) {
+            return EventAwaitable<EventT>{this, eventTypeIndex<EventT>(), {}, originatingServiceId, {}};
+        }
+
+        /// Suspends the awaiting Task until an event of type EventT for which filter returns true has been processed by this manager, e.g. the reply to a request sent to another manager.
+        /// \param filter called on the thread of this manager for every event of type EventT until it returns true, should not modify the manager
+        template <typename EventT, typename F>
+        requires Derived<EventT, Event> && std::is_invocable_r_v<bool, F, EventT const * const>
+        EventAwaitable<EventT> waitForEvent(F&& filter) {
+            return EventAwaitable<EventT>{this, eventTypeIndex<EventT>(), {}, {}, Ichor::function<bool(Event const * const)>{[filter = std::forward<F>(filter)](Event const * const evt) { return filter(static_cast<EventT const * const>(evt)); }, _memResource}};
+        }
+
+        /// Suspends the awaiting Task until the event with the given id has been processed by this manager.
+        /// The event has to still be in the queue, e.g. because it was pushed by the awaiting Task itself. Events dropped because of their deadline count as processed.
+        /// \param eventId id as returned by pushEvent()
+        EventAwaitable<Event> waitForEventProcessed(uint64_t eventId) {
+            return EventAwaitable<Event>{this, ALL_EVENTS_TYPE_INDEX, eventId, {}, {}};
         }
 
         template <typename EventT, typename Impl>
@@ -326,21 +446,15 @@ namespace Ichor {
             if constexpr (!std::is_same_v<EventT, Event>) {
                 targetEventId = EventT::TYPE;
             }
-            auto existingHandlers = _eventInterceptors.find(targetEventId);
-            if(existingHandlers == end(_eventInterceptors)) {
-                std::pmr::vector<EventInterceptInfo> v{_memResource};
-                v.template emplace_back(EventInterceptInfo{impl->getServiceId(), targetEventId,
-                                   Ichor::function<bool(Event const * const)>{[impl](Event const * const evt){ return impl->preInterceptEvent(static_cast<EventT const * const>(evt)); }, _memResource},
-                                   Ichor::function<void(Event const * const, bool)>{[impl](Event const * const evt, bool processed){ impl->postInterceptEvent(static_cast<EventT const * const>(evt), processed); }, _memResource}});
-                _eventInterceptors.emplace(targetEventId, std::move(v));
-            } else {
-                existingHandlers->second.template emplace_back(impl->getServiceId(), targetEventId,
-                                                      Ichor::function<bool(Event const * const)>{[impl](Event const * const evt){ return impl->preInterceptEvent(static_cast<EventT const * const>(evt)); }, _memResource},
-                                                      Ichor::function<void(Event const * const, bool)>{[impl](Event const * const evt, bool processed){ impl->postInterceptEvent(static_cast<EventT const * const>(evt), processed); }, _memResource});
-            }
+            auto typeIndex = eventTypeIndex<EventT>();
+            auto &interceptors = typeIndex == ALL_EVENTS_TYPE_INDEX ? _globalEventInterceptors : atTypeIndex(_eventInterceptors, typeIndex);
+            interceptors.emplace_back(impl->getServiceId(), targetEventId,
+                                                  Ichor::function<bool(Event const * const)>{[impl](Event const * const evt){ return impl->preInterceptEvent(static_cast<EventT const * const>(evt)); }, _memResource},
+                                                  Ichor::function<void(Event const * const, bool)>{[impl](Event const * const evt, bool processed){ impl->postInterceptEvent(static_cast<EventT const * const>(evt), processed); }, _memResource});
+            _eventInterceptorCount++;
             // I think there's a bug in GCC 10.1, where if I don't make this a unique_ptr, the EventHandlerRegistration destructor immediately gets called for some reason.
             // Even if the result is stored in a variable at the caller site.
-            return EventInterceptorRegistration(this, CallbackKey{impl->getServiceId(), targetEventId}, impl->getServicePriority());
+            return EventInterceptorRegistration(this, CallbackKey{impl->getServiceId(), typeIndex}, impl->getServicePriority());
         }
 
         /// Get manager id
@@ -369,16 +483,23 @@ namespace Ichor {
             return _started;
         };
 
+        /// \return true if called from the thread running the event loop of this manager
+        [[nodiscard]] bool isEventLoopThread() const noexcept {
+            return _eventLoopThreadId.load(std::memory_order_acquire) == std::this_thread::get_id();
+        }
+
         template <typename Interface>
         [[nodiscard]] std::pmr::vector<Interface*> getStartedServices() noexcept {
             std::pmr::vector<Interface*> ret{_memResource};
             ret.reserve(_services.size());
-            for(auto &[key, svc] : _services) {
-                if(svc->getServiceState() != ServiceState::ACTIVE) {
+            auto managers = _services.managers();
+            auto states = _services.states();
+            for(uint64_t i = 0; i < managers.size(); i++) {
+                if(states[i] != ServiceState::ACTIVE) {
                     continue;
                 }
                 Ichor::function<void(void*, IService*)> f{[&ret](void *svc2, IService *isvc){ ret.push_back(reinterpret_cast<Interface*>(svc2)); }, _memResource};
-                svc->insertSelfInto(typeNameHash<Interface>(), f);
+                managers[i]->insertSelfInto(typeNameHash<Interface>(), f);
             }
 
             return ret;
@@ -386,12 +507,150 @@ namespace Ichor {
 
         // This waits on all events done processing, rather than the event queue being empty.
         void waitForEmptyQueue() {
-            std::shared_lock lck(_eventQueueMutex);
+            std::shared_lock lck(_wakeUpMutex);
             _wakeUp.wait_for(lck, 1ms, [this] { return _emptyQueue.load(std::memory_order_acquire) || _quit.load(std::memory_order_acquire); });
         }
 
         [[nodiscard]] std::optional<std::string_view> getImplementationNameFor(uint64_t serviceId) const noexcept;
 
+        /// Statistics per size class of the allocator used for events that do not fit inline in the event queue
+        [[nodiscard]] std::vector<EventSlabStatistics> getEventAllocatorStatistics() const {
+            return _eventAllocator.getStatistics();
+        }
+
+        /// Statistics of the cache used for coroutine frames of event handlers, only safe to call from the thread running the event loop or after it has stopped
+        [[nodiscard]] CoroutineFrameStatistics getCoroutineFrameStatistics() const noexcept {
+            return _frameCache.getStatistics();
+        }
+
+        /// Calls fn on the thread of this manager once expiry has passed, and every interval after that. Only to be called from the thread running the event loop.
+        /// All timers of this manager share one timing wheel, which determines how long the event loop sleeps. Timers fire at most one timer resolution late, see setTimerResolution().
+        /// \param expiry first time fn is called
+        /// \param interval time between calls after the first one, zero to only call fn once
+        /// \param fn function to call
+        /// \return handle to cancel the timer with
+        TimerHandle addTimer(std::chrono::steady_clock::time_point expiry, std::chrono::nanoseconds interval, Ichor::function<void()> fn) {
+            return _timers.add(expiry, interval, std::move(fn));
+        }
+
+        /// Only to be called from the thread running the event loop
+        /// \return false if the timer already fired or was cancelled before
+        bool cancelTimer(TimerHandle handle) noexcept {
+            return _timers.cancel(handle);
+        }
+
+        /// Change the interval of a timer, the next expiry becomes the previous expiry plus the new interval. Only to be called from the thread running the event loop.
+        /// \return false if the timer does not exist anymore
+        bool setTimerInterval(TimerHandle handle, std::chrono::nanoseconds interval) noexcept {
+            return _timers.setInterval(handle, interval);
+        }
+
+        /// Run fn as a RunFunctionEvent with the given priority once delay has passed. Lighter than a Timer service: no service, event handler registration or thread is created.
+        /// Only to be called from the thread running the event loop.
+        /// \param delay time from now after which fn is queued
+        /// \param priority priority of the event that runs fn
+        /// \param fn function to run on the thread of this manager
+        /// \return handle to cancel fn with using cancelScheduled()
+        TimerHandle scheduleAfter(std::chrono::nanoseconds delay, uint64_t priority, std::function<void(DependencyManager*)> fn) {
+            return scheduleAt(std::chrono::steady_clock::now() + delay, priority, std::move(fn));
+        }
+
+        /// Run fn as a RunFunctionEvent with the given priority once expiry has passed. Only to be called from the thread running the event loop.
+        /// \return handle to cancel fn with using cancelScheduled()
+        TimerHandle scheduleAt(std::chrono::steady_clock::time_point expiry, uint64_t priority, std::function<void(DependencyManager*)> fn);
+
+        /// Run fn as a RunFunctionEvent with the given priority every interval, starting interval from now. Meant for periodic housekeeping. Only to be called from the thread running the event loop.
+        /// \return handle to stop the repetition with using cancelScheduled()
+        TimerHandle scheduleEvery(std::chrono::nanoseconds interval, uint64_t priority, std::function<void(DependencyManager*)> fn);
+
+        /// Cancel a function scheduled with scheduleAfter(), scheduleAt() or scheduleEvery(). Runs that have already been queued as an event still happen. Only to be called from the thread running the event loop.
+        /// \return false if the function was already queued (for non-repeating functions) or cancelled before
+        bool cancelScheduled(TimerHandle handle) noexcept {
+            return _timers.cancel(handle);
+        }
+
+#ifdef __linux__
+        /// Call poll on the thread of this manager whenever fd becomes readable, as well as regularly while the manager is busy processing events.
+        /// Meant for reactors that multiplex many file descriptors behind a single one, such as an epoll file descriptor. fd is never read by the manager and poll must not block.
+        /// Only to be called from the thread running the event loop.
+        /// \return id to remove the source with
+        uint64_t addIoSource(int fd, Ichor::function<void()> poll);
+
+        /// Only to be called from the thread running the event loop
+        void removeIoSource(uint64_t id) noexcept;
+#endif
+
+        /// Set the granularity of timers. Timers expiring within the same period of resolution are coalesced into a single wakeup, at the cost of firing up to resolution late.
+        /// Has to be called before start() and before adding timers
+        /// \param resolution at least 1 microsecond, defaults to TimerWheel::DEFAULT_RESOLUTION
+        void setTimerResolution(std::chrono::nanoseconds resolution) {
+            if(_started.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Cannot change the timer resolution of a running manager");
+            }
+
+            _timers.setResolution(resolution);
+        }
+
+        /// Amount of timers fired and how late they fired, only safe to call from the thread running the event loop or after it has stopped
+        [[nodiscard]] TimerStatistics getTimerStatistics() const noexcept {
+            return _timers.getStatistics();
+        }
+
+        /// Amount of times the event loop went to sleep, amount of times it had to be woken up by a pushed event and amount of times it was woken up by a timer
+        [[nodiscard]] EventLoopStatistics getEventLoopStatistics() const noexcept {
+            return _notifier.getStatistics();
+        }
+
+        /// Set what the event loop does when it runs out of events. Spinning trades cpu time for a lower latency when an event is pushed from another thread.
+        /// Has to be called before start()
+        /// \param strategy see IdleStrategy
+        /// \param spinIterations amount of times the event queue is polled before sleeping, only used by SPIN_THEN_PARK
+        void setIdleStrategy(IdleStrategy strategy, uint64_t spinIterations = 10'000) {
+            if(_started.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Cannot change the idle strategy of a running manager");
+            }
+
+            _idleStrategy = strategy;
+            _spinIterations = spinIterations;
+        }
+
+        /// Set the maximum amount of events that are taken out of the event queue at once. Higher priority events that are pushed while processing a batch are still processed first.
+        /// Has to be called before start()
+        /// \param batchSize amount of events, at least 1
+        void setEventBatchSize(uint64_t batchSize) {
+            if(_started.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Cannot change the event batch size of a running manager");
+            }
+            if(batchSize == 0) {
+                throw std::runtime_error("Event batch size has to be at least 1");
+            }
+
+            _eventBatchSize = batchSize;
+        }
+
+        /// Order events of the same priority by deadline instead of insertion order, events without deadline go last. Applies to the events taken out of the queue at once, see setEventBatchSize().
+        /// Has to be called before start()
+        void setEarliestDeadlineFirst(bool enabled) {
+            if(_started.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Cannot change the event ordering of a running manager");
+            }
+
+            _earliestDeadlineFirst = enabled;
+        }
+
+        /// Amount of events of type EventT that were dropped because their deadline passed before they could be dispatched. Only safe to call from the thread running the event loop or after it has stopped.
+        /// If EventT equals Event, returns the amount of dropped events of all types.
+        template <typename EventT>
+        requires Derived<EventT, Event>
+        [[nodiscard]] uint64_t getMissedDeadlineCount() const {
+            if constexpr (std::is_same_v<EventT, Event>) {
+                return _missedDeadlineCount;
+            } else {
+                auto typeIndex = eventTypeIndex<EventT>();
+                return typeIndex < _missedDeadlines.size() ? _missedDeadlines[typeIndex] : 0;
+            }
+        }
+
         void start();
 
     private:
@@ -402,13 +661,17 @@ namespace Ichor {
                 return;
             }
 
-            auto service = _services.find(evt->originatingService);
-            if(service == end(_services) || service->second->getServiceState() != ServiceState::ACTIVE) {
+            if(_services.getState(_services.getHandle(evt->originatingService)) != ServiceState::ACTIVE) {
+                return;
+            }
+
+            auto typeIndex = eventTypeIndex<EventT>();
+            if(typeIndex >= _errorCallbacks.size()) {
                 return;
             }
 
-            auto callback = _errorCallbacks.find(CallbackKey{evt->originatingService, EventT::TYPE});
-            if(callback == end(_errorCallbacks)) {
+            auto callback = _errorCallbacks[typeIndex].find(evt->originatingService);
+            if(callback == end(_errorCallbacks[typeIndex])) {
                 return;
             }
 
@@ -440,7 +703,50 @@ namespace Ichor {
             }
         }
 
+        void processEvent(Event *evt);
+        /// \return amount of handlers the event was given to
+        uint32_t dispatchEvent(Event *evt);
+        void addToServiceIndices(ILifecycleManager *manager);
+        void removeFromServiceIndices(ILifecycleManager *manager);
+        /// Collects the services that requested one of the interfaces manager provides, restricted to the service the filter of manager targets, if any
+        void collectDependentServices(ILifecycleManager *manager, Filter const *filter, std::pmr::vector<ILifecycleManager*> &dependents) const;
+
+        static void appendIndexedServices(std::pmr::unordered_map<uint64_t, std::pmr::vector<ILifecycleManager*>> const &index, uint64_t interfaceNameHash, std::pmr::vector<ILifecycleManager*> &out) {
+            auto it = index.find(interfaceNameHash);
+            if(it != index.end()) {
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            }
+        }
+
+        /// Services can be present under multiple interfaces, but should only be visited once
+        static void removeDuplicates(std::pmr::vector<ILifecycleManager*> &managers) {
+            std::sort(managers.begin(), managers.end());
+            managers.erase(std::unique(managers.begin(), managers.end()), managers.end());
+        }
+        template <typename T>
+        static T& atTypeIndex(std::pmr::vector<T> &perType, uint32_t typeIndex) {
+            if(typeIndex >= perType.size()) {
+                perType.resize(typeIndex + 1);
+            }
+            return perType[typeIndex];
+        }
+
+        void waitForEvents();
+        void pollIoSources();
         void handleEventCompletion(Event const * const evt);
+        void handleMissedDeadline(Event const * const evt);
+
+        /// Resumes suspended event handlers that come before the given event: those with a higher priority, and those with the same priority that yielded before the event was pushed.
+        /// Every handler is resumed at most once per call, so handlers that keep yielding take turns with events of the same priority.
+        void resumeContinuations(uint64_t priority, uint64_t eventId);
+        void addEventAwaiter(uint32_t typeIndex, std::optional<uint64_t> eventId, EventAwaiterInfo &&awaiter);
+        /// \param dispatched false if the event was dropped, which only resumes tasks waiting for it to be processed
+        void resumeEventAwaiters(Event const * const evt, bool dispatched = true);
+        void collectEventAwaiters(std::pmr::vector<EventAwaiterInfo> &awaiters, Event const * const evt);
+        void destroyEventAwaiters() noexcept;
+        // destroys the suspended tasks of a service that stopped, resuming them would use the stopped service
+        void destroyEventAwaiters(uint64_t owningServiceId) noexcept;
+        void pushContinuation(uint64_t priority, Generator<bool> &&generator);
 
         [[nodiscard]] uint32_t broadcastEvent(Event const * const evt);
 
@@ -449,34 +755,77 @@ namespace Ichor {
         template <typename EventT, typename... Args>
         requires Derived<EventT, Event>
         uint64_t pushEventInternal(uint64_t originatingServiceId, uint64_t priority, Args&&... args) {
+            return pushEventInternalWithDeadline<EventT>(originatingServiceId, priority, std::chrono::steady_clock::time_point::max(), std::forward<Args>(args)...);
+        }
+
+        template <typename EventT, typename... Args>
+        requires Derived<EventT, Event>
+        uint64_t pushEventInternalWithDeadline(uint64_t originatingServiceId, uint64_t priority, std::chrono::steady_clock::time_point deadline, Args&&... args) {
             uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
-            _eventQueueMutex.lock();
-            _emptyQueue = false;
-            [[maybe_unused]] auto it = _eventQueue.emplace(priority, Ichor::unique_ptr<Event>{new (_memResource->allocate(sizeof(EventT))) EventT(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...), Deleter{InternalDeleter<EventT>{_memResource}}});
-            TSAN_ANNOTATE_HAPPENS_BEFORE((void*)&(*it));
-            _eventQueueMutex.unlock();
-            _wakeUp.notify_all();
+            _emptyQueue.store(false, std::memory_order_release);
+            auto evt = EventStackUniquePtr::create<EventT>(&_eventAllocator, std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...);
+            evt->typeIndex = eventTypeIndex<EventT>();
+            evt->deadline = deadline;
+            _eventQueue->pushEvent(priority, std::move(evt));
+            _notifier.notify();
             ICHOR_LOG_TRACE(_logger, "inserted event of type {} into manager {}", typeName<EventT>(), getId());
             return eventId;
         }
 
+        [[nodiscard]] static Ichor::unique_ptr<IEventQueue> createEventQueue(EventQueueType type, std::pmr::memory_resource *rsrc);
+
         std::pmr::memory_resource *_memResource;
         std::pmr::memory_resource *_eventMemResource; // cannot be shared with _memResource, as that would introduce threading issues
-        std::pmr::unordered_map<uint64_t, std::shared_ptr<ILifecycleManager>> _services{_memResource}; // key = service id
+        EventSlabAllocator _eventAllocator{}; // used for events that are too big to store inline, pushes can come from any thread
+        CoroutineFrameCache _frameCache{_memResource}; // used for coroutine frames, which are only created and destroyed on the thread running the event loop. Has to outlive _eventQueue.
+        EventQueueType _eventQueueType;
+        Ichor::unique_ptr<IEventQueue> _eventQueue;
+        std::pmr::vector<EventStackUniquePtr> _eventBatch{_memResource}; // only used by the thread running the event loop
+        struct Continuation {
+            uint64_t sequence; // id of the next event at the time the handler yielded, events with a lower id were queued before it
+            Generator<bool> generator;
+        };
+        PriorityBuckets<Continuation> _continuations{_memResource}; // event handlers that yielded, only used by the thread running the event loop
+        TimerWheel _timers{_memResource}; // only used by the thread running the event loop, has to outlive _services
+        struct IoSource {
+            uint64_t id;
+            int fd;
+            Ichor::function<void()> poll;
+        };
+        std::pmr::vector<IoSource> _ioSources{_memResource}; // only used by the thread running the event loop
+        uint64_t _ioSourceIdCounter{};
+        uint64_t _eventBatchSize{64};
+        bool _earliestDeadlineFirst{};
+        std::pmr::vector<uint64_t> _missedDeadlines{_memResource}; // indexed by event type index, only used by the thread running the event loop
+        uint64_t _missedDeadlineCount{};
+        IdleStrategy _idleStrategy{IdleStrategy::BLOCK};
+        uint64_t _spinIterations{};
+        ServiceRegistry _services{_memResource};
+        std::pmr::unordered_map<uint64_t, std::pmr::vector<ILifecycleManager*>> _servicesProvidingInterface{_memResource}; // key = interface name hash, value = services from _services
+        std::pmr::unordered_map<uint64_t, std::pmr::vector<ILifecycleManager*>> _servicesRequestingInterface{_memResource}; // key = interface name hash, value = services from _services
         std::pmr::unordered_map<uint64_t, std::pmr::vector<DependencyTrackerInfo>> _dependencyRequestTrackers{_memResource}; // key = interface name hash
         std::pmr::unordered_map<uint64_t, std::pmr::vector<DependencyTrackerInfo>> _dependencyUndoRequestTrackers{_memResource}; // key = interface name hash
-        std::pmr::unordered_map<CallbackKey, Ichor::function<void(Event const * const)>> _completionCallbacks{_memResource}; // key = listening service id + event type
-        std::pmr::unordered_map<CallbackKey, Ichor::function<void(Event const * const)>> _errorCallbacks{_memResource}; // key = listening service id + event type
-        std::pmr::unordered_map<uint64_t, std::pmr::vector<EventCallbackInfo>> _eventCallbacks{_memResource}; // key = event id
-        std::pmr::unordered_map<uint64_t, std::pmr::vector<EventInterceptInfo>> _eventInterceptors{_memResource}; // key = event id
+        // the following are indexed by event type index
+        std::pmr::vector<std::pmr::unordered_map<uint64_t, Ichor::function<void(Event const * const)>>> _completionCallbacks{_memResource}; // key = listening service id
+        std::pmr::vector<std::pmr::unordered_map<uint64_t, Ichor::function<void(Event const * const)>>> _errorCallbacks{_memResource}; // key = listening service id
+        std::pmr::vector<std::pmr::vector<EventCallbackInfo>> _eventCallbacks{_memResource};
+        std::pmr::vector<std::pmr::vector<EventInterceptInfo>> _eventInterceptors{_memResource};
+        std::pmr::vector<EventInterceptInfo> _globalEventInterceptors{_memResource}; // interceptors for all events
+        uint64_t _eventInterceptorCount{}; // global and per type interceptors
+        std::pmr::vector<std::pmr::vector<EventAwaiterInfo>> _eventTypeAwaiters{_memResource}; // indexed by event type index
+        std::pmr::unordered_map<uint64_t, std::pmr::vector<EventAwaiterInfo>> _eventIdAwaiters{_memResource}; // key = event id
+        std::pmr::vector<EventAwaiterInfo> _resumingAwaiters{_memResource}; // only used by resumeEventAwaiters()
+        uint64_t _eventAwaiterCount{};
+        uint64_t _runningTaskServiceId{}; // service of the event handler task that is currently started or resumed
         IFrameworkLogger *_logger{nullptr};
         std::shared_ptr<ILifecycleManager> _preventEarlyDestructionOfFrameworkLogger{nullptr};
-        std::multimap<uint64_t, Ichor::unique_ptr<Event>, std::less<>, Ichor::PolymorphicAllocator<std::pair<const uint64_t, Ichor::unique_ptr<Event>>>> _eventQueue{_eventMemResource};
-        RealtimeReadWriteMutex _eventQueueMutex{};
+        EventLoopNotifier _notifier{}; // wakes up the event loop when events are pushed
+        RealtimeReadWriteMutex _wakeUpMutex{}; // only used by waitForEmptyQueue() to wait on _wakeUp
         ConditionVariableAny<RealtimeReadWriteMutex> _wakeUp{};
         std::atomic<uint64_t> _eventIdCounter{0};
         std::atomic<bool> _quit{false};
         std::atomic<bool> _started{false};
+        std::atomic<std::thread::id> _eventLoopThreadId{};
         std::atomic<bool> _emptyQueue{false}; // only true when all events are done processing, as opposed to having an empty _eventQueue. The latter can be empty before processing due to the usage of extract()
         CommunicationChannel *_communicationChannel{nullptr};
         uint64_t _id{_managerIdCounter++};
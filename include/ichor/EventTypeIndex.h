@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <ichor/Concepts.h>
+#include <ichor/Events.h>
+
+namespace Ichor {
+    /// Event type indices are small, dense numbers assigned to every event type, so that per type data can be stored in vectors instead of hash maps.
+    /// Index 0 refers to Event itself (e.g. interceptors for all events). Built-in events have fixed indices known at compile time, other event types get the next free index the first time they are pushed or registered for.
+    constexpr uint32_t ALL_EVENTS_TYPE_INDEX = 0;
+
+    namespace Detail {
+        inline constexpr std::array<uint64_t, 17> builtinEventTypes{
+            DependencyOnlineEvent::TYPE,
+            DependencyOfflineEvent::TYPE,
+            DependencyRequestEvent::TYPE,
+            DependencyUndoRequestEvent::TYPE,
+            QuitEvent::TYPE,
+            StopServiceEvent::TYPE,
+            StartServiceEvent::TYPE,
+            RemoveServiceEvent::TYPE,
+            DoWorkEvent::TYPE,
+            RemoveCompletionCallbacksEvent::TYPE,
+            RemoveEventHandlerEvent::TYPE,
+            RemoveEventInterceptorEvent::TYPE,
+            RemoveTrackerEvent::TYPE,
+            ContinuableEvent<Generator<bool>>::TYPE,
+            UnrecoverableErrorEvent::TYPE,
+            RecoverableErrorEvent::TYPE,
+            RunFunctionEvent::TYPE,
+        };
+
+        /// \return index of type if it is a built-in event, otherwise 0
+        consteval uint32_t builtinEventTypeIndex(uint64_t type) {
+            for(uint32_t i = 0; i < builtinEventTypes.size(); i++) {
+                if(builtinEventTypes[i] == type) {
+                    return i + 1;
+                }
+            }
+            return 0;
+        }
+    }
+
+    /// Thread-safe
+    /// \param type TYPE of the event
+    /// \return index of type, assigns a new index if the type was not seen before
+    [[nodiscard]] uint32_t registerEventType(uint64_t type);
+
+    /// Compile-time index of a built-in event, can be used as case label
+    template <typename EventT>
+    requires Derived<EventT, Event>
+    inline constexpr uint32_t builtinEventTypeIndex = [] {
+        constexpr uint32_t idx = Detail::builtinEventTypeIndex(EventT::TYPE);
+        static_assert(idx != 0, "EventT is not a built-in event");
+        return idx;
+    }();
+
+    template <typename EventT>
+    requires Derived<EventT, Event>
+    [[nodiscard]] uint32_t eventTypeIndex() {
+        if constexpr (std::is_same_v<EventT, Event>) {
+            return ALL_EVENTS_TYPE_INDEX;
+        } else if constexpr (Detail::builtinEventTypeIndex(EventT::TYPE) != 0) {
+            return Detail::builtinEventTypeIndex(EventT::TYPE);
+        } else {
+            static const uint32_t idx = registerEventType(EventT::TYPE);
+            return idx;
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <functional>
 #include <ichor/Dependency.h>
 #include <ichor/Callbacks.h>
 
@@ -19,6 +21,8 @@ namespace Ichor {
         const uint64_t id;
         const uint64_t originatingService;
         const uint64_t priority;
+        std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::time_point::max()}; // events still in the queue after their deadline are dropped instead of dispatched, see DependencyManager::pushPrioritisedEventWithDeadline()
+        uint32_t typeIndex{}; // dense index of type, set by the DependencyManager when pushing the event. See EventTypeIndex.h
     };
 
     struct DependencyOnlineEvent final : public Event {
@@ -146,6 +150,7 @@ namespace Ichor {
     template <typename GeneratorT>
     struct ContinuableEvent final : public Event {
         ContinuableEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, GeneratorT _generator) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), generator(std::move(_generator)) {}
+        ContinuableEvent(ContinuableEvent&&) noexcept = default; // allows storing the event inline in the event queue
         ~ContinuableEvent() final = default;
 
         GeneratorT generator;
@@ -175,10 +180,26 @@ namespace Ichor {
 
     struct RunFunctionEvent final : public Event {
         RunFunctionEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::function<void(DependencyManager*)> _fun) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), fun(std::move(_fun)) {}
+        RunFunctionEvent(RunFunctionEvent&&) noexcept = default; // allows storing the event inline in the event queue
         ~RunFunctionEvent() final = default;
 
         std::function<void(DependencyManager*)> fun;
         static constexpr uint64_t TYPE = typeNameHash<RunFunctionEvent>();
         static constexpr std::string_view NAME = typeName<RunFunctionEvent>();
     };
-}
\ No newline at end of file
+
+    /// Pushed instead of dispatching an event whose deadline passed while it was in the queue, but only if there are handlers for DeadlineMissedEvent.
+    /// Has the same originating service and priority as the missed event.
+    struct DeadlineMissedEvent final : public Event {
+        DeadlineMissedEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _missedEventType, std::string_view _missedEventName, uint64_t _missedEventId, std::chrono::steady_clock::time_point _missedDeadline) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority), missedEventType(_missedEventType), missedEventName(_missedEventName), missedEventId(_missedEventId), missedDeadline(_missedDeadline) {}
+        ~DeadlineMissedEvent() final = default;
+
+        const uint64_t missedEventType;
+        const std::string_view missedEventName;
+        const uint64_t missedEventId;
+        const std::chrono::steady_clock::time_point missedDeadline;
+        static constexpr uint64_t TYPE = typeNameHash<DeadlineMissedEvent>();
+        static constexpr std::string_view NAME = typeName<DeadlineMissedEvent>();
+    };
+}
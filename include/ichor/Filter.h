@@ -2,6 +2,7 @@
 
 #include <ichor/Common.h>
 #include <string>
+#include <optional>
 
 namespace Ichor {
     template <typename T>
@@ -42,6 +43,7 @@ namespace Ichor {
     public:
         virtual ~ITemplatedFilter() = default;
         [[nodiscard]] virtual bool compareTo(const std::shared_ptr<ILifecycleManager> &manager) const = 0;
+        [[nodiscard]] virtual std::optional<uint64_t> getServiceId() const noexcept = 0;
     };
 
     // workaround std::any not supporting polymorphism
@@ -64,6 +66,18 @@ namespace Ichor {
             return matches;
         }
 
+        [[nodiscard]] std::optional<uint64_t> getServiceId() const noexcept final {
+            std::optional<uint64_t> id{};
+            std::apply([&id](auto const &...x){
+                ([&id](auto const &entry) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(entry)>, ServiceIdFilterEntry>) {
+                        id = entry.id;
+                    }
+                }(x), ...);
+            }, entries);
+            return id;
+        }
+
         std::tuple<T...> entries;
     };
 
@@ -81,6 +95,12 @@ namespace Ichor {
             return _templatedFilter->compareTo(manager);
         }
 
+        /// Allows finding the only service that can match without comparing against every service
+        /// \return the id of the service this filter is restricted to, if it contains a ServiceIdFilterEntry
+        [[nodiscard]] std::optional<uint64_t> getServiceId() const noexcept {
+            return _templatedFilter->getServiceId();
+        }
+
         std::shared_ptr<ITemplatedFilter> _templatedFilter;
     };
 }
@@ -73,13 +73,13 @@ namespace Ichor{
             }
 
             void *operator new(std::size_t sz) {
-                auto* rsrc = getThreadLocalMemoryResource();
+                auto* rsrc = getThreadLocalFrameResource();
                 auto* ptr = rsrc->allocate(sz);
                 return ptr;
             }
 
             void operator delete(void *ptr, std::size_t sz) noexcept {
-                auto* rsrc = getThreadLocalMemoryResource();
+                auto* rsrc = getThreadLocalFrameResource();
                 rsrc->deallocate(ptr, sz);
             }
 
@@ -5,4 +5,7 @@
 namespace Ichor {
     std::pmr::memory_resource* getThreadLocalMemoryResource() noexcept;
     void setThreadLocalMemoryResource(std::pmr::memory_resource* _rsrc) noexcept;
+    /// Resource used for coroutine frames of Generator, set by the DependencyManager running on this thread
+    std::pmr::memory_resource* getThreadLocalFrameResource() noexcept;
+    void setThreadLocalFrameResource(std::pmr::memory_resource* _rsrc) noexcept;
 }
\ No newline at end of file
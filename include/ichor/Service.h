@@ -113,6 +113,10 @@ namespace Ichor {
             if(ret == StartBehaviour::SUCCEEDED) {
                 INTERNAL_DEBUG("service {} state {} -> {}", getServiceId(), getState(), ServiceState::INJECTING);
                 _serviceState = ServiceState::INJECTING;
+            } else {
+                // nothing to stop, so a service that is still trying to start doesn't keep the manager from quitting
+                INTERNAL_DEBUG("service {} state {} -> {}", getServiceId(), getState(), ServiceState::INSTALLED);
+                _serviceState = ServiceState::INSTALLED;
             }
 
             return ret;
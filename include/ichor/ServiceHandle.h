@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace Ichor {
+    /// Refers to a slot in a ServiceRegistry. Slots are reused for other services, the generation tells them apart.
+    struct ServiceHandle final {
+        static constexpr uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+        uint32_t slot{INVALID_SLOT};
+        uint32_t generation{};
+
+        [[nodiscard]] bool valid() const noexcept {
+            return slot != INVALID_SLOT;
+        }
+    };
+}
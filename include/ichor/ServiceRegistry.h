@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <ichor/LifecycleManager.h>
+#include <ichor/ServiceHandle.h>
+
+namespace Ichor {
+    /// Generational slot map holding the lifecycle managers of a DependencyManager, not thread-safe.
+    /// Managers, their service ids and a mirror of their service state are stored in dense arrays, so iterating over all services touches contiguous memory. Erasing moves the last service into the hole.
+    /// A ServiceHandle stays valid while its service is in the registry and is detected as stale afterwards, even if the slot is reused. Checking the state of a service through a handle costs two indexed loads.
+    /// Service ids are unique over all DependencyManagers and assigned before a service is known to any of them, so finding a service by id still uses a hash map. Hot paths should keep a handle instead.
+    class ServiceRegistry final {
+    public:
+        explicit ServiceRegistry(std::pmr::memory_resource *rsrc);
+
+        ServiceRegistry(const ServiceRegistry&) = delete;
+        ServiceRegistry(ServiceRegistry&&) = delete;
+        ServiceRegistry& operator=(const ServiceRegistry&) = delete;
+        ServiceRegistry& operator=(ServiceRegistry&&) = delete;
+
+        /// Throws std::runtime_error if a service with the same id is already present
+        ServiceHandle insert(std::shared_ptr<ILifecycleManager> manager);
+
+        /// Invalidates all handles to the service. Pointers to other managers stay valid, but references into managers() do not.
+        /// \return true if the service was present
+        bool erase(uint64_t serviceId);
+
+        void clear() noexcept;
+
+        /// \return nullptr if not present. The manager itself stays at the same address until it is erased.
+        [[nodiscard]] ILifecycleManager* find(uint64_t serviceId) const noexcept;
+
+        /// \return nullptr if not present. Only valid until the next insert or erase.
+        [[nodiscard]] std::shared_ptr<ILifecycleManager> const* findShared(uint64_t serviceId) const noexcept;
+
+        /// \return invalid handle if not present
+        [[nodiscard]] ServiceHandle getHandle(uint64_t serviceId) const noexcept;
+
+        /// \return mirrored state of the service, ServiceState::UNINSTALLED if the handle is stale or invalid
+        [[nodiscard]] ServiceState getState(ServiceHandle handle) const noexcept {
+            if(handle.slot >= _slots.size()) {
+                return ServiceState::UNINSTALLED;
+            }
+
+            auto const &slot = _slots[handle.slot];
+            if(slot.generation != handle.generation) {
+                return ServiceState::UNINSTALLED;
+            }
+
+            return _states[slot.denseIndex];
+        }
+
+        /// Refreshes the mirrored state. Has to be called after every call on the lifecycle manager that can change the state of its service.
+        void updateState(ILifecycleManager const &manager) noexcept;
+
+        [[nodiscard]] std::span<std::shared_ptr<ILifecycleManager> const> managers() const noexcept {
+            return _managers;
+        }
+
+        /// Same order as managers()
+        [[nodiscard]] std::span<ServiceState const> states() const noexcept {
+            return _states;
+        }
+
+        [[nodiscard]] uint64_t size() const noexcept {
+            return _managers.size();
+        }
+
+    private:
+        struct Slot {
+            uint32_t denseIndex;
+            uint32_t generation;
+        };
+
+        std::pmr::vector<Slot> _slots;
+        std::pmr::vector<uint32_t> _freeSlots;
+        // dense arrays, all indexed by Slot::denseIndex
+        std::pmr::vector<std::shared_ptr<ILifecycleManager>> _managers;
+        std::pmr::vector<ServiceState> _states;
+        std::pmr::vector<uint32_t> _slotOfDense;
+        std::pmr::unordered_map<uint64_t, uint32_t> _slotById; // key = service id
+    };
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cppcoro/coroutine.hpp>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <ichor/GetThreadLocalMemoryResource.h>
+
+namespace Ichor {
+
+    template<typename T>
+    class Task;
+
+    namespace Detail {
+        class TaskPromiseBase {
+        public:
+            struct FinalAwaiter {
+                constexpr bool await_ready() const noexcept { return false; }
+
+                template<typename Promise>
+                cppcoro::coroutine_handle<> await_suspend(cppcoro::coroutine_handle<Promise> coroutine) noexcept {
+                    auto &promise = static_cast<TaskPromiseBase&>(coroutine.promise());
+                    if(promise._continuation) {
+                        return promise._continuation;
+                    }
+
+                    // nobody is going to ask for the result of a detached task, so it cleans up after itself
+                    if(promise._detached) {
+                        coroutine.destroy();
+                    }
+
+                    return cppcoro::noop_coroutine();
+                }
+
+                constexpr void await_resume() const noexcept {}
+            };
+
+            TaskPromiseBase() = default;
+
+            constexpr cppcoro::suspend_always initial_suspend() const noexcept { return {}; }
+
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() noexcept {
+                // there is nobody left to rethrow to
+                if(_detached) {
+                    std::terminate();
+                }
+                _exception = std::current_exception();
+            }
+
+            void setContinuation(cppcoro::coroutine_handle<> continuation, cppcoro::coroutine_handle<> root) noexcept {
+                _continuation = continuation;
+                _root = root;
+            }
+
+            /// Outermost task of a chain of tasks awaiting each other. Destroying it destroys the whole chain.
+            [[nodiscard]] cppcoro::coroutine_handle<> root() const noexcept {
+                return _root;
+            }
+
+            void detach() noexcept {
+                _detached = true;
+            }
+
+            void rethrow_if_exception() {
+                if (_exception) {
+                    std::rethrow_exception(_exception);
+                }
+            }
+
+            void *operator new(std::size_t sz) {
+                auto* rsrc = getThreadLocalFrameResource();
+                auto* ptr = rsrc->allocate(sz);
+                return ptr;
+            }
+
+            void operator delete(void *ptr, std::size_t sz) noexcept {
+                auto* rsrc = getThreadLocalFrameResource();
+                rsrc->deallocate(ptr, sz);
+            }
+
+        protected:
+            cppcoro::coroutine_handle<> _continuation{};
+            cppcoro::coroutine_handle<> _root{};
+            std::exception_ptr _exception{};
+            bool _detached{};
+        };
+
+        template<typename T>
+        class TaskPromise final : public TaskPromiseBase {
+        public:
+            Task<T> get_return_object() noexcept;
+
+            template<typename U>
+            requires std::is_convertible_v<U&&, T>
+            void return_value(U &&value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+                _value.emplace(std::forward<U>(value));
+            }
+
+            T result() {
+                rethrow_if_exception();
+                return std::move(*_value);
+            }
+
+        private:
+            std::optional<T> _value{};
+        };
+
+        template<>
+        class TaskPromise<void> final : public TaskPromiseBase {
+        public:
+            Task<void> get_return_object() noexcept;
+
+            constexpr void return_void() const noexcept {}
+
+            void result() {
+                rethrow_if_exception();
+            }
+        };
+
+        template<typename T>
+        struct TaskAwaiter {
+            [[nodiscard]] bool await_ready() const noexcept {
+                return !coroutine || coroutine.done();
+            }
+
+            template<typename Promise>
+            cppcoro::coroutine_handle<> await_suspend(cppcoro::coroutine_handle<Promise> awaiting) noexcept {
+                if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>) {
+                    coroutine.promise().setContinuation(awaiting, awaiting.promise().root());
+                } else {
+                    coroutine.promise().setContinuation(awaiting, awaiting);
+                }
+                return coroutine;
+            }
+
+            T await_resume() {
+                return coroutine.promise().result();
+            }
+
+            cppcoro::coroutine_handle<TaskPromise<T>> coroutine;
+        };
+    }
+
+    /// Lazily started coroutine that can co_await other tasks and the awaitables of a DependencyManager, such as DependencyManager::waitForEvent().
+    /// Event handlers can return Task<bool>, in which case the manager keeps the suspended handler around and resumes it on its own thread once the awaited event has been processed.
+    /// Tasks are not thread-safe and have to be created, resumed and destroyed on the thread of the manager that runs them.
+    template<typename T>
+    class [[nodiscard]] Task final {
+    public:
+        using promise_type = Detail::TaskPromise<T>;
+
+        Task() noexcept = default;
+
+        Task(Task &&other) noexcept : _coroutine(std::exchange(other._coroutine, nullptr)) {
+        }
+
+        Task(const Task &other) = delete;
+
+        Task& operator=(Task other) noexcept {
+            std::swap(_coroutine, other._coroutine);
+            return *this;
+        }
+
+        ~Task() {
+            if (_coroutine) {
+                _coroutine.destroy();
+            }
+        }
+
+        Detail::TaskAwaiter<T> operator co_await() && noexcept {
+            return Detail::TaskAwaiter<T>{_coroutine};
+        }
+
+        /// Runs the task until it completes or suspends for the first time
+        void start() {
+            _coroutine.resume();
+        }
+
+        [[nodiscard]] bool done() const noexcept {
+            return !_coroutine || _coroutine.done();
+        }
+
+        /// Precondition: done()
+        T result() {
+            return _coroutine.promise().result();
+        }
+
+        /// Gives up ownership of a suspended task, it destroys itself once it completes.
+        void detach() noexcept {
+            _coroutine.promise().detach();
+            _coroutine = nullptr;
+        }
+
+    private:
+        friend class Detail::TaskPromise<T>;
+
+        explicit Task(cppcoro::coroutine_handle<promise_type> coroutine) noexcept : _coroutine(coroutine) {
+        }
+
+        cppcoro::coroutine_handle<promise_type> _coroutine{};
+    };
+
+    namespace Detail {
+        template<typename T>
+        Task<T> TaskPromise<T>::get_return_object() noexcept {
+            auto coroutine = cppcoro::coroutine_handle<TaskPromise<T>>::from_promise(*this);
+            _root = coroutine;
+            return Task<T>{coroutine};
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+            auto coroutine = cppcoro::coroutine_handle<TaskPromise<void>>::from_promise(*this);
+            _root = coroutine;
+            return Task<void>{coroutine};
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <ichor/event_queues/IEventQueue.h>
+#include <ichor/event_queues/PriorityBuckets.h>
+#include <ichor/stl/RealtimeMutex.h>
+
+namespace Ichor {
+    /// Event queue with O(1) push and pop, using a FIFO ring buffer per priority level. Protected by a single mutex.
+    /// Only the first PriorityBuckets::MAX_LEVELS different priorities waiting in the queue at the same time get a ring buffer, further ones fall back to a slower sorted map.
+    class BucketEventQueue final : public IEventQueue {
+    public:
+        explicit BucketEventQueue(std::pmr::memory_resource *rsrc);
+        ~BucketEventQueue() final = default;
+
+        void pushEvent(uint64_t priority, EventStackUniquePtr &&event) final;
+        void pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) final;
+        [[nodiscard]] EventStackUniquePtr popEvent() final;
+        void popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) final;
+        [[nodiscard]] uint64_t peekHighestPriority() final;
+
+        [[nodiscard]] bool empty() const final;
+        [[nodiscard]] uint64_t size() const final;
+        void clear() final;
+
+    private:
+        PriorityBuckets<EventStackUniquePtr> _eventQueue;
+        mutable RealtimeMutex _eventQueueMutex{};
+        std::atomic<uint64_t> _highestPriority{std::numeric_limits<uint64_t>::max()}; // updated while holding the lock, so the consumer can peek without locking
+    };
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifndef __linux__
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/ConditionVariable.h>
+#endif
+
+namespace Ichor {
+    /// What the event loop does when there are no events left to process
+    enum class IdleStrategy {
+        BLOCK, // default, sleep until an event is pushed
+        SPIN_THEN_PARK, // poll the event queue for a configured amount of iterations, then sleep until an event is pushed
+        BUSY_POLL, // never sleep, poll the event queue until the manager quits. Occupies a full core, meant for managers pinned to an isolated core
+    };
+
+    /// Hint to the cpu that we are in a spin loop
+    inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    struct EventLoopStatistics final {
+        uint64_t parks; // amount of times the event loop went to sleep
+        uint64_t notifications; // amount of times a producer had to wake up the event loop
+        uint64_t timerWakeups; // amount of times the event loop woke up because its deadline passed
+    };
+
+    /// Lets the event loop sleep until an event is pushed, without producers having to do a syscall for every event.
+    /// The consumer announces it is about to sleep with an atomic flag, only producers that observe the flag wake it up.
+    /// On linux, sleeping is done with epoll on an eventfd. Deadlines are absolute and use a timerfd, which wakes up with a much finer granularity than the millisecond timeout of epoll_wait. Other file descriptors can be added to the epoll set to wake up the loop as well. Other platforms use a condition variable.
+    class EventLoopNotifier final {
+    public:
+        EventLoopNotifier();
+        ~EventLoopNotifier();
+
+        EventLoopNotifier(const EventLoopNotifier&) = delete;
+        EventLoopNotifier(EventLoopNotifier&&) = delete;
+        EventLoopNotifier& operator=(const EventLoopNotifier&) = delete;
+        EventLoopNotifier& operator=(EventLoopNotifier&&) = delete;
+
+        /// Has to be called by producers after inserting an event, from any thread. Only does a syscall if the consumer is sleeping.
+        void notify() noexcept {
+            // pairs with the fence in wait(): either the consumer sees the inserted event, or we see that it is sleeping
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(_sleeping.load(std::memory_order_relaxed) && _sleeping.exchange(false, std::memory_order_acq_rel)) {
+                wake();
+            }
+        }
+
+        /// Sleep until notify() is called or the deadline passes. Only to be called from the consumer thread.
+        /// \param hasWork checked after announcing the intention to sleep, returning true prevents sleeping. Prevents missing events pushed right before sleeping.
+        /// \param deadline time to wake up at, std::chrono::steady_clock::time_point::max() to sleep until notified
+        template <typename F>
+        void wait(F &&hasWork, std::chrono::steady_clock::time_point deadline) {
+            _sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(hasWork()) {
+                _sleeping.store(false, std::memory_order_relaxed);
+                return;
+            }
+
+            park(deadline);
+            _sleeping.store(false, std::memory_order_relaxed);
+        }
+
+#ifdef __linux__
+        /// Add a file descriptor that wakes up the event loop when it becomes readable. The file descriptor is never read by the notifier.
+        void addWakeupFd(int fd);
+
+        void removeWakeupFd(int fd) noexcept;
+#endif
+
+        [[nodiscard]] EventLoopStatistics getStatistics() const noexcept {
+            return {_parks.load(std::memory_order_relaxed), _notifications.load(std::memory_order_relaxed), _timerWakeups.load(std::memory_order_relaxed)};
+        }
+
+    private:
+        void park(std::chrono::steady_clock::time_point deadline);
+        void wake() noexcept;
+
+        std::atomic<bool> _sleeping{};
+        std::atomic<uint64_t> _parks{};
+        std::atomic<uint64_t> _notifications{};
+        std::atomic<uint64_t> _timerWakeups{};
+#ifdef __linux__
+        int _eventFd{-1};
+        int _timerFd{-1};
+        int _epollFd{-1};
+        std::chrono::steady_clock::time_point _armedDeadline{std::chrono::steady_clock::time_point::max()}; // only used by the consumer thread
+#else
+        RealtimeMutex _mutex{};
+        ConditionVariable _cv{};
+        bool _signaled{};
+#endif
+    };
+}
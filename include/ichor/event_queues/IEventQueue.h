@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include <memory_resource>
+#include <ichor/Events.h>
+#include <ichor/stl/EventStackUniquePtr.h>
+
+namespace Ichor {
+    enum class EventQueueType {
+        LOCKED_MULTIMAP, // a std::multimap protected by a read/write mutex, supports an unlimited amount of different priorities
+        LOCK_FREE_MPSC, // lock-free bounded ring for producers on other threads, consumer-local ordering
+        PRIORITY_BUCKETS, // default, O(1) push/pop with a FIFO ring per priority level, protected by a mutex
+    };
+
+    /// Event queue as used by the DependencyManager.
+    /// pushEvent() may be called from any thread, all other functions are only allowed to be called from the thread running the event loop.
+    /// Implementations have to return events ordered by priority (lower value first) and in insertion order within the same priority.
+    class IEventQueue {
+    public:
+        virtual ~IEventQueue() = default;
+
+        virtual void pushEvent(uint64_t priority, EventStackUniquePtr &&event) = 0;
+
+        /// Moves all events into the queue at once, equivalent to calling pushEvent() for each of them in order but without interleaving with other producers
+        virtual void pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) = 0;
+
+        /// \return the next event to process or an empty pointer if the queue is empty
+        [[nodiscard]] virtual EventStackUniquePtr popEvent() = 0;
+
+        /// Moves up to max events to the end of events, in the same order as repeatedly calling popEvent() would
+        virtual void popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) = 0;
+
+        /// Cheap enough to call before every event
+        /// \return priority of the event popEvent() would return, std::numeric_limits<uint64_t>::max() if the queue is empty
+        [[nodiscard]] virtual uint64_t peekHighestPriority() = 0;
+
+        [[nodiscard]] virtual bool empty() const = 0;
+        [[nodiscard]] virtual uint64_t size() const = 0;
+        virtual void clear() = 0;
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <ichor/event_queues/IEventQueue.h>
+#include <ichor/event_queues/PriorityBuckets.h>
+#include <ichor/stl/RealtimeMutex.h>
+
+namespace Ichor {
+    /// Multi-producer/single-consumer event queue.
+    /// Producers on other threads insert into a lock-free bounded ring (see Dmitry Vyukov's bounded MPMC queue), the consumer moves events from the ring into local priority buckets to keep priority and FIFO ordering.
+    /// Events pushed from the consumer thread itself (i.e. from within event handlers) skip the ring and are inserted directly into the local buckets.
+    /// When the ring is full, producers fall back to a mutex protected overflow list until the consumer has drained it. Before moving the overflow, the consumer waits for producers that claimed a ring cell to publish it, so that events pushed by the same thread are never reordered.
+    class MpscEventQueue final : public IEventQueue {
+    public:
+        /// \param rsrc memory resource used for the ring and consumer-local ordering, only used by the consumer thread after construction
+        /// \param capacity amount of events the lock-free ring can hold, rounded up to a power of two
+        explicit MpscEventQueue(std::pmr::memory_resource *rsrc, uint64_t capacity = 4096);
+        ~MpscEventQueue() final;
+
+        void pushEvent(uint64_t priority, EventStackUniquePtr &&event) final;
+        void pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) final;
+        [[nodiscard]] EventStackUniquePtr popEvent() final;
+        void popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) final;
+        [[nodiscard]] uint64_t peekHighestPriority() final;
+
+        [[nodiscard]] bool empty() const final;
+        [[nodiscard]] uint64_t size() const final;
+        void clear() final;
+
+    private:
+        struct Cell {
+            std::atomic<uint64_t> sequence;
+            uint64_t priority;
+            EventStackUniquePtr event;
+        };
+
+        // claims a contiguous range of cells for all events, or none at all
+        [[nodiscard]] bool tryPushRing(uint64_t priority, std::span<EventStackUniquePtr> events) noexcept;
+        void drainRing();
+        void drainToLocal();
+
+        std::pmr::memory_resource *_rsrc;
+        Cell *_ring;
+        const uint64_t _mask;
+
+        // padding instead of alignas, Ichor::make_unique does not support over-aligned types
+        char _pad0[64]{};
+        std::atomic<uint64_t> _enqueuePos{};
+        char _pad1[64 - sizeof(std::atomic<uint64_t>)]{};
+        std::atomic<std::thread::id> _consumerThreadId{};
+
+        // consumer-only state
+        uint64_t _dequeuePos{};
+        PriorityBuckets<EventStackUniquePtr> _local;
+
+        // producers might be on any thread, so the overflow cannot use the (possibly unsynchronized) memory resource
+        char _pad2[64]{};
+        std::atomic<bool> _overflowing{};
+        mutable RealtimeMutex _overflowMutex{};
+        std::vector<std::pair<uint64_t, EventStackUniquePtr>> _overflow{};
+    };
+}
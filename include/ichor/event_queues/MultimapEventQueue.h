@@ -0,0 +1,30 @@
+#pragma once
+
+#include <map>
+#include <atomic>
+#include <ichor/event_queues/IEventQueue.h>
+#include <ichor/stl/RealtimeReadWriteMutex.h>
+
+namespace Ichor {
+    /// Original event queue: every push and pop takes a lock and does an O(log n) insert into a std::multimap.
+    class MultimapEventQueue final : public IEventQueue {
+    public:
+        explicit MultimapEventQueue(std::pmr::memory_resource *rsrc);
+        ~MultimapEventQueue() final = default;
+
+        void pushEvent(uint64_t priority, EventStackUniquePtr &&event) final;
+        void pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) final;
+        [[nodiscard]] EventStackUniquePtr popEvent() final;
+        void popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) final;
+        [[nodiscard]] uint64_t peekHighestPriority() final;
+
+        [[nodiscard]] bool empty() const final;
+        [[nodiscard]] uint64_t size() const final;
+        void clear() final;
+
+    private:
+        std::multimap<uint64_t, EventStackUniquePtr, std::less<>, Ichor::PolymorphicAllocator<std::pair<const uint64_t, EventStackUniquePtr>>> _eventQueue;
+        mutable RealtimeReadWriteMutex _eventQueueMutex{};
+        std::atomic<uint64_t> _highestPriority{std::numeric_limits<uint64_t>::max()}; // updated while holding the lock, so the consumer can peek without locking
+    };
+}
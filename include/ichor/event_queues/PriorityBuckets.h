@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace Ichor {
+    /// Priority ordered FIFO container with O(1) push and pop, not thread-safe.
+    /// Every distinct priority gets its own level, consisting of a queue of fixed size chunks. Levels are kept sorted by priority and a bitmap tracks which levels are non-empty, so finding the next element is a single countr_zero.
+    /// Elements are never relocated once pushed and released chunks are cached, so steady-state pushes and pops do not allocate.
+    /// Empty levels are only reclaimed when a new priority needs a level and all MAX_LEVELS are in use. If none of them are empty, the priority is stored in a sorted map instead, which is slower but keeps priority and FIFO ordering.
+    /// \tparam T element type
+    template <typename T>
+    class PriorityBuckets final {
+    public:
+        static constexpr uint64_t MAX_LEVELS = 64;
+        // keep chunks small enough to be served by the pools of std::pmr pool resources instead of their (slow) fallback for large allocations
+        static constexpr uint64_t CHUNK_BYTES = 4096;
+        static constexpr uint32_t CHUNK_SIZE = static_cast<uint32_t>(std::max<uint64_t>(4, (CHUNK_BYTES - alignof(T) - sizeof(void*)) / sizeof(T)));
+        static constexpr uint64_t MAX_CACHED_CHUNKS = 16;
+
+        explicit PriorityBuckets(std::pmr::memory_resource *rsrc) noexcept : _rsrc(rsrc), _overflow(rsrc) {}
+
+        ~PriorityBuckets() {
+            clear();
+            for(uint64_t i = 0; i < _levelCount; i++) {
+                releaseLevel(_levels[i]);
+            }
+            while(_freeChunks != nullptr) {
+                auto *next = _freeChunks->next;
+                _rsrc->deallocate(_freeChunks, sizeof(Chunk), alignof(Chunk));
+                _freeChunks = next;
+            }
+        }
+
+        PriorityBuckets(const PriorityBuckets&) = delete;
+        PriorityBuckets(PriorityBuckets&&) = delete;
+        PriorityBuckets& operator=(const PriorityBuckets&) = delete;
+        PriorityBuckets& operator=(PriorityBuckets&&) = delete;
+
+        void push(uint64_t priority, T &&t) {
+            auto idx = findOrInsertLevel(priority);
+            if(idx == MAX_LEVELS) {
+                _overflow[priority].push_back(std::move(t));
+                _overflowSize++;
+                _size++;
+                return;
+            }
+            auto &level = _levels[idx];
+
+            if(level.tail == nullptr) {
+                level.head = level.tail = acquireChunk();
+            } else if(level.tailIdx == CHUNK_SIZE) {
+                auto *chunk = acquireChunk();
+                level.tail->next = chunk;
+                level.tail = chunk;
+                level.tailIdx = 0;
+            }
+
+            new (level.tail->at(level.tailIdx)) T(std::move(t));
+            level.tailIdx++;
+            level.count++;
+            _nonEmpty |= (1ull << idx);
+            _size++;
+        }
+
+        /// Precondition: !empty()
+        [[nodiscard]] T pop() noexcept {
+            if(_overflowSize != 0 && (_nonEmpty == 0 || _overflow.begin()->first < topLevelPriority())) {
+                return popOverflow();
+            }
+
+            auto idx = static_cast<uint64_t>(std::countr_zero(_nonEmpty));
+            auto &level = _levels[idx];
+            auto *slot = std::launder(reinterpret_cast<T*>(level.head->at(level.headIdx)));
+
+            T t{std::move(*slot)};
+            slot->~T();
+            level.headIdx++;
+            level.count--;
+            _size--;
+
+            if(level.count == 0) {
+                // keep the last chunk around, most levels are used over and over
+                releaseChunks(level.head->next);
+                level.head->next = nullptr;
+                level.tail = level.head;
+                level.headIdx = 0;
+                level.tailIdx = 0;
+                _nonEmpty &= ~(1ull << idx);
+            } else if(level.headIdx == CHUNK_SIZE) {
+                auto *next = level.head->next;
+                level.head->next = nullptr;
+                releaseChunks(level.head);
+                level.head = next;
+                level.headIdx = 0;
+            }
+
+            return t;
+        }
+
+        /// Precondition: !empty()
+        [[nodiscard]] T& top() noexcept {
+            if(_overflowSize != 0 && (_nonEmpty == 0 || _overflow.begin()->first < topLevelPriority())) {
+                return _overflow.begin()->second.front();
+            }
+
+            auto &level = _levels[static_cast<uint64_t>(std::countr_zero(_nonEmpty))];
+            return *std::launder(reinterpret_cast<T*>(level.head->at(level.headIdx)));
+        }
+
+        /// Precondition: !empty()
+        [[nodiscard]] uint64_t topPriority() const noexcept {
+            if(_overflowSize != 0 && (_nonEmpty == 0 || _overflow.begin()->first < topLevelPriority())) {
+                return _overflow.begin()->first;
+            }
+            return topLevelPriority();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        [[nodiscard]] uint64_t size() const noexcept {
+            return _size;
+        }
+
+        void clear() noexcept {
+            while(!empty()) {
+                [[maybe_unused]] T t = pop();
+            }
+        }
+
+    private:
+        struct Chunk {
+            [[nodiscard]] void* at(uint32_t idx) noexcept {
+                return storage + sizeof(T) * idx;
+            }
+
+            Chunk *next;
+            alignas(T) std::byte storage[sizeof(T) * CHUNK_SIZE];
+        };
+
+        struct Level {
+            uint64_t priority;
+            Chunk *head;
+            Chunk *tail;
+            uint32_t headIdx;
+            uint32_t tailIdx;
+            uint64_t count;
+        };
+
+        [[nodiscard]] uint64_t topLevelPriority() const noexcept {
+            return _levels[static_cast<uint64_t>(std::countr_zero(_nonEmpty))].priority;
+        }
+
+        [[nodiscard]] T popOverflow() noexcept {
+            auto it = _overflow.begin();
+            T t{std::move(it->second.front())};
+            it->second.pop_front();
+            if(it->second.empty()) {
+                _overflow.erase(it);
+            }
+            _overflowSize--;
+            _size--;
+            return t;
+        }
+
+        /// \return index of the level for priority, or MAX_LEVELS if it has to go into the overflow
+        uint64_t findOrInsertLevel(uint64_t priority) {
+            // most pushes use the same priority as the previous one
+            if(_lastIdx < _levelCount && _levels[_lastIdx].priority == priority) {
+                return _lastIdx;
+            }
+
+            uint64_t idx = lowerBound(priority);
+            if(idx < _levelCount && _levels[idx].priority == priority) {
+                _lastIdx = idx;
+                return idx;
+            }
+
+            // a priority is either in a level or in the overflow, never both, otherwise its FIFO order would be lost
+            if(_overflowSize != 0 && _overflow.contains(priority)) {
+                return MAX_LEVELS;
+            }
+
+            if(_levelCount == MAX_LEVELS) {
+                reclaimEmptyLevels();
+                if(_levelCount == MAX_LEVELS) {
+                    return MAX_LEVELS;
+                }
+                idx = lowerBound(priority);
+            }
+
+            for(uint64_t i = _levelCount; i > idx; i--) {
+                _levels[i] = _levels[i - 1];
+            }
+            _levels[idx] = Level{priority, nullptr, nullptr, 0, 0, 0};
+            _levelCount++;
+
+            // shift the bits of all levels at or after idx up by one
+            uint64_t lowMask = (1ull << idx) - 1;
+            _nonEmpty = (_nonEmpty & lowMask) | ((_nonEmpty & ~lowMask) << 1);
+
+            _lastIdx = idx;
+            return idx;
+        }
+
+        [[nodiscard]] uint64_t lowerBound(uint64_t priority) const noexcept {
+            uint64_t first = 0;
+            uint64_t count = _levelCount;
+            while(count > 0) {
+                uint64_t step = count / 2;
+                if(_levels[first + step].priority < priority) {
+                    first += step + 1;
+                    count -= step + 1;
+                } else {
+                    count = step;
+                }
+            }
+            return first;
+        }
+
+        void reclaimEmptyLevels() noexcept {
+            uint64_t newCount = 0;
+            uint64_t newNonEmpty = 0;
+            for(uint64_t i = 0; i < _levelCount; i++) {
+                if(_levels[i].count == 0) {
+                    releaseLevel(_levels[i]);
+                    continue;
+                }
+                _levels[newCount] = _levels[i];
+                newNonEmpty |= (1ull << newCount);
+                newCount++;
+            }
+            _levelCount = newCount;
+            _nonEmpty = newNonEmpty;
+        }
+
+        /// Precondition: level.count == 0
+        void releaseLevel(Level &level) noexcept {
+            releaseChunks(level.head);
+            level.head = nullptr;
+            level.tail = nullptr;
+        }
+
+        Chunk* acquireChunk() {
+            if(_freeChunks != nullptr) {
+                auto *chunk = _freeChunks;
+                _freeChunks = chunk->next;
+                _freeChunkCount--;
+                chunk->next = nullptr;
+                return chunk;
+            }
+
+            auto *chunk = static_cast<Chunk*>(_rsrc->allocate(sizeof(Chunk), alignof(Chunk)));
+            chunk->next = nullptr;
+            return chunk;
+        }
+
+        /// Releases a linked list of chunks that no longer contain elements
+        void releaseChunks(Chunk *chunk) noexcept {
+            while(chunk != nullptr) {
+                auto *next = chunk->next;
+                if(_freeChunkCount < MAX_CACHED_CHUNKS) {
+                    chunk->next = _freeChunks;
+                    _freeChunks = chunk;
+                    _freeChunkCount++;
+                } else {
+                    _rsrc->deallocate(chunk, sizeof(Chunk), alignof(Chunk));
+                }
+                chunk = next;
+            }
+        }
+
+        std::pmr::memory_resource *_rsrc;
+        std::array<Level, MAX_LEVELS> _levels{};
+        uint64_t _levelCount{};
+        uint64_t _lastIdx{};
+        uint64_t _nonEmpty{}; // bit i is set if _levels[i] contains elements
+        uint64_t _size{};
+        Chunk *_freeChunks{};
+        uint64_t _freeChunkCount{};
+        // priorities that did not get a level because all MAX_LEVELS were in use by non-empty levels
+        std::pmr::map<uint64_t, std::pmr::deque<T>> _overflow;
+        uint64_t _overflowSize{};
+    };
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include <ichor/stl/Function.h>
+
+namespace Ichor {
+    /// Refers to a timer in a TimerWheel. Timer slots are reused, the generation tells them apart.
+    struct TimerHandle final {
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index{INVALID_INDEX};
+        uint32_t generation{};
+
+        [[nodiscard]] bool valid() const noexcept {
+            return index != INVALID_INDEX;
+        }
+    };
+
+    struct TimerStatistics final {
+        uint64_t fired; // amount of times a timer function was called
+        uint64_t totalLatenessNanosec; // sum of the time between the expiry of a timer and the call to expire() that fired it
+        uint64_t maxLatenessNanosec;
+    };
+
+    /// Hierarchical timing wheel, not thread-safe.
+    /// Time is divided into ticks of the resolution, counted from the epoch. LEVELS wheels of SLOTS slots each cover 1, SLOTS, SLOTS^2 and SLOTS^3 ticks per slot, so with the default resolution timers up to ~4.9 days away are inserted directly. Timers further away are re-inserted when their slot comes around.
+    /// Every slot is an intrusive list, so adding and cancelling a timer is O(1). Timers in higher levels move down a level whenever the lower level wraps around.
+    /// Timers fire at or after their expiry, never before, and at most one tick late. Timers expiring in the same tick are coalesced and fire together.
+    /// Expiries are absolute, so periodic timers do not drift: the next expiry is the previous expiry plus the interval, missed expiries are skipped.
+    class TimerWheel final {
+    public:
+        using clock = std::chrono::steady_clock;
+        static constexpr std::chrono::nanoseconds DEFAULT_RESOLUTION = std::chrono::microseconds(100);
+        static constexpr uint64_t LEVELS = 4;
+        static constexpr uint64_t SLOT_BITS = 8;
+        static constexpr uint64_t SLOTS = 1ull << SLOT_BITS;
+
+        explicit TimerWheel(std::pmr::memory_resource *rsrc, clock::time_point epoch = clock::now());
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel(TimerWheel&&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+        TimerWheel& operator=(TimerWheel&&) = delete;
+
+        /// Change the length of a tick. A lower resolution coalesces more timers into a single wakeup, a higher resolution fires timers closer to their expiry.
+        /// Can only be called when there are no timers.
+        /// \param resolution length of a tick, at least 1 microsecond
+        void setResolution(std::chrono::nanoseconds resolution);
+
+        [[nodiscard]] std::chrono::nanoseconds getResolution() const noexcept {
+            return _tick;
+        }
+
+        /// \param expiry first time fn is called
+        /// \param interval time between calls after the first one, zero for a timer that fires once
+        /// \param fn called from expire(). Can add, cancel and change timers, including its own.
+        TimerHandle add(clock::time_point expiry, std::chrono::nanoseconds interval, Ichor::function<void()> fn);
+
+        /// \return false if the timer already fired (for non-periodic timers) or was cancelled before
+        bool cancel(TimerHandle handle) noexcept;
+
+        /// Change the interval of a timer. The next expiry of a periodic timer moves as well, it becomes the previous expiry plus the new interval.
+        /// \return false if the timer does not exist anymore
+        bool setInterval(TimerHandle handle, std::chrono::nanoseconds interval) noexcept;
+
+        /// Move a timer to a new expiry and interval, as if it was cancelled and added again with the same function
+        /// \return false if the timer does not exist anymore
+        bool reschedule(TimerHandle handle, clock::time_point expiry, std::chrono::nanoseconds interval) noexcept;
+
+        /// Calls the functions of all timers that expired at or before now
+        /// \return amount of timers that fired
+        uint64_t expire(clock::time_point now);
+
+        /// Time at which expire() has work to do, which might be moving timers down a level instead of firing them. clock::time_point::max() if there are no timers.
+        [[nodiscard]] clock::time_point nextDeadline() const noexcept;
+
+        [[nodiscard]] uint64_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        [[nodiscard]] TimerStatistics getStatistics() const noexcept {
+            return _statistics;
+        }
+
+        /// Removes all timers without calling them
+        void clear() noexcept;
+
+    private:
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        struct Node {
+            clock::time_point expiry;
+            std::chrono::nanoseconds interval;
+            uint64_t expiryTick;
+            Ichor::function<void()> fn;
+            uint32_t prev;
+            uint32_t next;
+            uint32_t generation;
+            uint32_t slot; // level * SLOTS + index in level, NONE if not linked
+            bool active;
+        };
+
+        [[nodiscard]] uint64_t tickOf(clock::time_point t) const noexcept;
+        [[nodiscard]] uint64_t nextEventTick() const noexcept;
+        [[nodiscard]] Node* find(TimerHandle handle) noexcept;
+        void link(uint32_t idx, uint64_t tick) noexcept;
+        void unlink(uint32_t idx) noexcept;
+        void release(uint32_t idx) noexcept;
+        void cascade(uint64_t level, uint64_t slotIdx) noexcept;
+        void fire(uint32_t idx, clock::time_point now);
+        void schedule(uint32_t idx, clock::time_point expiry) noexcept;
+
+        std::pmr::vector<Node> _nodes;
+        std::pmr::vector<uint32_t> _freeNodes;
+        std::array<uint32_t, LEVELS * SLOTS> _heads;
+        std::array<std::array<uint64_t, SLOTS / 64>, LEVELS> _occupied{}; // bit i of level l is set if slot i of that level contains timers
+        clock::time_point _epoch;
+        std::chrono::nanoseconds _tick{DEFAULT_RESOLUTION};
+        uint64_t _currentTick{}; // every tick up to and including this one has been processed
+        uint64_t _size{};
+        TimerStatistics _statistics{};
+    };
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <ichor/stl/Function.h>
+
+namespace Ichor {
+    /// Notifies services on the thread of their manager when their file descriptors become ready, instead of every service polling its own.
+    /// Readiness is edge-triggered: callbacks are only called again after new data arrives or buffer space frees up, so they have to read or write until EAGAIN.
+    class IReactor {
+    public:
+        static constexpr uint32_t READABLE = 1;
+        static constexpr uint32_t WRITABLE = 2;
+        static constexpr uint32_t CLOSED = 4; // the peer hung up or an error occurred
+
+        /// Start watching fd. The file descriptor has to be non-blocking.
+        /// \param fd file descriptor to watch, can only be added once
+        /// \param interest combination of READABLE and WRITABLE
+        /// \param onReady called on the thread of the manager with the readiness of fd. Can add, modify and remove file descriptors, including its own.
+        virtual void addFd(int fd, uint32_t interest, Ichor::function<void(uint32_t)> onReady) = 0;
+
+        /// Change what fd is watched for
+        virtual void modifyFd(int fd, uint32_t interest) = 0;
+
+        /// Stop watching fd, has to be called before closing it
+        virtual void removeFd(int fd) noexcept = 0;
+
+    protected:
+        ~IReactor() = default;
+    };
+}
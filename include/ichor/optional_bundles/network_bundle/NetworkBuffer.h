@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+namespace Ichor {
+    namespace Detail {
+        struct NetworkBufferPoolState;
+
+        /// Header in front of the bytes of every buffer, the bytes directly follow it in the same allocation.
+        struct NetworkBufferBlock final {
+            NetworkBufferPoolState *pool; // nullptr for buffers that do not belong to a pool
+            std::pmr::memory_resource *rsrc;
+            uint32_t refs;
+            uint32_t capacity;
+
+            [[nodiscard]] uint8_t* bytes() noexcept {
+                return reinterpret_cast<uint8_t*>(this + 1);
+            }
+        };
+    }
+
+    /// Reference counted handle to a received buffer, which returns to its NetworkBufferPool when the last handle is destroyed.
+    /// Copying a handle shares the buffer instead of copying the bytes. Not thread-safe, just like the pool it came from.
+    class NetworkBuffer final {
+    public:
+        NetworkBuffer() noexcept = default;
+        NetworkBuffer(const NetworkBuffer &o) noexcept;
+        NetworkBuffer(NetworkBuffer &&o) noexcept;
+        NetworkBuffer& operator=(const NetworkBuffer &o) noexcept;
+        NetworkBuffer& operator=(NetworkBuffer &&o) noexcept;
+        ~NetworkBuffer();
+
+        /// Copies the bytes into a buffer that is not part of a pool, for data that was not received into a pooled buffer in the first place.
+        [[nodiscard]] static NetworkBuffer copyOf(std::span<uint8_t const> bytes, std::pmr::memory_resource *rsrc);
+
+        [[nodiscard]] std::span<uint8_t> data() const noexcept {
+            if(_block == nullptr) {
+                return {};
+            }
+            return {_block->bytes(), _size};
+        }
+
+        [[nodiscard]] uint32_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        /// \return the amount of bytes that can be received into this buffer
+        [[nodiscard]] uint32_t capacity() const noexcept {
+            return _block == nullptr ? 0 : _block->capacity;
+        }
+
+        /// \return the amount of handles sharing this buffer
+        [[nodiscard]] uint32_t useCount() const noexcept {
+            return _block == nullptr ? 0 : _block->refs;
+        }
+
+    private:
+        friend class NetworkBufferPool;
+
+        NetworkBuffer(Detail::NetworkBufferBlock *block, uint32_t size) noexcept : _block(block), _size(size) {}
+
+        void release() noexcept;
+
+        Detail::NetworkBufferBlock *_block{};
+        uint32_t _size{};
+    };
+
+    struct NetworkBufferPoolStatistics final {
+        uint64_t allocations; // total amount of buffers handed out
+        uint64_t recycled; // buffers handed out from the free list, without going to the memory resource
+        uint64_t live; // buffers currently referenced by a handle
+        uint64_t cached; // buffers currently kept around for reuse
+        uint32_t bufferSize; // size of the next buffer handed out
+    };
+
+    /// Pool of receive buffers for a single connection, not thread-safe.
+    /// The socket is read directly into a buffer from acquire(), after which commit() sets the amount of bytes received and the buffer can be handed to a NetworkDataEvent without copying.
+    /// The size of the buffers adapts to the traffic: a read filling a buffer completely doubles the size of the next one, while a run of SHRINK_AFTER reads using less than a quarter halves it, both within [minSize, maxSize].
+    /// Only buffers of the current size are cached, at most MAX_CACHED_BUFFERS of them. Handles may outlive the pool, the last one frees the buffer.
+    class NetworkBufferPool final {
+    public:
+        static constexpr uint64_t MAX_CACHED_BUFFERS = 64;
+        static constexpr uint32_t SHRINK_AFTER = 16;
+
+        NetworkBufferPool(std::pmr::memory_resource *rsrc, uint32_t minSize, uint32_t maxSize);
+        ~NetworkBufferPool();
+
+        NetworkBufferPool(const NetworkBufferPool&) = delete;
+        NetworkBufferPool(NetworkBufferPool&&) = delete;
+        NetworkBufferPool& operator=(const NetworkBufferPool&) = delete;
+        NetworkBufferPool& operator=(NetworkBufferPool&&) = delete;
+
+        /// \return a buffer with a size equal to its capacity, to receive into
+        [[nodiscard]] NetworkBuffer acquire();
+
+        /// Sets the amount of bytes received into a buffer from acquire() and adapts the size of the next buffers to it.
+        void commit(NetworkBuffer &buffer, uint32_t received) noexcept;
+
+        [[nodiscard]] NetworkBufferPoolStatistics getStatistics() const noexcept;
+
+    private:
+        Detail::NetworkBufferPoolState *_state;
+    };
+}
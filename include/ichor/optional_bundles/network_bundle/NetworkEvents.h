@@ -1,35 +1,27 @@
 #pragma once
 
 #include <ichor/Events.h>
+#include <ichor/optional_bundles/network_bundle/NetworkBuffer.h>
 
 namespace Ichor {
+    /// Carries the received bytes in the buffer they were received in. Handlers that need the bytes after handling the event can keep a copy of the buffer handle, which shares the buffer.
     struct NetworkDataEvent final : public Event {
-        explicit NetworkDataEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>&& data) noexcept :
-                Event(TYPE, NAME, _id, _originatingService, _priority), _data(std::forward<std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>>(data)), _movedFrom(false) {}
+        explicit NetworkDataEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, NetworkBuffer&& data) noexcept :
+                Event(TYPE, NAME, _id, _originatingService, _priority), _data(std::move(data)) {}
         ~NetworkDataEvent() final = default;
 
         static constexpr uint64_t TYPE = typeNameHash<NetworkDataEvent>();
         static constexpr std::string_view NAME = typeName<NetworkDataEvent>();
 
-        std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>& getData() const {
-            if(_movedFrom) {
-                throw std::runtime_error("already moved from");
-            }
-
-            return _data;
+        [[nodiscard]] std::span<uint8_t> getData() const noexcept {
+            return _data.data();
         }
 
-        std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> moveData() {
-            if(_movedFrom) {
-                throw std::runtime_error("already moved from");
-            }
-
-            _movedFrom = true;
-            return std::move(_data);
+        [[nodiscard]] NetworkBuffer const& getBuffer() const noexcept {
+            return _data;
         }
     private:
-        mutable std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> _data;
-        mutable bool _movedFrom;
+        NetworkBuffer _data;
     };
 
     struct FailedSendMessageEvent final : public Event {
@@ -43,4 +35,28 @@ namespace Ichor {
         mutable std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> data;
         uint64_t msgId;
     };
-}
\ No newline at end of file
+
+    /// Pushed by a connection when more bytes are queued for sending than its high watermark. Producers should hold off sending until the SendQueueLowWatermarkEvent of the same connection.
+    struct SendQueueHighWatermarkEvent final : public Event {
+        explicit SendQueueHighWatermarkEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _queuedBytes) noexcept :
+                Event(TYPE, NAME, _id, _originatingService, _priority), queuedBytes(_queuedBytes) {}
+        ~SendQueueHighWatermarkEvent() final = default;
+
+        static constexpr uint64_t TYPE = typeNameHash<SendQueueHighWatermarkEvent>();
+        static constexpr std::string_view NAME = typeName<SendQueueHighWatermarkEvent>();
+
+        uint64_t queuedBytes;
+    };
+
+    /// Pushed by a connection when the bytes queued for sending dropped to its low watermark, after a SendQueueHighWatermarkEvent.
+    struct SendQueueLowWatermarkEvent final : public Event {
+        explicit SendQueueLowWatermarkEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _queuedBytes) noexcept :
+                Event(TYPE, NAME, _id, _originatingService, _priority), queuedBytes(_queuedBytes) {}
+        ~SendQueueLowWatermarkEvent() final = default;
+
+        static constexpr uint64_t TYPE = typeNameHash<SendQueueLowWatermarkEvent>();
+        static constexpr std::string_view NAME = typeName<SendQueueLowWatermarkEvent>();
+
+        uint64_t queuedBytes;
+    };
+}
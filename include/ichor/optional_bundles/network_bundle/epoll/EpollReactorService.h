@@ -0,0 +1,38 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/optional_bundles/network_bundle/IReactor.h>
+#include <ichor/optional_bundles/logging_bundle/Logger.h>
+
+namespace Ichor {
+    /// IReactor using an edge-triggered epoll instance per manager. The epoll file descriptor is polled by the event loop of the manager, so no threads are involved.
+    class EpollReactorService final : public IReactor, public Service<EpollReactorService> {
+    public:
+        EpollReactorService(DependencyRegister &reg, Properties props, DependencyManager *mng);
+        ~EpollReactorService() final;
+
+        StartBehaviour start() final;
+        StartBehaviour stop() final;
+
+        void addDependencyInstance(ILogger *logger, IService *isvc);
+        void removeDependencyInstance(ILogger *logger, IService *isvc);
+
+        void addFd(int fd, uint32_t interest, Ichor::function<void(uint32_t)> onReady) final;
+        void modifyFd(int fd, uint32_t interest) final;
+        void removeFd(int fd) noexcept final;
+
+    private:
+        void poll();
+
+        struct Registration {
+            Ichor::function<void(uint32_t)> onReady;
+            uint32_t generation{}; // distinguishes a reused file descriptor from the one an epoll event was for
+            bool active{};
+        };
+
+        int _epollFd{-1};
+        uint64_t _ioSourceId{};
+        std::pmr::vector<Registration> _registrations; // indexed by file descriptor
+        ILogger *_logger{nullptr};
+    };
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#ifdef ICHOR_USE_IO_URING
+
+#include <cstdint>
+#include <span>
+#include <linux/io_uring.h>
+#include <ichor/stl/Function.h>
+
+namespace Ichor {
+    /// Called on the thread of the manager with the result and flags of a completion. Multishot operations complete multiple times, IORING_CQE_F_MORE is set in flags when more completions follow.
+    using IOUringCompletion = Ichor::function<void(int32_t res, uint32_t flags)>;
+
+    /// io_uring submission and completion queue of a manager. Completions are reaped by the event loop of the manager, so no threads are involved.
+    /// The queue owns a ring of provided buffers, used by operations with IOSQE_BUFFER_SELECT set and getBufferGroup() as buf_group.
+    class IIOUringQueue {
+    public:
+        /// Get a zeroed submission queue entry with fd and user_data filled in. The entry has to be prepared before the next call to getSqe() or submit().
+        /// \param fd file descriptor the operation is for, cancelFd() cancels it
+        /// \param onCompletion called for every completion of the operation. Can submit and cancel operations, including its own.
+        virtual io_uring_sqe* getSqe(int fd, IOUringCompletion onCompletion) = 0;
+
+        /// Hand all prepared entries to the kernel
+        virtual void submit() = 0;
+
+        /// Cancel all operations on fd and wait until the kernel is done with them, so that their buffers can be released. Their completion functions are not called anymore.
+        virtual void cancelFd(int fd) = 0;
+
+        [[nodiscard]] virtual uint16_t getBufferGroup() const noexcept = 0;
+
+        /// \param bufferId buffer id, taken from the flags of a completion with IORING_CQE_F_BUFFER set
+        /// \return the whole provided buffer, the amount of bytes used is the result of the completion
+        [[nodiscard]] virtual std::span<uint8_t> getBuffer(uint16_t bufferId) noexcept = 0;
+
+        /// Give a buffer back to the kernel once its contents are no longer needed
+        virtual void recycleBuffer(uint16_t bufferId) noexcept = 0;
+
+    protected:
+        ~IIOUringQueue() = default;
+    };
+}
+
+#endif
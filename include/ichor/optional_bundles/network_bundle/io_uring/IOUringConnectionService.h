@@ -0,0 +1,76 @@
+#pragma once
+
+#ifdef ICHOR_USE_IO_URING
+
+#include <ichor/optional_bundles/network_bundle/IConnectionService.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IIOUringQueue.h>
+#include <ichor/optional_bundles/network_bundle/NetworkBuffer.h>
+#include <ichor/optional_bundles/logging_bundle/Logger.h>
+#include <netinet/in.h>
+#include <optional>
+
+namespace Ichor {
+    /// Connection using a multishot recv into the provided buffers of the IIOUringQueue, pushing a NetworkDataEvent for every completion.
+    /// The provided buffers are shared by all connections and go back to the kernel right away, so received data is copied into buffers from a NetworkBufferPool, sized between the "MinReceiveBufferSize" and "MaxReceiveBufferSize" properties.
+    /// Messages are sent as a chain of linked sends, so they arrive in order. Messages passed to sendAsync() while a chain is in flight, or while still connecting, make up the next chain.
+    /// Messages that are not sent when the connection stops are reported with a FailedSendMessageEvent.
+    /// Connections for an existing "Socket", such as the ones accepted by IOUringHostService, remove themselves once the peer closed the connection and everything queued is sent.
+    class IOUringConnectionService final : public IConnectionService, public Service<IOUringConnectionService> {
+    public:
+        static constexpr uint64_t MAX_CHAIN_LENGTH = 32;
+        static constexpr uint32_t DEFAULT_MIN_RECEIVE_BUFFER_SIZE = 2048;
+        static constexpr uint32_t DEFAULT_MAX_RECEIVE_BUFFER_SIZE = 65536;
+
+        IOUringConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng);
+        ~IOUringConnectionService() final = default;
+
+        StartBehaviour start() final;
+        StartBehaviour stop() final;
+
+        void addDependencyInstance(ILogger *logger, IService *isvc);
+        void removeDependencyInstance(ILogger *logger, IService *isvc);
+        void addDependencyInstance(IIOUringQueue *queue, IService *isvc);
+        void removeDependencyInstance(IIOUringQueue *queue, IService *isvc);
+
+        uint64_t sendAsync(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>&& msg) final;
+        void setPriority(uint64_t priority) final;
+        uint64_t getPriority() final;
+
+    private:
+        struct Message {
+            uint64_t id;
+            std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> data;
+            bool completed{}; // the send of this message in the chain completed, successful or not
+        };
+
+        void onConnect(int32_t res);
+        void armRecv();
+        void onRecv(int32_t res, uint32_t flags);
+        void submitChain();
+        void onSent(uint64_t idx, int32_t res);
+        /// cancels everything in flight, the kernel does not touch our buffers anymore afterwards
+        void cancel();
+        /// pushes a FailedSendMessageEvent for every message that was not sent yet
+        void failQueued();
+        void removeWhenDone();
+
+        int _socket;
+        uint64_t _priority;
+        uint64_t _msgIdCounter;
+        bool _quit;
+        bool _receiving{};
+        bool _connecting{};
+        bool _readClosed{};
+        bool _accepted{};
+        bool _removing{};
+        sockaddr_in _address{}; // read by the kernel when connecting
+        std::optional<NetworkBufferPool> _buffers{};
+        uint64_t _sendsInFlight{};
+        std::pmr::vector<Message> _chain; // being sent
+        std::pmr::vector<Message> _queued; // waiting for the chain to complete
+        ILogger *_logger{nullptr};
+        IIOUringQueue *_queue{nullptr};
+    };
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifdef ICHOR_USE_IO_URING
+
+#include <ichor/optional_bundles/network_bundle/IHostService.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IIOUringQueue.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringConnectionService.h>
+#include <ichor/optional_bundles/logging_bundle/Logger.h>
+
+namespace Ichor {
+    /// Accepts connections with a multishot accept and creates an IOUringConnectionService for each of them
+    /// Supports the same "Backlog" and "ReusePort" properties as TcpHostService, to shard a port over multiple managers.
+    class IOUringHostService final : public IHostService, public Service<IOUringHostService> {
+    public:
+        IOUringHostService(DependencyRegister &reg, Properties props, DependencyManager *mng);
+        ~IOUringHostService() final = default;
+
+        StartBehaviour start() final;
+        StartBehaviour stop() final;
+
+        void addDependencyInstance(ILogger *logger, IService *isvc);
+        void removeDependencyInstance(ILogger *logger, IService *isvc);
+        void addDependencyInstance(IIOUringQueue *queue, IService *isvc);
+        void removeDependencyInstance(IIOUringQueue *queue, IService *isvc);
+
+        void setPriority(uint64_t priority) final;
+        uint64_t getPriority() final;
+
+    private:
+        void armAccept();
+        void onAccept(int32_t res, uint32_t flags);
+
+        int _socket;
+        uint64_t _priority;
+        bool _quit;
+        bool _accepting{};
+        ILogger *_logger{nullptr};
+        IIOUringQueue *_queue{nullptr};
+    };
+}
+
+#endif
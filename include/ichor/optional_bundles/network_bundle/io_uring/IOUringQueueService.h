@@ -0,0 +1,97 @@
+#pragma once
+
+#ifdef ICHOR_USE_IO_URING
+
+#include <ichor/Service.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IIOUringQueue.h>
+#include <ichor/optional_bundles/logging_bundle/Logger.h>
+
+namespace Ichor {
+    /// IIOUringQueue talking to the kernel directly through the io_uring system calls. The ring file descriptor is polled by the event loop of the manager.
+    /// Properties:
+    /// - "Entries" (uint32_t): size of the submission queue, the completion queue is four times as large. Default 256.
+    /// - "BufferCount" (uint32_t): amount of provided buffers, has to be a power of two. Default 256.
+    /// - "BufferSize" (uint32_t): size of a provided buffer in bytes. Default 16384.
+    class IOUringQueueService final : public IIOUringQueue, public Service<IOUringQueueService> {
+    public:
+        IOUringQueueService(DependencyRegister &reg, Properties props, DependencyManager *mng);
+        ~IOUringQueueService() final;
+
+        StartBehaviour start() final;
+        StartBehaviour stop() final;
+
+        void addDependencyInstance(ILogger *logger, IService *isvc);
+        void removeDependencyInstance(ILogger *logger, IService *isvc);
+
+        io_uring_sqe* getSqe(int fd, IOUringCompletion onCompletion) final;
+        void submit() final;
+        void cancelFd(int fd) final;
+
+        [[nodiscard]] uint16_t getBufferGroup() const noexcept final;
+        [[nodiscard]] std::span<uint8_t> getBuffer(uint16_t bufferId) noexcept final;
+        void recycleBuffer(uint16_t bufferId) noexcept final;
+
+    private:
+        struct Operation {
+            IOUringCompletion onCompletion;
+            int fd{-1};
+            uint32_t generation{}; // distinguishes a reused slot from the operation a completion was for
+            bool active{};
+        };
+
+        struct Completion {
+            uint64_t userData;
+            int32_t res;
+            uint32_t flags;
+        };
+
+        void reap();
+        /// moves everything in the completion queue to _pendingCompletions
+        void pullCompletions();
+        [[nodiscard]] bool cancelCompleted() const noexcept;
+        void dispatch(Completion const &completion);
+        void release(uint32_t idx) noexcept;
+        void unmap() noexcept;
+
+        int _ringFd{-1};
+        uint64_t _ioSourceId{};
+        uint32_t _entries{256};
+        uint32_t _bufferCount{256};
+        uint32_t _bufferSize{16384};
+
+        void *_ringPtr{};
+        size_t _ringSize{};
+        void *_cqRingPtr{}; // equal to _ringPtr if the kernel supports a single mmap for both queues
+        size_t _cqRingSize{};
+        io_uring_sqe *_sqes{};
+        size_t _sqesSize{};
+
+        uint32_t *_sqHead{};
+        uint32_t *_sqTail{};
+        uint32_t *_sqFlags{};
+        uint32_t *_sqArray{};
+        uint32_t _sqMask{};
+        uint32_t _sqCapacity{};
+        uint32_t _sqLocalTail{}; // prepared entries up to here
+        uint32_t _sqSubmittedTail{}; // consumed by the kernel up to here
+
+        uint32_t *_cqHead{};
+        uint32_t *_cqTail{};
+        uint32_t _cqMask{};
+        io_uring_cqe *_cqes{};
+
+        io_uring_buf *_bufferRing{}; // io_uring_buf_ring, its tail overlays the resv field of the first entry
+        size_t _bufferRingSize{};
+        uint8_t *_buffers{};
+        size_t _buffersSize{};
+        uint16_t _bufferRingTail{};
+
+        uint64_t _cancelCounter{};
+        std::pmr::vector<Operation> _operations;
+        std::pmr::vector<uint32_t> _freeOperations;
+        std::pmr::vector<Completion> _pendingCompletions; // taken from the completion queue, but not dispatched yet
+        ILogger *_logger{nullptr};
+    };
+}
+
+#endif
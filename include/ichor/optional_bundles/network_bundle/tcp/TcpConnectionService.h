@@ -1,32 +1,82 @@
 #pragma once
 
 #include <ichor/optional_bundles/network_bundle/IConnectionService.h>
+#include <ichor/optional_bundles/network_bundle/IReactor.h>
+#include <ichor/optional_bundles/network_bundle/NetworkBuffer.h>
 #include <ichor/optional_bundles/logging_bundle/Logger.h>
-#include <ichor/optional_bundles/timer_bundle/TimerService.h>
+#include <deque>
+#include <optional>
 
 namespace Ichor {
+    /// Pushes a NetworkDataEvent for every chunk of data received. The socket is watched by the IReactor of the manager and drained until EAGAIN whenever it becomes readable.
+    /// Data is received directly into buffers from a NetworkBufferPool, sized between the "MinReceiveBufferSize" and "MaxReceiveBufferSize" properties.
+    /// Sent messages are queued and written with a single sendmsg() for up to MAX_IOVECS messages. When the socket is full, the rest is written once the reactor reports it writable again.
+    /// Crossing the "HighWatermark" and "LowWatermark" properties (in queued bytes) pushes a SendQueueHighWatermarkEvent and SendQueueLowWatermarkEvent respectively.
+    /// The optional "SendBufferSize" property sets SO_SNDBUF, which disables the kernel's automatic tuning of the socket send buffer.
+    /// Outgoing connections only become active once connected. Failed attempts push a RecoverableErrorEvent and are retried up to 5 times, after which an UnrecoverableErrorEvent is pushed.
+    /// Connections for an existing "Socket", such as the ones accepted by TcpHostService, remove themselves once the peer closed the connection and everything queued is sent.
     class TcpConnectionService final : public IConnectionService, public Service<TcpConnectionService> {
     public:
+        static constexpr uint32_t DEFAULT_MIN_RECEIVE_BUFFER_SIZE = 2048;
+        static constexpr uint32_t DEFAULT_MAX_RECEIVE_BUFFER_SIZE = 65536;
+        static constexpr uint64_t DEFAULT_HIGH_WATERMARK = 1024 * 1024;
+        static constexpr uint64_t DEFAULT_LOW_WATERMARK = 256 * 1024;
+        static constexpr uint64_t MAX_IOVECS = 64;
+
         TcpConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng);
-        ~TcpConnectionService() final = default;
+        ~TcpConnectionService() final;
 
         StartBehaviour start() final;
         StartBehaviour stop() final;
 
         void addDependencyInstance(ILogger *logger, IService *isvc);
         void removeDependencyInstance(ILogger *logger, IService *isvc);
+        void addDependencyInstance(IReactor *reactor, IService *isvc);
+        void removeDependencyInstance(IReactor *reactor, IService *isvc);
 
         uint64_t sendAsync(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>&& msg) final;
         void setPriority(uint64_t priority) final;
         uint64_t getPriority() final;
 
     private:
+        struct Message {
+            uint64_t id;
+            std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> data;
+        };
+
+        /// checks the outcome of the connection in progress and starts the service again, either to become active or to retry
+        void onConnected();
+        /// closes the socket of a failed connection attempt and pushes an error event, returns true if it should be tried again
+        bool connectFailed(int error);
+        void onReady(uint32_t ready);
+        void receive(uint32_t ready);
+        /// writes queued messages until the queue is empty or the socket is full
+        void flush();
+        void failQueued();
+        /// (re)registers the socket with the reactor for reading, unless the peer closed, and for writing when the socket is full
+        void setWaitingForWritable(bool waiting);
+        void removeWhenDone();
+
         int _socket;
         int _attempts;
         uint64_t _priority;
         uint64_t _msgIdCounter;
         bool _quit;
+        bool _connecting{};
+        bool _connected{};
+        bool _watching{};
+        bool _readClosed{};
+        bool _accepted{};
+        bool _removing{};
+        bool _waitingForWritable{};
+        bool _aboveHighWatermark{};
+        uint64_t _highWatermark{DEFAULT_HIGH_WATERMARK};
+        uint64_t _lowWatermark{DEFAULT_LOW_WATERMARK};
+        std::pmr::deque<Message> _queued;
+        uint64_t _queuedBytes{}; // not yet sent
+        uint64_t _frontOffset{}; // bytes of the first queued message that are already sent
         ILogger *_logger{nullptr};
-        Timer* _timerManager{nullptr};
+        IReactor *_reactor{nullptr};
+        std::optional<NetworkBufferPool> _buffers{};
     };
 }
\ No newline at end of file
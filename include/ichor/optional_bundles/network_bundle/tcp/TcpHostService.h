@@ -3,7 +3,7 @@
 #include <ichor/optional_bundles/network_bundle/IHostService.h>
 #include <ichor/optional_bundles/logging_bundle/Logger.h>
 #include <ichor/optional_bundles/network_bundle/tcp/TcpConnectionService.h>
-#include <ichor/optional_bundles/timer_bundle/TimerService.h>
+#include <ichor/optional_bundles/network_bundle/IReactor.h>
 
 namespace Ichor {
     struct NewSocketEvent final : public Ichor::Event {
@@ -15,6 +15,9 @@ namespace Ichor {
         static constexpr std::string_view NAME = Ichor::typeName<NewSocketEvent>();
     };
 
+    /// Accepts connections on the listening socket whenever the IReactor of the manager reports it readable and creates a TcpConnectionService for each of them.
+    /// The "Backlog" property sets the length of the accept queue (SOMAXCONN by default).
+    /// To spread connections over multiple managers, create a TcpHostService with the same port and "ReusePort" set to true in each of them. Every host then binds its own socket with SO_REUSEPORT, the kernel balances new connections over them and accepted connections stay on the manager that accepted them.
     class TcpHostService final : public IHostService, public Service<TcpHostService> {
     public:
         TcpHostService(DependencyRegister &reg, Properties props, DependencyManager *mng);
@@ -25,6 +28,8 @@ namespace Ichor {
 
         void addDependencyInstance(ILogger *logger, IService *isvc);
         void removeDependencyInstance(ILogger *logger, IService *isvc);
+        void addDependencyInstance(IReactor *reactor, IService *isvc);
+        void removeDependencyInstance(IReactor *reactor, IService *isvc);
 
         void setPriority(uint64_t priority) final;
         uint64_t getPriority() final;
@@ -32,13 +37,15 @@ namespace Ichor {
         Generator<bool> handleEvent(NewSocketEvent const * const evt);
 
     private:
+        void acceptConnections();
+
         int _socket;
         int _bindFd;
         uint64_t _priority;
         bool _quit;
+        bool _watching{};
         ILogger *_logger{nullptr};
-        Timer* _timerManager{nullptr};
-        std::vector<TcpConnectionService*> _connections;
+        IReactor *_reactor{nullptr};
         EventHandlerRegistration _newSocketEventHandlerRegistration{};
     };
 }
\ No newline at end of file
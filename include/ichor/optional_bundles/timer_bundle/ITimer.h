@@ -15,12 +15,12 @@ namespace Ichor {
         virtual void startTimer() = 0;
         virtual void stopTimer() = 0;
         [[nodiscard]] virtual bool running() const noexcept = 0;
-        virtual void setInterval(uint64_t nanoseconds) noexcept = 0;
+        virtual void setInterval(uint64_t nanoseconds) = 0;
         virtual void setPriority(uint64_t priority) noexcept = 0;
         [[nodiscard]] virtual uint64_t getPriority() const noexcept = 0;
 
         template <typename Dur>
-        void setChronoInterval(Dur duration) noexcept {
+        void setChronoInterval(Dur duration) {
             setInterval(std::chrono::nanoseconds(duration).count());
         }
 
@@ -3,13 +3,15 @@
 #include <ichor/Common.h>
 #include <ichor/Service.h>
 #include <ichor/DependencyManager.h>
+#include <algorithm>
 #include <chrono>
-#include <thread>
 #include <ichor/optional_bundles/timer_bundle/ITimer.h>
 
 namespace Ichor {
 
-    // Rather shoddy implementation, setting the interval does not reset the insertEventLoop function and the sleep_for is sketchy at best.
+    /// Pushes a TimerEvent every interval. All timers of a manager share the timing wheel of that manager, no threads are involved.
+    /// Expiries are absolute, so the timer does not drift. A changed interval moves the pending expiry to the previous expiry plus the new interval, or to as soon as possible if that has already passed.
+    /// startTimer() and stopTimer() have to be called from the thread of the manager, setInterval() and setPriority() can be called from any thread.
     class Timer final : public ITimer, public Service<Timer> {
     public:
         Timer() noexcept = default;
@@ -36,18 +38,17 @@ namespace Ichor {
 
             bool expected = true;
             if(_quit.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
-                _eventInsertionThread = Ichor::make_unique<std::thread>(getMemoryResource(), [this]() { this->insertEventLoop(); });
-#ifdef __linux__
-                pthread_setname_np(_eventInsertionThread->native_handle(), fmt::format("Tmr #{}", getServiceId()).c_str());
-#endif
+                _appliedIntervalNanosec = _intervalNanosec.load(std::memory_order_acquire);
+                auto interval = std::chrono::nanoseconds(std::max<uint64_t>(_appliedIntervalNanosec, 1));
+                _timerHandle = getManager()->addTimer(std::chrono::steady_clock::now() + interval, interval, Ichor::function<void()>{[this]() { this->onExpiry(); }, getMemoryResource()});
             }
         }
 
         void stopTimer() final {
             bool expected = false;
             if(_quit.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-                _eventInsertionThread->join();
-                _eventInsertionThread = nullptr;
+                getManager()->cancelTimer(_timerHandle);
+                _timerHandle = {};
             }
         }
 
@@ -59,8 +60,20 @@ namespace Ichor {
             _fn = std::move(fn);
         }
 
-        void setInterval(uint64_t nanoseconds) noexcept final {
+        void setInterval(uint64_t nanoseconds) final {
             _intervalNanosec.store(nanoseconds, std::memory_order_release);
+
+            if(getManager()->isEventLoopThread()) {
+                applyInterval();
+                return;
+            }
+
+            // the timing wheel can only be used from the thread of the manager, which might have removed this timer by the time the event is handled
+            getManager()->pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), _priority.load(std::memory_order_acquire), [this, serviceId = getServiceId()](DependencyManager *mng) {
+                if(mng->getImplementationNameFor(serviceId).has_value()) {
+                    applyInterval();
+                }
+            });
         }
 
 
@@ -77,25 +90,29 @@ namespace Ichor {
         }
 
     private:
-        void insertEventLoop() {
-            auto now = std::chrono::steady_clock::now();
-            auto next = now + std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
-            while(!_quit.load(std::memory_order_acquire)) {
-                while(now < next && !_quit.load(std::memory_order_acquire)) {
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire)/10));
-                    now = std::chrono::steady_clock::now();
-                }
-                getManager()->pushPrioritisedEvent<TimerEvent>(getServiceId(), _priority.load(std::memory_order_acquire));
+        void onExpiry() {
+            getManager()->pushPrioritisedEvent<TimerEvent>(getServiceId(), _priority.load(std::memory_order_acquire));
+        }
+
+        // only called on the thread of the manager. A stopped timer picks up the interval in startTimer()
+        void applyInterval() noexcept {
+            if(_quit.load(std::memory_order_acquire)) {
+                return;
+            }
 
-                next += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+            auto interval = _intervalNanosec.load(std::memory_order_acquire);
+            if(interval != _appliedIntervalNanosec) {
+                _appliedIntervalNanosec = interval;
+                getManager()->setTimerInterval(_timerHandle, std::chrono::nanoseconds(std::max<uint64_t>(interval, 1)));
             }
         }
 
         std::atomic<uint64_t> _intervalNanosec{};
-        Ichor::unique_ptr<std::thread> _eventInsertionThread{};
+        uint64_t _appliedIntervalNanosec{}; // only used on the thread of the manager
+        TimerHandle _timerHandle{};
         EventHandlerRegistration _timerEventRegistration{};
         std::function<Generator<bool>(TimerEvent const * const)> _fn{};
         std::atomic<bool> _quit{true};
         std::atomic<uint64_t> _priority{INTERNAL_EVENT_PRIORITY};
     };
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <memory_resource>
+#include <array>
 #include <ichor/ConstevalHash.h>
 
 #define DEBUG_DELETER false
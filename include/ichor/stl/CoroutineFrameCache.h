@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace Ichor {
+    struct CoroutineFrameStatistics final {
+        uint64_t allocations; // total amount of frames allocated
+        uint64_t recycled; // allocations served from cached frames, without going to the upstream resource
+        uint64_t live; // frames currently in use
+        uint64_t peakLive; // highest amount of frames in use at the same time
+        uint64_t cached; // frames currently kept around for reuse
+    };
+
+    /// Memory resource for coroutine frames, not thread-safe.
+    /// All frames of the same coroutine have the same size, so freed frames are kept in a free list per frame size and handed out again for the next frame of that size.
+    /// Only MAX_SIZES different frame sizes are cached and at most MAX_CACHED_FRAMES_PER_SIZE frames per size. Other frames and frames larger than MAX_FRAME_SIZE go to the upstream resource directly.
+    /// Cached frames are returned to the upstream resource on destruction.
+    class CoroutineFrameCache final : public std::pmr::memory_resource {
+    public:
+        static constexpr uint64_t MAX_SIZES = 32;
+        static constexpr uint64_t MAX_CACHED_FRAMES_PER_SIZE = 1024;
+        static constexpr std::size_t MAX_FRAME_SIZE = 16384;
+
+        explicit CoroutineFrameCache(std::pmr::memory_resource *upstream) noexcept;
+        ~CoroutineFrameCache() final;
+
+        CoroutineFrameCache(const CoroutineFrameCache&) = delete;
+        CoroutineFrameCache(CoroutineFrameCache&&) = delete;
+        CoroutineFrameCache& operator=(const CoroutineFrameCache&) = delete;
+        CoroutineFrameCache& operator=(CoroutineFrameCache&&) = delete;
+
+        [[nodiscard]] CoroutineFrameStatistics getStatistics() const noexcept;
+
+    private:
+        struct FreeFrame {
+            FreeFrame *next;
+        };
+
+        struct SizeClass {
+            std::size_t size;
+            FreeFrame *head;
+            uint64_t count;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) final;
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) final;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final;
+
+        /// \return nullptr if frames of this size are not cached
+        [[nodiscard]] SizeClass* findSizeClass(std::size_t bytes, std::size_t alignment, bool create) noexcept;
+
+        std::pmr::memory_resource *_upstream;
+        std::array<SizeClass, MAX_SIZES> _sizes{};
+        uint64_t _sizeCount{};
+        uint64_t _lastSizeIdx{}; // most frames are allocated and freed for the same coroutine as the previous one
+        uint64_t _allocations{};
+        uint64_t _recycled{};
+        uint64_t _live{};
+        uint64_t _peakLive{};
+        uint64_t _cached{};
+    };
+}
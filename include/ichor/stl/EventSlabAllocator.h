@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include <ichor/stl/RealtimeMutex.h>
+
+namespace Ichor {
+    struct EventSlabStatistics final {
+        uint64_t blockSize;
+        uint64_t allocations; // total allocations in this size class
+        uint64_t hits; // allocations served from recycled blocks, without going to the upstream resource
+        uint64_t inUse;
+        uint64_t highWaterMark; // highest amount of blocks in use at the same time
+        uint64_t capacity; // amount of blocks obtained from the upstream resource
+    };
+
+    /// Thread-safe memory resource for events that do not fit inline in an EventStackUniquePtr.
+    /// Allocations up to MAX_BLOCK_SIZE bytes are rounded up to a power of two size class. Each size class recycles its blocks through a lock-free free list, so any thread can allocate and deallocate without locking.
+    /// Only when a free list is empty, a new slab (twice the size of the previous one) is allocated from the upstream resource while holding a lock. Slabs are only returned to upstream on destruction.
+    /// Larger or over-aligned allocations are forwarded to the upstream resource directly, which therefore has to be thread-safe.
+    class EventSlabAllocator final : public std::pmr::memory_resource {
+    public:
+        static constexpr uint64_t MIN_BLOCK_SIZE = 64;
+        static constexpr uint64_t MAX_BLOCK_SIZE = 2048;
+        static constexpr uint64_t SIZE_CLASSES = 6; // 64, 128, ..., 2048
+
+        explicit EventSlabAllocator(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) noexcept;
+        ~EventSlabAllocator() final;
+
+        EventSlabAllocator(const EventSlabAllocator&) = delete;
+        EventSlabAllocator(EventSlabAllocator&&) = delete;
+        EventSlabAllocator& operator=(const EventSlabAllocator&) = delete;
+        EventSlabAllocator& operator=(EventSlabAllocator&&) = delete;
+
+        /// Statistics are gathered with relaxed atomics and are therefore only approximate while other threads are allocating
+        [[nodiscard]] std::vector<EventSlabStatistics> getStatistics() const;
+
+    private:
+        // Precedes every block, the payload starts HEADER_SIZE bytes later. next is only used while the block is in the free list.
+        struct BlockHeader {
+            std::atomic<uint32_t> next; // index + 1 of the next free block, 0 if none
+            uint32_t index;
+        };
+        static constexpr uint64_t HEADER_SIZE = 16;
+        static constexpr uint64_t FIRST_SLAB_BLOCKS = 64;
+        static constexpr uint64_t MAX_SLABS = 26; // enough for 2^32 blocks, the maximum index
+
+        struct SizeClass {
+            // lower 32 bits: index + 1 of the first free block, upper 32 bits: ABA tag incremented on every change
+            std::atomic<uint64_t> freeHead{};
+            std::array<std::atomic<std::byte*>, MAX_SLABS> slabs{};
+            uint64_t slabCount{}; // protected by growMutex
+            RealtimeMutex growMutex{};
+
+            std::atomic<uint64_t> allocations{};
+            std::atomic<uint64_t> hits{};
+            std::atomic<uint64_t> inUse{};
+            std::atomic<uint64_t> highWaterMark{};
+            std::atomic<uint64_t> capacity{};
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) final;
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) final;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept final;
+
+        [[nodiscard]] BlockHeader* blockAt(uint64_t sizeClass, uint32_t index) const noexcept;
+        [[nodiscard]] BlockHeader* popFree(uint64_t sizeClass) noexcept;
+        void pushFree(uint64_t sizeClass, BlockHeader *first, BlockHeader *last) noexcept;
+        [[nodiscard]] BlockHeader* grow(uint64_t sizeClass);
+
+        std::pmr::memory_resource *_upstream;
+        std::array<SizeClass, SIZE_CLASSES> _classes{};
+    };
+}
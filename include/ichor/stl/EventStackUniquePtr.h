@@ -1,80 +1,156 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <ichor/Concepts.h>
+#include <ichor/Events.h>
 
 namespace Ichor {
+    /// Owning pointer to an event that stores events of up to INLINE_SIZE bytes inline, without allocating.
+    /// Larger events, or events that cannot be moved without throwing, are allocated with the given memory resource instead.
+    /// Moving an inline event move constructs it into the destination and destroys the source, so pointers to the event are only stable as long as the EventStackUniquePtr is not moved.
     class [[nodiscard]] EventStackUniquePtr final {
     public:
-        EventStackUniquePtr() = default;
+        static constexpr std::size_t INLINE_SIZE = 128;
 
+        template <typename T>
+        static constexpr bool fitsInline = sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>;
+
+        EventStackUniquePtr() noexcept = default;
+
+        /// \param rsrc memory resource used if T does not fit inline
         template<typename T, typename... Args>
         requires Derived<T, Event>
-        static EventStackUniquePtr create(Args &&... args) {
-            static_assert(sizeof(T) <= 128, "size not big enough to hold T");
+        static EventStackUniquePtr create(std::pmr::memory_resource *rsrc, Args &&... args) {
             static_assert(T::TYPE != 0, "type of T cannot be 0");
             EventStackUniquePtr ptr;
-            new(ptr._buffer.data()) T(std::forward<Args>(args)...);
-            ptr._type = T::TYPE;
+            if constexpr (fitsInline<T>) {
+                ptr._ptr = new(ptr._buffer.data()) T(std::forward<Args>(args)...);
+                ptr._ops = &inlineOps<T>;
+            } else {
+                void *mem = rsrc->allocate(sizeof(T), alignof(T));
+                try {
+                    ptr._ptr = new(mem) T(std::forward<Args>(args)...);
+                } catch(...) {
+                    rsrc->deallocate(mem, sizeof(T), alignof(T));
+                    throw;
+                }
+                ptr._ops = &heapOps<T>;
+                ptr.heapResource() = rsrc;
+            }
             return ptr;
         }
 
         EventStackUniquePtr(const EventStackUniquePtr &) = delete;
+        EventStackUniquePtr &operator=(const EventStackUniquePtr &) = delete;
 
         EventStackUniquePtr(EventStackUniquePtr &&other) noexcept {
-            if (!_empty) {
-                reinterpret_cast<Event *>(_buffer.data())->~Event();
-            }
-            _buffer = other._buffer;
-            other._empty = true;
-            _empty = false;
-            _type = other._type;
+            moveFrom(other);
         }
 
-
-        EventStackUniquePtr &operator=(const EventStackUniquePtr &) = delete;
-
         EventStackUniquePtr &operator=(EventStackUniquePtr &&other) noexcept {
-            if (!_empty) {
-                reinterpret_cast<Event *>(_buffer.data())->~Event();
+            if(this != &other) {
+                reset();
+                moveFrom(other);
             }
-            _buffer = other._buffer;
-            other._empty = true;
-            _empty = false;
-            _type = other._type;
             return *this;
         }
 
         ~EventStackUniquePtr() {
-            if (!_empty) {
-                reinterpret_cast<Event *>(_buffer.data())->~Event();
+            reset();
+        }
+
+        void reset() noexcept {
+            if(_ptr != nullptr) {
+                _ops->destroy(_ptr, _ops->relocate == nullptr ? heapResource() : nullptr);
+                _ptr = nullptr;
+                _ops = nullptr;
             }
         }
 
         template<typename T>
         requires Derived<T, Event>
-        [[nodiscard]] T *getT() {
-            if (_empty) {
-                throw std::runtime_error("empty");
-            }
+        [[nodiscard]] T *getT() const noexcept {
+            return static_cast<T *>(_ptr);
+        }
 
-            return reinterpret_cast<T *>(_buffer.data());
+        /// \return pointer to the event, nullptr if empty
+        [[nodiscard]] Event *get() const noexcept {
+            return _ptr;
         }
 
-        [[nodiscard]] Event *get() {
-            if (_empty) {
-                throw std::runtime_error("empty");
-            }
+        [[nodiscard]] Event *operator->() const noexcept {
+            return _ptr;
+        }
 
-            return reinterpret_cast<Event *>(_buffer.data());
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return _ptr != nullptr;
         }
 
         [[nodiscard]] uint64_t getType() const noexcept {
-            return _type;
+            return _ptr == nullptr ? 0 : _ptr->type;
+        }
+
+        /// \return true if the event did not fit inline and was allocated from the memory resource
+        [[nodiscard]] bool isHeapAllocated() const noexcept {
+            return _ptr != nullptr && _ops->relocate == nullptr;
         }
 
     private:
+        struct Ops {
+            // move constructs the event into dst and destroys src. nullptr for heap allocated events, which only move the pointer.
+            Event* (*relocate)(void *dst, Event *src) noexcept;
+            void (*destroy)(Event *evt, std::pmr::memory_resource *rsrc) noexcept;
+        };
+
+        template <typename T>
+        static constexpr Ops inlineOps{
+            [](void *dst, Event *src) noexcept -> Event* {
+                auto *srcT = static_cast<T *>(src);
+                Event *ret = new(dst) T(std::move(*srcT));
+                srcT->~T();
+                return ret;
+            },
+            [](Event *evt, std::pmr::memory_resource *) noexcept {
+                static_cast<T *>(evt)->~T();
+            }
+        };
+
+        template <typename T>
+        static constexpr Ops heapOps{
+            nullptr,
+            [](Event *evt, std::pmr::memory_resource *rsrc) noexcept {
+                auto *t = static_cast<T *>(evt);
+                t->~T();
+                rsrc->deallocate(t, sizeof(T), alignof(T));
+            }
+        };
+
+        void moveFrom(EventStackUniquePtr &other) noexcept {
+            if(other._ptr == nullptr) {
+                return;
+            }
+
+            if(other._ops->relocate != nullptr) {
+                _ptr = other._ops->relocate(_buffer.data(), other._ptr);
+            } else {
+                _ptr = other._ptr;
+                heapResource() = other.heapResource();
+            }
+            _ops = other._ops;
+            other._ptr = nullptr;
+            other._ops = nullptr;
+        }
+
+        // heap allocated events do not use the inline buffer, so it holds the memory resource to deallocate with instead
+        [[nodiscard]] std::pmr::memory_resource*& heapResource() noexcept {
+            return *reinterpret_cast<std::pmr::memory_resource**>(_buffer.data());
+        }
 
-        std::array<uint8_t, 128> _buffer;
-        uint64_t _type{0};
-        bool _empty{true};
+        alignas(std::max_align_t) std::array<std::byte, INLINE_SIZE> _buffer;
+        Event *_ptr{nullptr};
+        Ops const *_ops{nullptr};
     };
-}
\ No newline at end of file
+}
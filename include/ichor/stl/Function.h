@@ -42,6 +42,7 @@ namespace Ichor {
         std::unique_ptr<callable_base, Deleter> _callable;
 
     public:
+        function() noexcept = default;
 
         template<typename T>
         function(T&& t, std::pmr::memory_resource *rsrc) : _callable(new (rsrc->allocate(sizeof(callable<std::decay_t<T>>))) callable<std::decay_t<T>> (std::forward<T>(t)), Deleter{InternalDeleter<callable<std::decay_t<T>>>{rsrc}}) { }
@@ -54,5 +55,10 @@ namespace Ichor {
         ReturnValue operator()(Args... args) const {
             return _callable->invoke(args...);
         }
+
+        /// \return false if default constructed or moved from
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return _callable != nullptr;
+        }
     };
 }
\ No newline at end of file
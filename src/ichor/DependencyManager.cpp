@@ -2,18 +2,81 @@
 #include <ichor/CommunicationChannel.h>
 #include <ichor/stl/Any.h>
 #include <ichor/GetThreadLocalMemoryResource.h>
+#include <ichor/event_queues/MultimapEventQueue.h>
+#include <ichor/event_queues/MpscEventQueue.h>
+#include <ichor/event_queues/BucketEventQueue.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
 
 std::atomic<bool> sigintQuit;
 std::atomic<uint64_t> Ichor::DependencyManager::_managerIdCounter = 0;
 
+#ifdef __linux__
+// shared by all managers and never read, so it stays readable and wakes up every sleeping event loop once SIGINT has been received
+std::atomic<int> sigintFd{-1};
+
+static int getSigintFd() {
+    static int fd = [] {
+        int ret = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(ret < 0) {
+            throw std::runtime_error("Couldn't create eventfd for SIGINT");
+        }
+        sigintFd.store(ret, std::memory_order_release);
+        return ret;
+    }();
+    return fd;
+}
+#endif
+
+namespace {
+    /// Timer function of scheduleAt() and scheduleEvery(), queues the scheduled function as an event
+    struct ScheduledFunction final {
+        void operator()() const {
+            if(once) {
+                // runs only once, so the function can be moved into the event
+                dm->pushPrioritisedEvent<Ichor::RunFunctionEvent>(0, priority, std::move(fn));
+            } else {
+                dm->pushPrioritisedEvent<Ichor::RunFunctionEvent>(0, priority, fn);
+            }
+        }
+
+        Ichor::DependencyManager *dm;
+        uint64_t priority;
+        mutable std::function<void(Ichor::DependencyManager*)> fn;
+        bool once;
+    };
+}
+
 void on_sigint([[maybe_unused]] int sig) {
     sigintQuit.store(true, std::memory_order_release);
+#ifdef __linux__
+    int fd = sigintFd.load(std::memory_order_acquire);
+    if(fd >= 0) {
+        uint64_t one = 1;
+        [[maybe_unused]] auto ret = ::write(fd, &one, sizeof(one));
+    }
+#endif
 }
 
+Ichor::unique_ptr<Ichor::IEventQueue> Ichor::DependencyManager::createEventQueue(EventQueueType type, std::pmr::memory_resource *rsrc) {
+    switch(type) {
+        case EventQueueType::LOCKED_MULTIMAP:
+            return Ichor::make_unique<MultimapEventQueue>(rsrc, rsrc);
+        case EventQueueType::LOCK_FREE_MPSC:
+            return Ichor::make_unique<MpscEventQueue>(rsrc, rsrc);
+        case EventQueueType::PRIORITY_BUCKETS:
+            return Ichor::make_unique<BucketEventQueue>(rsrc, rsrc);
+    }
+
+    throw std::runtime_error("Unknown event queue type");
+}
 
 
 void Ichor::DependencyManager::start() {
     setThreadLocalMemoryResource(_memResource);
+    setThreadLocalFrameResource(&_frameCache);
 
     if(_logger == nullptr) {
         throw std::runtime_error("Trying to start without a framework logger");
@@ -25,10 +88,15 @@ void Ichor::DependencyManager::start() {
 
     ICHOR_LOG_DEBUG(_logger, "starting dm {}", _id);
 
+#ifdef __linux__
+    _notifier.addWakeupFd(getSigintFd());
+#endif
     ::signal(SIGINT, on_sigint);
 
-    ICHOR_LOG_TRACE(_logger, "depman {} has {} events", _id, _eventQueue.size());
+    ICHOR_LOG_TRACE(_logger, "depman {} has {} events", _id, _eventQueue->size());
 
+    _eventBatch.reserve(_eventBatchSize);
+    _eventLoopThreadId.store(std::this_thread::get_id(), std::memory_order_release);
     _started = true;
 
 #ifdef __linux__
@@ -36,392 +104,657 @@ void Ichor::DependencyManager::start() {
 #endif
 
     while(!_quit.load(std::memory_order_acquire)) {
-        _quit.store(sigintQuit.load(std::memory_order_acquire), std::memory_order_release);
-        std::shared_lock lck(_eventQueueMutex);
-        while (!_quit.load(std::memory_order_acquire) && !_eventQueue.empty()) {
-            TSAN_ANNOTATE_HAPPENS_AFTER((void*)&(*_eventQueue.begin()));
-            auto evtNode = _eventQueue.extract(_eventQueue.begin());
-            lck.unlock();
-            _quit.store(sigintQuit.load(std::memory_order_acquire), std::memory_order_release);
-
-//            ICHOR_LOG_ERROR(_logger, "evt id {} type {} has {}-{} prio", evtNode.mapped().get()->id, evtNode.mapped().get()->name, evtNode.key(), evtNode.mapped().get()->priority);
-
-            bool allowProcessing = true;
-            uint32_t handlerAmount = 1; // for the non-default case below, the DepMan handles the event
-            auto interceptorsForAllEvents = _eventInterceptors.find(0);
-            auto interceptorsForEvent = _eventInterceptors.find(evtNode.mapped()->type);
-
-            if(interceptorsForAllEvents != end(_eventInterceptors)) {
-                for(EventInterceptInfo &info : interceptorsForAllEvents->second) {
-                    if(!info.preIntercept(evtNode.mapped().get())) {
-                        allowProcessing = false;
-                    }
+        while(true) {
+            if(sigintQuit.load(std::memory_order_acquire)) {
+                _quit.store(true, std::memory_order_release);
+            }
+            if(_quit.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            if(!_timers.empty()) {
+                _timers.expire(std::chrono::steady_clock::now());
+            }
+
+            if(!_ioSources.empty()) {
+                pollIoSources();
+            }
+
+            _eventQueue->popEvents(_eventBatch, _eventBatchSize);
+            if(_eventBatch.empty()) {
+                if(_continuations.empty()) {
+                    break;
                 }
+
+                resumeContinuations(std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max());
+                continue;
             }
 
-            if(interceptorsForEvent != end(_eventInterceptors)) {
-                for(EventInterceptInfo &info : interceptorsForEvent->second) {
-                    if(!info.preIntercept(evtNode.mapped().get())) {
-                        allowProcessing = false;
-                    }
+            if(_earliestDeadlineFirst) {
+                // the batch is ordered by priority already, a stable sort keeps the insertion order of events with the same deadline
+                std::stable_sort(_eventBatch.begin(), _eventBatch.end(), [](EventStackUniquePtr const &a, EventStackUniquePtr const &b) {
+                    return a->priority < b->priority || (a->priority == b->priority && a->deadline < b->deadline);
+                });
+            }
+
+            for(auto &evt : _eventBatch) {
+                // events that arrived after the batch was taken out of the queue still get to go first if they have a higher priority
+                while(_eventQueue->peekHighestPriority() < evt->priority && !_quit.load(std::memory_order_relaxed)) {
+                    auto higherPriorityEvt = _eventQueue->popEvent();
+                    processEvent(higherPriorityEvt.get());
                 }
+
+                if(_quit.load(std::memory_order_relaxed)) {
+                    break;
+                }
+
+                processEvent(evt.get());
             }
 
-            if(allowProcessing) {
-                switch (evtNode.mapped()->type) {
-                    case DependencyOnlineEvent::TYPE: {
-                        INTERNAL_DEBUG("DependencyOnlineEvent");
-                        auto depOnlineEvt = static_cast<DependencyOnlineEvent *>(evtNode.mapped().get());
-                        auto managerIt = _services.find(depOnlineEvt->originatingService);
+            _eventBatch.clear();
+        }
+
+        _emptyQueue.store(true, std::memory_order_release);
+        _wakeUp.notify_all();
 
-                        if(managerIt == end(_services)) {
-                            break;
-                        }
+        if(!_quit.load(std::memory_order_acquire)) {
+            waitForEvents();
+        }
+    }
 
-                        auto &manager = managerIt->second;
+    for(auto const &manager : _services.managers()) {
+        manager->stop();
+    }
 
-                        if(!manager->setInjected()) {
-                            INTERNAL_DEBUG("Couldn't set injected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
-                            break;
-                        }
+    _continuations.clear();
+    destroyEventAwaiters();
+    _servicesProvidingInterface.clear();
+    _servicesRequestingInterface.clear();
+    _services.clear();
+    _timers.clear();
+#ifdef __linux__
+    for(auto const &source : _ioSources) {
+        _notifier.removeWakeupFd(source.fd);
+    }
+#endif
+    _ioSources.clear();
+    _eventQueue->clear();
 
-                        auto const filterProp = manager->getProperties().find("Filter");
-                        const Filter *filter = nullptr;
-                        if (filterProp != cend(manager->getProperties())) {
-                            filter = Ichor::any_cast<Filter * const>(&filterProp->second);
-                        }
+    if(_communicationChannel != nullptr) {
+        _communicationChannel->removeManager(this);
+    }
 
-                        for (auto const &[key, possibleDependentLifecycleManager] : _services) {
-                            if (filter != nullptr && !filter->compareTo(possibleDependentLifecycleManager)) {
-                                continue;
-                            }
+    _started = false;
+}
 
-                            if(possibleDependentLifecycleManager->dependencyOnline(manager.get())) {
-                                pushEventInternal<StartServiceEvent>(depOnlineEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, possibleDependentLifecycleManager->serviceId());
-                            }
-                        }
-                    }
-                        break;
-                    case DependencyOfflineEvent::TYPE: {
-                        INTERNAL_DEBUG("DependencyOfflineEvent");
-                        auto depOfflineEvt = static_cast<DependencyOfflineEvent *>(evtNode.mapped().get());
-                        auto managerIt = _services.find(depOfflineEvt->originatingService);
-
-                        if(managerIt == end(_services)) {
-                            break;
-                        }
-
-                        auto &manager = managerIt->second;
-
-                        if(!manager->setUninjected()) {
-                            INTERNAL_DEBUG("Couldn't set uninjected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
-                            break;
-                        }
-
-                        auto const filterProp = manager->getProperties().find("Filter");
-                        const Filter *filter = nullptr;
-                        if (filterProp != cend(manager->getProperties())) {
-                            filter = Ichor::any_cast<Filter * const>(&filterProp->second);
-                        }
-
-                        for (auto const &[key, possibleDependentLifecycleManager] : _services) {
-                            if (filter != nullptr && !filter->compareTo(possibleDependentLifecycleManager)) {
-                                continue;
-                            }
-
-                            if(possibleDependentLifecycleManager->dependencyOffline(manager.get())) {
-                                pushEventInternal<StopServiceEvent>(depOfflineEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, possibleDependentLifecycleManager->serviceId());
-                            }
-                        }
-                    }
-                        break;
-                    case DependencyRequestEvent::TYPE: {
-                        auto depReqEvt = static_cast<DependencyRequestEvent *>(evtNode.mapped().get());
-
-                        auto trackers = _dependencyRequestTrackers.find(depReqEvt->dependency.interfaceNameHash);
-                        if (trackers == end(_dependencyRequestTrackers)) {
-                            break;
-                        }
-
-                        for (DependencyTrackerInfo &info : trackers->second) {
-                            info.trackFunc(depReqEvt);
-                        }
-                    }
-                        break;
-                    case DependencyUndoRequestEvent::TYPE: {
-                        auto depUndoReqEvt = static_cast<DependencyUndoRequestEvent *>(evtNode.mapped().get());
-
-                        auto trackers = _dependencyUndoRequestTrackers.find(depUndoReqEvt->dependency.interfaceNameHash);
-                        if (trackers == end(_dependencyUndoRequestTrackers)) {
-                            break;
-                        }
-
-                        for (DependencyTrackerInfo &info : trackers->second) {
-                            info.trackFunc(depUndoReqEvt);
-                        }
-                    }
-                        break;
-                    case QuitEvent::TYPE: {
-                        INTERNAL_DEBUG("QuitEvent");
-                        auto _quitEvt = static_cast<QuitEvent *>(evtNode.mapped().get());
-                        if (!_quitEvt->dependenciesStopped) {
-                            for (auto const &[key, possibleManager] : _services) {
-                                if (possibleManager->getServiceState() != ServiceState::INSTALLED) {
-                                    pushEventInternal<StopServiceEvent>(_quitEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
-                                                                        possibleManager->serviceId());
-                                }
-                            }
-
-                            pushEventInternal<QuitEvent>(_quitEvt->originatingService, INTERNAL_EVENT_PRIORITY + 1, true);
-                        } else {
-                            bool canFinally_quit = true;
-                            for (auto const &[key, manager] : _services) {
-                                if (manager->getServiceState() != ServiceState::INSTALLED) {
-                                    canFinally_quit = false;
-                                    INTERNAL_DEBUG("couldn't quit: service {}-{} is in state {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
-                                }
-                            }
-
-                            if (canFinally_quit) {
-                                _quit.store(true, std::memory_order_release);
-                            } else {
-                                pushEventInternal<QuitEvent>(_quitEvt->originatingService, INTERNAL_EVENT_PRIORITY + 1, false);
-                            }
-                        }
-                    }
-                        break;
-                    case StopServiceEvent::TYPE: {
-                        INTERNAL_DEBUG("StopServiceEvent");
-                        auto stopServiceEvt = static_cast<StopServiceEvent *>(evtNode.mapped().get());
-
-                        auto toStopServiceIt = _services.find(stopServiceEvt->serviceId);
-
-                        if (toStopServiceIt == end(_services)) {
-                            ICHOR_LOG_ERROR(_logger, "Couldn't stop service {}, missing from known services", stopServiceEvt->serviceId);
-                            handleEventError(stopServiceEvt);
-                            break;
-                        }
-
-                        auto &toStopService = toStopServiceIt->second;
-                        if (stopServiceEvt->dependenciesStopped) {
-                            auto ret = toStopService->stop();
-                            if (toStopService->getServiceState() != ServiceState::INSTALLED && ret != StartBehaviour::SUCCEEDED) {
-                                ICHOR_LOG_ERROR(_logger, "Couldn't stop service {}: {} but all dependencies stopped", stopServiceEvt->serviceId,
-                                          toStopService->implementationName());
-                                handleEventError(stopServiceEvt);
-                                if(ret == StartBehaviour::FAILED_AND_RETRY) {
-                                    pushEventInternal<StopServiceEvent>(stopServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, stopServiceEvt->serviceId, true);
-                                }
-                            } else {
-                                handleEventCompletion(stopServiceEvt);
-                            }
-                        } else {
-                            pushEventInternal<DependencyOfflineEvent>(toStopService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
-                            pushEventInternal<StopServiceEvent>(stopServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, stopServiceEvt->serviceId, true);
-                        }
-                    }
-                        break;
-                    case RemoveServiceEvent::TYPE: {
-                        INTERNAL_DEBUG("RemoveServiceEvent");
-                        auto removeServiceEvt = static_cast<RemoveServiceEvent *>(evtNode.mapped().get());
-
-                        auto toRemoveServiceIt = _services.find(removeServiceEvt->serviceId);
-
-                        if (toRemoveServiceIt == end(_services)) {
-                            ICHOR_LOG_ERROR(_logger, "Couldn't remove service {}, missing from known services", removeServiceEvt->serviceId);
-                            handleEventError(removeServiceEvt);
-                            break;
-                        }
-
-                        auto &toRemoveService = toRemoveServiceIt->second;
-                        if (removeServiceEvt->dependenciesStopped) {
-                            auto ret = toRemoveService->stop();
-                            if (toRemoveService->getServiceState() == ServiceState::ACTIVE && ret != StartBehaviour::SUCCEEDED) {
-                                ICHOR_LOG_ERROR(_logger, "Couldn't remove service {}: {} but all dependencies stopped", removeServiceEvt->serviceId,
-                                          toRemoveService->implementationName());
-                                handleEventError(removeServiceEvt);
-                                if(ret == StartBehaviour::FAILED_AND_RETRY) {
-                                    pushEventInternal<RemoveServiceEvent>(removeServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, removeServiceEvt->serviceId,
-                                                                          true);
-                                }
-                            } else {
-                                handleEventCompletion(removeServiceEvt);
-                                _services.erase(toRemoveServiceIt);
-                            }
-                        } else {
-                            pushEventInternal<DependencyOfflineEvent>(toRemoveService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
-                            pushEventInternal<RemoveServiceEvent>(removeServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, removeServiceEvt->serviceId,
-                                                                  true);
-                        }
-                    }
-                        break;
-                    case StartServiceEvent::TYPE: {
-                        INTERNAL_DEBUG("StartServiceEvent");
-                        auto startServiceEvt = static_cast<StartServiceEvent *>(evtNode.mapped().get());
-
-                        auto toStartServiceIt = _services.find(startServiceEvt->serviceId);
-
-                        if (toStartServiceIt == end(_services)) {
-                            ICHOR_LOG_ERROR(_logger, "Couldn't start service {}, missing from known services", startServiceEvt->serviceId);
-                            handleEventError(startServiceEvt);
-                            break;
-                        }
-
-                        auto &toStartService = toStartServiceIt->second;
-                        if (toStartService->getServiceState() == ServiceState::ACTIVE) {
-                            handleEventCompletion(startServiceEvt);
-                        } else {
-                            auto ret = toStartService->start();
-                            if (ret == StartBehaviour::SUCCEEDED) {
-                                pushEventInternal<DependencyOnlineEvent>(toStartService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
-                                handleEventCompletion(startServiceEvt);
-                            } else {
-                                INTERNAL_DEBUG("Couldn't start service {}: {}", startServiceEvt->serviceId, toStartService->implementationName());
-                                handleEventError(startServiceEvt);
-                                if(ret == StartBehaviour::FAILED_AND_RETRY) {
-                                    pushEventInternal<StartServiceEvent>(startServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, startServiceEvt->serviceId);
-                                }
-                            }
-                        }
-                    }
-                        break;
-                    case DoWorkEvent::TYPE: {
-                        INTERNAL_DEBUG("DoWorkEvent");
-                        handleEventCompletion(evtNode.mapped().get());
-                    }
-                        break;
-                    case RemoveCompletionCallbacksEvent::TYPE: {
-                        INTERNAL_DEBUG("RemoveCompletionCallbacksEvent");
-                        auto removeCallbacksEvt = static_cast<RemoveCompletionCallbacksEvent *>(evtNode.mapped().get());
+Ichor::TimerHandle Ichor::DependencyManager::scheduleAt(std::chrono::steady_clock::time_point expiry, uint64_t priority, std::function<void(DependencyManager*)> fn) {
+    return _timers.add(expiry, {}, Ichor::function<void()>{ScheduledFunction{this, priority, std::move(fn), true}, _memResource});
+}
 
-                        _completionCallbacks.erase(removeCallbacksEvt->key);
-                        _errorCallbacks.erase(removeCallbacksEvt->key);
-                    }
-                        break;
-                    case RemoveEventHandlerEvent::TYPE: {
-                        INTERNAL_DEBUG("RemoveEventHandlerEvent");
-                        auto removeEventHandlerEvt = static_cast<RemoveEventHandlerEvent *>(evtNode.mapped().get());
-
-                        // key.id = service id, key.type == event id
-                        auto existingHandlers = _eventCallbacks.find(removeEventHandlerEvt->key.type);
-                        if (existingHandlers != end(_eventCallbacks)) {
-                            std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
-                                return info.listeningServiceId == removeEventHandlerEvt->key.id;
-                            });
-                        }
-                    }
-                        break;
-                    case RemoveEventInterceptorEvent::TYPE: {
-                        INTERNAL_DEBUG("RemoveEventInterceptorEvent");
-                        auto removeEventHandlerEvt = static_cast<RemoveEventInterceptorEvent *>(evtNode.mapped().get());
-
-                        // key.id = service id, key.type == event id
-                        auto existingHandlers = _eventInterceptors.find(removeEventHandlerEvt->key.type);
-                        if (existingHandlers != end(_eventInterceptors)) {
-                            std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventInterceptInfo &info) noexcept {
-                                return info.listeningServiceId == removeEventHandlerEvt->key.id;
-                            });
-                        }
-                    }
-                        break;
-                    case RemoveTrackerEvent::TYPE: {
-                        INTERNAL_DEBUG("RemoveTrackerEvent");
-                        auto removeTrackerEvt = static_cast<RemoveTrackerEvent *>(evtNode.mapped().get());
+Ichor::TimerHandle Ichor::DependencyManager::scheduleEvery(std::chrono::nanoseconds interval, uint64_t priority, std::function<void(DependencyManager*)> fn) {
+    if(interval.count() <= 0) {
+        throw std::runtime_error("Interval of a repeating function has to be positive");
+    }
 
-                        _dependencyRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
-                        _dependencyUndoRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
-                    }
-                        break;
-                    case ContinuableEvent<Generator<bool>>::TYPE: {
-                        INTERNAL_DEBUG("ContinuableEvent");
-                        auto continuableEvt = static_cast<ContinuableEvent<Generator<bool>> *>(evtNode.mapped().get());
+    return _timers.add(std::chrono::steady_clock::now() + interval, interval, Ichor::function<void()>{ScheduledFunction{this, priority, std::move(fn), false}, _memResource});
+}
 
-                        auto it = continuableEvt->generator.begin();
+#ifdef __linux__
+uint64_t Ichor::DependencyManager::addIoSource(int fd, Ichor::function<void()> poll) {
+    _notifier.addWakeupFd(fd);
+    auto id = ++_ioSourceIdCounter;
+    _ioSources.push_back(IoSource{id, fd, std::move(poll)});
+    return id;
+}
 
-                        if (it != continuableEvt->generator.end()) {
-                            pushEventInternal<ContinuableEvent<Generator<bool>>>(continuableEvt->originatingService, evtNode.key(), std::move(continuableEvt->generator));
-                        }
-                    }
-                        break;
-                    case RunFunctionEvent::TYPE: {
-                        INTERNAL_DEBUG("RunFunctionEvent");
-                        auto runFunctionEvt = static_cast<RunFunctionEvent *>(evtNode.mapped().get());
-                        runFunctionEvt->fun(this);
-                    }
-                        break;
-                    default: {
-                        INTERNAL_DEBUG("broadcastEvent");
-                        handlerAmount = broadcastEvent(evtNode.mapped().get());
-                    }
-                        break;
+void Ichor::DependencyManager::removeIoSource(uint64_t id) noexcept {
+    auto it = std::find_if(_ioSources.begin(), _ioSources.end(), [id](IoSource const &source) { return source.id == id; });
+    if(it == _ioSources.end()) {
+        return;
+    }
+
+    _notifier.removeWakeupFd(it->fd);
+    _ioSources.erase(it);
+}
+#endif
+
+void Ichor::DependencyManager::pollIoSources() {
+    // polling can add and remove sources, including the one being polled, so the function is moved out while running
+    for(uint64_t i = 0; i < _ioSources.size(); i++) {
+        auto id = _ioSources[i].id;
+        auto poll = std::move(_ioSources[i].poll);
+        poll();
+
+        if(i < _ioSources.size() && _ioSources[i].id == id) {
+            _ioSources[i].poll = std::move(poll);
+        } else {
+            auto it = std::find_if(_ioSources.begin(), _ioSources.end(), [id](IoSource const &source) { return source.id == id; });
+            if(it != _ioSources.end()) {
+                it->poll = std::move(poll);
+            }
+        }
+    }
+}
+
+void Ichor::DependencyManager::waitForEvents() {
+    auto deadline = _timers.nextDeadline();
+
+    if(_idleStrategy != IdleStrategy::BLOCK) {
+        // peekHighestPriority() does not lock, but cannot see events pushed with the lowest possible priority, so check empty() every now and then
+        uint64_t spins{};
+        while((_idleStrategy == IdleStrategy::BUSY_POLL || spins < _spinIterations) && !sigintQuit.load(std::memory_order_relaxed)) {
+            if((spins & 1023) == 1023 && !_ioSources.empty()) {
+                pollIoSources();
+            }
+            if(_eventQueue->peekHighestPriority() != std::numeric_limits<uint64_t>::max() || ((spins & 1023) == 1023 && (!_eventQueue->empty() || std::chrono::steady_clock::now() >= deadline))) {
+                return;
+            }
+            cpuRelax();
+            spins++;
+        }
+    }
+
+    // sleep until an event is pushed from another thread or the first timer expires
+    if(deadline != std::chrono::steady_clock::time_point::max() && deadline <= std::chrono::steady_clock::now()) {
+        return;
+    }
+    _notifier.wait([this] { return !_eventQueue->empty() || sigintQuit.load(std::memory_order_acquire); }, deadline);
+}
+
+void Ichor::DependencyManager::addToServiceIndices(ILifecycleManager *manager) {
+    for(auto const &interface : manager->getInterfaces()) {
+        _servicesProvidingInterface[interface.interfaceNameHash].push_back(manager);
+    }
+
+    auto const *registry = manager->getDependencyRegistry();
+    if(registry != nullptr) {
+        for(auto const &[interfaceNameHash, registration] : registry->_registrations) {
+            _servicesRequestingInterface[interfaceNameHash].push_back(manager);
+        }
+    }
+}
+
+void Ichor::DependencyManager::removeFromServiceIndices(ILifecycleManager *manager) {
+    auto remove = [manager](std::pmr::unordered_map<uint64_t, std::pmr::vector<ILifecycleManager*>> &index, uint64_t interfaceNameHash) {
+        auto it = index.find(interfaceNameHash);
+        if(it == index.end()) {
+            return;
+        }
+
+        auto &managers = it->second;
+        auto pos = std::find(managers.begin(), managers.end(), manager);
+        if(pos != managers.end()) {
+            managers.erase(pos);
+        }
+        if(managers.empty()) {
+            index.erase(it);
+        }
+    };
+
+    for(auto const &interface : manager->getInterfaces()) {
+        remove(_servicesProvidingInterface, interface.interfaceNameHash);
+    }
+
+    auto const *registry = manager->getDependencyRegistry();
+    if(registry != nullptr) {
+        for(auto const &[interfaceNameHash, registration] : registry->_registrations) {
+            remove(_servicesRequestingInterface, interfaceNameHash);
+        }
+    }
+}
+
+void Ichor::DependencyManager::collectDependentServices(ILifecycleManager *manager, Filter const *filter, std::pmr::vector<ILifecycleManager*> &dependents) const {
+    // filters restricted to a single service (e.g. per-service loggers) do not need to look at every other requesting service
+    if(filter != nullptr) {
+        auto serviceId = filter->getServiceId();
+        if(serviceId) {
+            auto *dependent = _services.find(*serviceId);
+            if(dependent != nullptr) {
+                dependents.push_back(dependent);
+            }
+            return;
+        }
+    }
+
+    // copy, because handling dependencies can create new services, which modifies the index
+    auto const &interfaces = manager->getInterfaces();
+    for(auto const &interface : interfaces) {
+        appendIndexedServices(_servicesRequestingInterface, interface.interfaceNameHash, dependents);
+    }
+    if(interfaces.size() > 1) {
+        removeDuplicates(dependents);
+    }
+}
+
+void Ichor::DependencyManager::processEvent(Event *evt) {
+//    ICHOR_LOG_ERROR(_logger, "evt id {} type {} has {} prio", evt->id, evt->name, evt->priority);
+
+    // handlers that yielded before this event was pushed go first, as if they were still in the event queue
+    if(!_continuations.empty()) {
+        resumeContinuations(evt->priority, evt->id);
+    }
+
+    if(evt->deadline != std::chrono::steady_clock::time_point::max() && evt->deadline < std::chrono::steady_clock::now()) {
+        handleMissedDeadline(evt);
+        return;
+    }
+
+    // most managers do not have any interceptors at all
+    if(_eventInterceptorCount == 0) {
+        dispatchEvent(evt);
+        if(_eventAwaiterCount != 0) {
+            resumeEventAwaiters(evt);
+        }
+        return;
+    }
+
+    bool allowProcessing = true;
+    uint32_t handlerAmount = 0;
+    auto typeIndex = evt->typeIndex;
+    // processing the event can register interceptors for new event types, which reallocates _eventInterceptors. Only keep indices around.
+    bool interceptAllEvents = !_globalEventInterceptors.empty();
+    bool interceptEvent = typeIndex < _eventInterceptors.size() && !_eventInterceptors[typeIndex].empty();
+
+    if(interceptAllEvents) {
+        for(EventInterceptInfo &info : _globalEventInterceptors) {
+            if(!info.preIntercept(evt)) {
+                allowProcessing = false;
+            }
+        }
+    }
+
+    if(interceptEvent) {
+        for(EventInterceptInfo &info : _eventInterceptors[typeIndex]) {
+            if(!info.preIntercept(evt)) {
+                allowProcessing = false;
+            }
+        }
+    }
+
+    if(allowProcessing) {
+        handlerAmount = dispatchEvent(evt);
+    }
+
+    if(interceptAllEvents) {
+        for(EventInterceptInfo &info : _globalEventInterceptors) {
+            info.postIntercept(evt, allowProcessing && handlerAmount > 0);
+        }
+    }
+
+    if(interceptEvent) {
+        for(EventInterceptInfo &info : _eventInterceptors[typeIndex]) {
+            info.postIntercept(evt, allowProcessing && handlerAmount > 0);
+        }
+    }
+
+    if(_eventAwaiterCount != 0) {
+        resumeEventAwaiters(evt);
+    }
+}
+
+uint32_t Ichor::DependencyManager::dispatchEvent(Event *evt) {
+    uint32_t handlerAmount = 1; // for the non-default case below, the DepMan handles the event
+
+    // built-in events have consecutive type indices, allowing the compiler to use a jump table
+    switch (evt->typeIndex) {
+        case builtinEventTypeIndex<DependencyOnlineEvent>: {
+            INTERNAL_DEBUG("DependencyOnlineEvent");
+            auto depOnlineEvt = static_cast<DependencyOnlineEvent *>(evt);
+            auto *manager = _services.find(depOnlineEvt->originatingService);
+
+            if(manager == nullptr) {
+                break;
+            }
+
+            bool changed = manager->setInjected();
+            _services.updateState(*manager);
+            if(!changed) {
+                INTERNAL_DEBUG("Couldn't set injected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
+                break;
+            }
+
+            auto const filterProp = manager->getProperties().find("Filter");
+            const Filter *filter = nullptr;
+            if (filterProp != cend(manager->getProperties())) {
+                filter = Ichor::any_cast<Filter * const>(&filterProp->second);
+            }
+
+            std::pmr::vector<ILifecycleManager*> dependents{_memResource};
+            collectDependentServices(manager, filter, dependents);
+
+            for (auto *possibleDependentLifecycleManager : dependents) {
+                if (filter != nullptr && !filter->compareTo(*_services.findShared(possibleDependentLifecycleManager->serviceId()))) {
+                    continue;
                 }
+
+                if(possibleDependentLifecycleManager->dependencyOnline(manager)) {
+                    pushEventInternal<StartServiceEvent>(depOnlineEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, possibleDependentLifecycleManager->serviceId());
+                }
+            }
+        }
+            break;
+        case builtinEventTypeIndex<DependencyOfflineEvent>: {
+            INTERNAL_DEBUG("DependencyOfflineEvent");
+            auto depOfflineEvt = static_cast<DependencyOfflineEvent *>(evt);
+            auto *manager = _services.find(depOfflineEvt->originatingService);
+
+            if(manager == nullptr) {
+                break;
+            }
+
+            bool changed = manager->setUninjected();
+            _services.updateState(*manager);
+            if(!changed) {
+                INTERNAL_DEBUG("Couldn't set uninjected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
+                break;
+            }
+
+            auto const filterProp = manager->getProperties().find("Filter");
+            const Filter *filter = nullptr;
+            if (filterProp != cend(manager->getProperties())) {
+                filter = Ichor::any_cast<Filter * const>(&filterProp->second);
             }
 
-            if(interceptorsForAllEvents != end(_eventInterceptors)) {
-                for(EventInterceptInfo &info : interceptorsForAllEvents->second) {
-                    info.postIntercept(evtNode.mapped().get(), allowProcessing && handlerAmount > 0);
+            std::pmr::vector<ILifecycleManager*> dependents{_memResource};
+            collectDependentServices(manager, filter, dependents);
+
+            for (auto *possibleDependentLifecycleManager : dependents) {
+                if (filter != nullptr && !filter->compareTo(*_services.findShared(possibleDependentLifecycleManager->serviceId()))) {
+                    continue;
+                }
+
+                if(possibleDependentLifecycleManager->dependencyOffline(manager)) {
+                    pushEventInternal<StopServiceEvent>(depOfflineEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, possibleDependentLifecycleManager->serviceId());
                 }
             }
+        }
+            break;
+        case builtinEventTypeIndex<DependencyRequestEvent>: {
+            auto depReqEvt = static_cast<DependencyRequestEvent *>(evt);
+
+            auto trackers = _dependencyRequestTrackers.find(depReqEvt->dependency.interfaceNameHash);
+            if (trackers == end(_dependencyRequestTrackers)) {
+                break;
+            }
+
+            for (DependencyTrackerInfo &info : trackers->second) {
+                info.trackFunc(depReqEvt);
+            }
+        }
+            break;
+        case builtinEventTypeIndex<DependencyUndoRequestEvent>: {
+            auto depUndoReqEvt = static_cast<DependencyUndoRequestEvent *>(evt);
+
+            auto trackers = _dependencyUndoRequestTrackers.find(depUndoReqEvt->dependency.interfaceNameHash);
+            if (trackers == end(_dependencyUndoRequestTrackers)) {
+                break;
+            }
+
+            for (DependencyTrackerInfo &info : trackers->second) {
+                info.trackFunc(depUndoReqEvt);
+            }
+        }
+            break;
+        case builtinEventTypeIndex<QuitEvent>: {
+            INTERNAL_DEBUG("QuitEvent");
+            auto _quitEvt = static_cast<QuitEvent *>(evt);
+            if (!_quitEvt->dependenciesStopped) {
+                auto managers = _services.managers();
+                auto states = _services.states();
+                for (uint64_t i = 0; i < managers.size(); i++) {
+                    if (states[i] != ServiceState::INSTALLED) {
+                        pushEventInternal<StopServiceEvent>(_quitEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
+                                                            managers[i]->serviceId());
+                    }
+                }
 
-            if(interceptorsForEvent != end(_eventInterceptors)) {
-                for(EventInterceptInfo &info : interceptorsForEvent->second) {
-                    info.postIntercept(evtNode.mapped().get(), allowProcessing && handlerAmount > 0);
+                pushEventInternal<QuitEvent>(_quitEvt->originatingService, INTERNAL_EVENT_PRIORITY + 1, true);
+            } else {
+                bool canFinally_quit = true;
+                auto managers = _services.managers();
+                auto states = _services.states();
+                for (uint64_t i = 0; i < managers.size(); i++) {
+                    if (states[i] != ServiceState::INSTALLED) {
+                        canFinally_quit = false;
+                        INTERNAL_DEBUG("couldn't quit: service {}-{} is in state {}", managers[i]->serviceId(), managers[i]->implementationName(), states[i]);
+                    }
                 }
+
+                if (canFinally_quit) {
+                    _quit.store(true, std::memory_order_release);
+                } else {
+                    pushEventInternal<QuitEvent>(_quitEvt->originatingService, INTERNAL_EVENT_PRIORITY + 1, false);
+                }
+            }
+        }
+            break;
+        case builtinEventTypeIndex<StopServiceEvent>: {
+            INTERNAL_DEBUG("StopServiceEvent");
+            auto stopServiceEvt = static_cast<StopServiceEvent *>(evt);
+
+            auto *toStopService = _services.find(stopServiceEvt->serviceId);
+
+            if (toStopService == nullptr) {
+                ICHOR_LOG_ERROR(_logger, "Couldn't stop service {}, missing from known services", stopServiceEvt->serviceId);
+                handleEventError(stopServiceEvt);
+                break;
             }
 
-            lck.lock();
+            if (stopServiceEvt->dependenciesStopped) {
+                auto ret = toStopService->stop();
+                _services.updateState(*toStopService);
+                if (toStopService->getServiceState() != ServiceState::INSTALLED && ret != StartBehaviour::SUCCEEDED) {
+                    ICHOR_LOG_ERROR(_logger, "Couldn't stop service {}: {} but all dependencies stopped", stopServiceEvt->serviceId,
+                              toStopService->implementationName());
+                    handleEventError(stopServiceEvt);
+                    if(ret == StartBehaviour::FAILED_AND_RETRY) {
+                        pushEventInternal<StopServiceEvent>(stopServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, stopServiceEvt->serviceId, true);
+                    }
+                } else {
+                    destroyEventAwaiters(stopServiceEvt->serviceId);
+                    handleEventCompletion(stopServiceEvt);
+                }
+            } else {
+                pushEventInternal<DependencyOfflineEvent>(toStopService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
+                pushEventInternal<StopServiceEvent>(stopServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, stopServiceEvt->serviceId, true);
+            }
         }
+            break;
+        case builtinEventTypeIndex<RemoveServiceEvent>: {
+            INTERNAL_DEBUG("RemoveServiceEvent");
+            auto removeServiceEvt = static_cast<RemoveServiceEvent *>(evt);
 
-        _emptyQueue.store(true, std::memory_order_release);
+            auto *toRemoveService = _services.find(removeServiceEvt->serviceId);
 
-        if(!_quit.load(std::memory_order_acquire)) {
-            _wakeUp.wait_for(lck, std::chrono::milliseconds(1), [this] { return !_eventQueue.empty(); });
+            if (toRemoveService == nullptr) {
+                ICHOR_LOG_ERROR(_logger, "Couldn't remove service {}, missing from known services", removeServiceEvt->serviceId);
+                handleEventError(removeServiceEvt);
+                break;
+            }
+
+            if (removeServiceEvt->dependenciesStopped) {
+                auto ret = toRemoveService->stop();
+                _services.updateState(*toRemoveService);
+                if (toRemoveService->getServiceState() == ServiceState::ACTIVE && ret != StartBehaviour::SUCCEEDED) {
+                    ICHOR_LOG_ERROR(_logger, "Couldn't remove service {}: {} but all dependencies stopped", removeServiceEvt->serviceId,
+                              toRemoveService->implementationName());
+                    handleEventError(removeServiceEvt);
+                    if(ret == StartBehaviour::FAILED_AND_RETRY) {
+                        pushEventInternal<RemoveServiceEvent>(removeServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, removeServiceEvt->serviceId,
+                                                              true);
+                    }
+                } else {
+                    destroyEventAwaiters(removeServiceEvt->serviceId);
+                    handleEventCompletion(removeServiceEvt);
+                    removeFromServiceIndices(toRemoveService);
+                    _services.erase(removeServiceEvt->serviceId);
+                }
+            } else {
+                pushEventInternal<DependencyOfflineEvent>(toRemoveService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
+                pushEventInternal<RemoveServiceEvent>(removeServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, removeServiceEvt->serviceId,
+                                                      true);
+            }
         }
+            break;
+        case builtinEventTypeIndex<StartServiceEvent>: {
+            INTERNAL_DEBUG("StartServiceEvent");
+            auto startServiceEvt = static_cast<StartServiceEvent *>(evt);
 
-        lck.unlock();
-    }
+            auto *toStartService = _services.find(startServiceEvt->serviceId);
 
-    for(auto &[key, manager] : _services) {
-        manager->stop();
-    }
+            if (toStartService == nullptr) {
+                ICHOR_LOG_ERROR(_logger, "Couldn't start service {}, missing from known services", startServiceEvt->serviceId);
+                handleEventError(startServiceEvt);
+                break;
+            }
 
-    _services.clear();
-    _eventQueue.clear();
+            if (toStartService->getServiceState() == ServiceState::ACTIVE) {
+                handleEventCompletion(startServiceEvt);
+            } else {
+                auto ret = toStartService->start();
+                _services.updateState(*toStartService);
+                if (ret == StartBehaviour::SUCCEEDED) {
+                    pushEventInternal<DependencyOnlineEvent>(toStartService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
+                    handleEventCompletion(startServiceEvt);
+                } else {
+                    INTERNAL_DEBUG("Couldn't start service {}: {}", startServiceEvt->serviceId, toStartService->implementationName());
+                    handleEventError(startServiceEvt);
+                    if(ret == StartBehaviour::FAILED_AND_RETRY) {
+                        pushEventInternal<StartServiceEvent>(startServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, startServiceEvt->serviceId);
+                    }
+                }
+            }
+        }
+            break;
+        case builtinEventTypeIndex<DoWorkEvent>: {
+            INTERNAL_DEBUG("DoWorkEvent");
+            handleEventCompletion(evt);
+        }
+            break;
+        case builtinEventTypeIndex<RemoveCompletionCallbacksEvent>: {
+            INTERNAL_DEBUG("RemoveCompletionCallbacksEvent");
+            auto removeCallbacksEvt = static_cast<RemoveCompletionCallbacksEvent *>(evt);
+
+            // key.id = service id, key.type == event type index
+            if (removeCallbacksEvt->key.type < _completionCallbacks.size()) {
+                _completionCallbacks[removeCallbacksEvt->key.type].erase(removeCallbacksEvt->key.id);
+                _errorCallbacks[removeCallbacksEvt->key.type].erase(removeCallbacksEvt->key.id);
+            }
+        }
+            break;
+        case builtinEventTypeIndex<RemoveEventHandlerEvent>: {
+            INTERNAL_DEBUG("RemoveEventHandlerEvent");
+            auto removeEventHandlerEvt = static_cast<RemoveEventHandlerEvent *>(evt);
+
+            // key.id = service id, key.type == event type index
+            if (removeEventHandlerEvt->key.type < _eventCallbacks.size()) {
+                std::erase_if(_eventCallbacks[removeEventHandlerEvt->key.type], [removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
+                    return info.listeningServiceId == removeEventHandlerEvt->key.id;
+                });
+            }
+        }
+            break;
+        case builtinEventTypeIndex<RemoveEventInterceptorEvent>: {
+            INTERNAL_DEBUG("RemoveEventInterceptorEvent");
+            auto removeEventHandlerEvt = static_cast<RemoveEventInterceptorEvent *>(evt);
+
+            // key.id = service id, key.type == event type index
+            auto isRemovedInterceptor = [removeEventHandlerEvt](const EventInterceptInfo &info) noexcept {
+                return info.listeningServiceId == removeEventHandlerEvt->key.id;
+            };
+            if (removeEventHandlerEvt->key.type == ALL_EVENTS_TYPE_INDEX) {
+                _eventInterceptorCount -= std::erase_if(_globalEventInterceptors, isRemovedInterceptor);
+            } else if (removeEventHandlerEvt->key.type < _eventInterceptors.size()) {
+                _eventInterceptorCount -= std::erase_if(_eventInterceptors[removeEventHandlerEvt->key.type], isRemovedInterceptor);
+            }
+        }
+            break;
+        case builtinEventTypeIndex<RemoveTrackerEvent>: {
+            INTERNAL_DEBUG("RemoveTrackerEvent");
+            auto removeTrackerEvt = static_cast<RemoveTrackerEvent *>(evt);
 
-    if(_communicationChannel != nullptr) {
-        _communicationChannel->removeManager(this);
+            _dependencyRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
+            _dependencyUndoRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
+        }
+            break;
+        case builtinEventTypeIndex<ContinuableEvent<Generator<bool>>>: {
+            INTERNAL_DEBUG("ContinuableEvent");
+            auto continuableEvt = static_cast<ContinuableEvent<Generator<bool>> *>(evt);
+
+            auto it = continuableEvt->generator.begin();
+
+            if (it != continuableEvt->generator.end()) {
+                pushContinuation(evt->priority, std::move(continuableEvt->generator));
+            }
+        }
+            break;
+        case builtinEventTypeIndex<RunFunctionEvent>: {
+            INTERNAL_DEBUG("RunFunctionEvent");
+            auto runFunctionEvt = static_cast<RunFunctionEvent *>(evt);
+            runFunctionEvt->fun(this);
+        }
+            break;
+        default: {
+            INTERNAL_DEBUG("broadcastEvent");
+            handlerAmount = broadcastEvent(evt);
+        }
+            break;
     }
 
-    _started = false;
+    return handlerAmount;
 }
 
 void Ichor::DependencyManager::handleEventCompletion(const Ichor::Event *const evt) {
-    if(evt->originatingService == 0) {
+    if(evt->originatingService == 0 || evt->typeIndex >= _completionCallbacks.size()) {
         return;
     }
 
-    auto service = _services.find(evt->originatingService);
-    if(service == end(_services) || (service->second->getServiceState() != ServiceState::ACTIVE && service->second->getServiceState() != ServiceState::INJECTING)) {
+    auto &callbacks = _completionCallbacks[evt->typeIndex];
+    auto callback = callbacks.find(evt->originatingService);
+    if(callback == end(callbacks)) {
         return;
     }
 
-    auto callback = _completionCallbacks.find(CallbackKey{evt->originatingService, evt->type});
-    if(callback == end(_completionCallbacks)) {
+    auto state = _services.getState(_services.getHandle(evt->originatingService));
+    if(state != ServiceState::ACTIVE && state != ServiceState::INJECTING) {
         return;
     }
 
     callback->second(evt);
 }
 
+void Ichor::DependencyManager::handleMissedDeadline(const Ichor::Event *const evt) {
+    atTypeIndex(_missedDeadlines, evt->typeIndex)++;
+    _missedDeadlineCount++;
+
+    auto missedTypeIndex = eventTypeIndex<DeadlineMissedEvent>();
+    if(missedTypeIndex < _eventCallbacks.size() && !_eventCallbacks[missedTypeIndex].empty()) {
+        pushPrioritisedEvent<DeadlineMissedEvent>(evt->originatingService, evt->priority, evt->type, evt->name, evt->id, evt->deadline);
+    }
+
+    // tasks waiting for a dropped event would otherwise never be resumed
+    if(_eventAwaiterCount != 0) {
+        resumeEventAwaiters(evt, false);
+    }
+}
+
 uint32_t Ichor::DependencyManager::broadcastEvent(const Ichor::Event *const evt) {
-    auto registeredListeners = _eventCallbacks.find(evt->type);
-    if(registeredListeners == end(_eventCallbacks)) {
+    auto typeIndex = evt->typeIndex;
+    if(typeIndex >= _eventCallbacks.size()) {
         return 0;
     }
 
-    for(auto &callbackInfo : registeredListeners->second) {
-        auto service = _services.find(callbackInfo.listeningServiceId);
-        if(service == end(_services) || (service->second->getServiceState() != ServiceState::ACTIVE && service->second->getServiceState() != ServiceState::INJECTING)) {
+    // handlers can register handlers for new event types, which reallocates _eventCallbacks, so look up the handler by index every iteration
+    auto handlerCount = _eventCallbacks[typeIndex].size();
+    for(uint64_t i = 0; i < handlerCount; i++) {
+        auto &callbackInfo = _eventCallbacks[typeIndex][i];
+        // handlers registered before their service was added to this manager get their handle on first use
+        if(!callbackInfo.listeningService.valid()) {
+            callbackInfo.listeningService = _services.getHandle(callbackInfo.listeningServiceId);
+        }
+
+        auto state = _services.getState(callbackInfo.listeningService);
+        if(state != ServiceState::ACTIVE && state != ServiceState::INJECTING) {
             continue;
         }
 
@@ -430,12 +763,29 @@ uint32_t Ichor::DependencyManager::broadcastEvent(const Ichor::Event *const evt)
         }
 
         bool allowOtherHandlers;
-        auto ret = callbackInfo.callback(evt);
-        auto it = ret.begin();
+        if(callbackInfo.synchronousCallback) {
+            allowOtherHandlers = callbackInfo.synchronousCallback(evt);
+        } else if(callbackInfo.asyncCallback) {
+            auto task = callbackInfo.asyncCallback(evt);
+            auto previousTaskServiceId = std::exchange(_runningTaskServiceId, callbackInfo.listeningServiceId);
+            task.start();
+            _runningTaskServiceId = previousTaskServiceId;
+
+            // a suspended handler is parked in the awaiters of whatever it awaits, the result is not known yet
+            if(task.done()) {
+                allowOtherHandlers = task.result();
+            } else {
+                task.detach();
+                allowOtherHandlers = true;
+            }
+        } else {
+            auto ret = callbackInfo.callback(evt);
+            auto it = ret.begin();
 
-        allowOtherHandlers = *it;
-        if(it != ret.end()) {
-            pushEventInternal<ContinuableEvent<Generator<bool>>>(evt->originatingService, evt->priority, std::move(ret));
+            allowOtherHandlers = *it;
+            if(it != ret.end()) {
+                pushContinuation(evt->priority, std::move(ret));
+            }
         }
 
         if(!allowOtherHandlers) {
@@ -443,17 +793,144 @@ uint32_t Ichor::DependencyManager::broadcastEvent(const Ichor::Event *const evt)
         }
     }
 
-    return registeredListeners->second.size();
+    return static_cast<uint32_t>(_eventCallbacks[typeIndex].size());
+}
+
+void Ichor::DependencyManager::resumeContinuations(uint64_t priority, uint64_t eventId) {
+    // handlers that yield again are pushed to the back of their priority and have to wait for the next call
+    uint64_t remaining = _continuations.size();
+    while(remaining > 0 && !_continuations.empty() && !_quit.load(std::memory_order_relaxed)) {
+        auto continuationPriority = _continuations.topPriority();
+        // sequences only grow within a priority, so the first continuation of it is the oldest
+        if(continuationPriority > priority || (continuationPriority == priority && _continuations.top().sequence > eventId)) {
+            break;
+        }
+
+        auto generator = std::move(_continuations.pop().generator);
+        remaining--;
+
+        auto it = generator.begin();
+        if(it != generator.end()) {
+            pushContinuation(continuationPriority, std::move(generator));
+        }
+    }
+}
+
+void Ichor::DependencyManager::addEventAwaiter(uint32_t typeIndex, std::optional<uint64_t> eventId, EventAwaiterInfo &&awaiter) {
+    awaiter.owningServiceId = _runningTaskServiceId;
+    if(eventId.has_value()) {
+        _eventIdAwaiters[*eventId].push_back(std::move(awaiter));
+    } else {
+        atTypeIndex(_eventTypeAwaiters, typeIndex).push_back(std::move(awaiter));
+    }
+    _eventAwaiterCount++;
+}
+
+void Ichor::DependencyManager::resumeEventAwaiters(Event const * const evt, bool dispatched) {
+    // resumed tasks can start waiting again, so take all matching awaiters out before resuming any of them
+    if(dispatched && ALL_EVENTS_TYPE_INDEX < _eventTypeAwaiters.size()) {
+        collectEventAwaiters(_eventTypeAwaiters[ALL_EVENTS_TYPE_INDEX], evt);
+    }
+    if(dispatched && evt->typeIndex != ALL_EVENTS_TYPE_INDEX && evt->typeIndex < _eventTypeAwaiters.size()) {
+        collectEventAwaiters(_eventTypeAwaiters[evt->typeIndex], evt);
+    }
+    if(!_eventIdAwaiters.empty()) {
+        auto it = _eventIdAwaiters.find(evt->id);
+        if(it != _eventIdAwaiters.end()) {
+            for(auto &awaiter : it->second) {
+                _resumingAwaiters.push_back(std::move(awaiter));
+            }
+            _eventIdAwaiters.erase(it);
+        }
+    }
+
+    _eventAwaiterCount -= _resumingAwaiters.size();
+    auto previousTaskServiceId = _runningTaskServiceId;
+    for(auto &awaiter : _resumingAwaiters) {
+        *awaiter.event = evt;
+        _runningTaskServiceId = awaiter.owningServiceId;
+        awaiter.coroutine.resume();
+    }
+    _runningTaskServiceId = previousTaskServiceId;
+    _resumingAwaiters.clear();
+}
+
+void Ichor::DependencyManager::collectEventAwaiters(std::pmr::vector<EventAwaiterInfo> &awaiters, Event const * const evt) {
+    uint64_t kept = 0;
+    for(uint64_t i = 0; i < awaiters.size(); i++) {
+        auto &awaiter = awaiters[i];
+        bool matches = (!awaiter.filterServiceId.has_value() || *awaiter.filterServiceId == evt->originatingService) && (!awaiter.filter || awaiter.filter(evt));
+        if(matches) {
+            _resumingAwaiters.push_back(std::move(awaiter));
+            continue;
+        }
+
+        if(kept != i) {
+            awaiters[kept] = std::move(awaiter);
+        }
+        kept++;
+    }
+    awaiters.erase(awaiters.begin() + static_cast<std::ptrdiff_t>(kept), awaiters.end());
+}
+
+void Ichor::DependencyManager::destroyEventAwaiters() noexcept {
+    // destroying the outermost task destroys the tasks it is awaiting as well
+    for(auto &awaiters : _eventTypeAwaiters) {
+        for(auto &awaiter : awaiters) {
+            awaiter.root.destroy();
+        }
+    }
+    for(auto &[eventId, awaiters] : _eventIdAwaiters) {
+        for(auto &awaiter : awaiters) {
+            awaiter.root.destroy();
+        }
+    }
+    _eventTypeAwaiters.clear();
+    _eventIdAwaiters.clear();
+    _eventAwaiterCount = 0;
+}
+
+void Ichor::DependencyManager::destroyEventAwaiters(uint64_t owningServiceId) noexcept {
+    if(_eventAwaiterCount == 0) {
+        return;
+    }
+
+    auto destroyOwned = [this, owningServiceId](std::pmr::vector<EventAwaiterInfo> &awaiters) {
+        std::erase_if(awaiters, [this, owningServiceId](EventAwaiterInfo &awaiter) {
+            if(awaiter.owningServiceId != owningServiceId) {
+                return false;
+            }
+            awaiter.root.destroy();
+            _eventAwaiterCount--;
+            return true;
+        });
+    };
+
+    for(auto &awaiters : _eventTypeAwaiters) {
+        destroyOwned(awaiters);
+    }
+    for(auto it = _eventIdAwaiters.begin(); it != _eventIdAwaiters.end();) {
+        destroyOwned(it->second);
+        if(it->second.empty()) {
+            it = _eventIdAwaiters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Ichor::DependencyManager::pushContinuation(uint64_t priority, Generator<bool> &&generator) {
+    _continuations.push(priority, Continuation{_eventIdCounter.load(std::memory_order_acquire), std::move(generator)});
 }
 
 std::optional<std::string_view> Ichor::DependencyManager::getImplementationNameFor(uint64_t serviceId) const noexcept {
-    auto service = _services.find(serviceId);
+    auto const *service = _services.find(serviceId);
 
-    if(service == end(_services)) {
+    if(service == nullptr) {
         return {};
     }
 
-    return service->second->implementationName();
+    return service->implementationName();
 }
 
 void Ichor::DependencyManager::setCommunicationChannel(Ichor::CommunicationChannel *channel) {
@@ -0,0 +1,33 @@
+#include <ichor/EventTypeIndex.h>
+#include <ichor/stl/RealtimeMutex.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    struct EventTypeRegistry {
+        Ichor::RealtimeMutex mutex{};
+        std::unordered_map<uint64_t, uint32_t> indices{}; // key = event type, only contains non built-in types
+        uint32_t nextIndex{static_cast<uint32_t>(Ichor::Detail::builtinEventTypes.size() + 1)};
+    };
+
+    EventTypeRegistry& getRegistry() {
+        static EventTypeRegistry registry{};
+        return registry;
+    }
+}
+
+uint32_t Ichor::registerEventType(uint64_t type) {
+    for(uint32_t i = 0; i < Detail::builtinEventTypes.size(); i++) {
+        if(Detail::builtinEventTypes[i] == type) {
+            return i + 1;
+        }
+    }
+
+    auto &registry = getRegistry();
+    std::lock_guard lck(registry.mutex);
+    auto [it, inserted] = registry.indices.emplace(type, registry.nextIndex);
+    if(inserted) {
+        registry.nextIndex++;
+    }
+    return it->second;
+}
@@ -1,6 +1,7 @@
 #include <ichor/GetThreadLocalMemoryResource.h>
 
 thread_local std::pmr::memory_resource *rsrc;
+thread_local std::pmr::memory_resource *frameRsrc;
 
 std::pmr::memory_resource* Ichor::getThreadLocalMemoryResource() noexcept {
 #ifndef NDEBUG
@@ -13,4 +14,17 @@ std::pmr::memory_resource* Ichor::getThreadLocalMemoryResource() noexcept {
 
 void Ichor::setThreadLocalMemoryResource(std::pmr::memory_resource* _rsrc) noexcept {
     rsrc = _rsrc;
+}
+
+std::pmr::memory_resource* Ichor::getThreadLocalFrameResource() noexcept {
+#ifndef NDEBUG
+    if(frameRsrc == nullptr) {
+        std::terminate();
+    }
+#endif
+    return frameRsrc;
+}
+
+void Ichor::setThreadLocalFrameResource(std::pmr::memory_resource* _rsrc) noexcept {
+    frameRsrc = _rsrc;
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <ichor/ServiceRegistry.h>
+#include <stdexcept>
+
+Ichor::ServiceRegistry::ServiceRegistry(std::pmr::memory_resource *rsrc) : _slots(rsrc), _freeSlots(rsrc), _managers(rsrc), _states(rsrc), _slotOfDense(rsrc), _slotById(rsrc) {
+
+}
+
+Ichor::ServiceHandle Ichor::ServiceRegistry::insert(std::shared_ptr<ILifecycleManager> manager) {
+    auto serviceId = manager->serviceId();
+    if(_slotById.contains(serviceId)) {
+        throw std::runtime_error("Service already registered");
+    }
+
+    uint32_t slotIdx;
+    if(!_freeSlots.empty()) {
+        slotIdx = _freeSlots.back();
+        _freeSlots.pop_back();
+    } else {
+        if(_slots.size() == ServiceHandle::INVALID_SLOT) {
+            throw std::runtime_error("Too many services");
+        }
+        slotIdx = static_cast<uint32_t>(_slots.size());
+        _slots.push_back(Slot{0, 0});
+    }
+
+    auto &slot = _slots[slotIdx];
+    slot.denseIndex = static_cast<uint32_t>(_managers.size());
+    _states.push_back(manager->getServiceState());
+    _slotOfDense.push_back(slotIdx);
+    _managers.push_back(std::move(manager));
+    _slotById.emplace(serviceId, slotIdx);
+
+    return ServiceHandle{slotIdx, slot.generation};
+}
+
+bool Ichor::ServiceRegistry::erase(uint64_t serviceId) {
+    auto it = _slotById.find(serviceId);
+    if(it == _slotById.end()) {
+        return false;
+    }
+
+    auto slotIdx = it->second;
+    auto &slot = _slots[slotIdx];
+    auto denseIdx = slot.denseIndex;
+    auto lastIdx = static_cast<uint32_t>(_managers.size() - 1);
+
+    if(denseIdx != lastIdx) {
+        _managers[denseIdx] = std::move(_managers[lastIdx]);
+        _states[denseIdx] = _states[lastIdx];
+        _slotOfDense[denseIdx] = _slotOfDense[lastIdx];
+        _slots[_slotOfDense[denseIdx]].denseIndex = denseIdx;
+    }
+
+    _managers.pop_back();
+    _states.pop_back();
+    _slotOfDense.pop_back();
+
+    slot.generation++;
+    _freeSlots.push_back(slotIdx);
+    _slotById.erase(it);
+    return true;
+}
+
+void Ichor::ServiceRegistry::clear() noexcept {
+    for(uint32_t i = 0; i < _slots.size(); i++) {
+        _slots[i].generation++;
+    }
+    _freeSlots.clear();
+    for(auto i = static_cast<uint32_t>(_slots.size()); i > 0; i--) {
+        _freeSlots.push_back(i - 1);
+    }
+    _managers.clear();
+    _states.clear();
+    _slotOfDense.clear();
+    _slotById.clear();
+}
+
+Ichor::ILifecycleManager* Ichor::ServiceRegistry::find(uint64_t serviceId) const noexcept {
+    auto const *manager = findShared(serviceId);
+    return manager == nullptr ? nullptr : manager->get();
+}
+
+std::shared_ptr<Ichor::ILifecycleManager> const* Ichor::ServiceRegistry::findShared(uint64_t serviceId) const noexcept {
+    auto it = _slotById.find(serviceId);
+    if(it == _slotById.end()) {
+        return nullptr;
+    }
+
+    return &_managers[_slots[it->second].denseIndex];
+}
+
+Ichor::ServiceHandle Ichor::ServiceRegistry::getHandle(uint64_t serviceId) const noexcept {
+    auto it = _slotById.find(serviceId);
+    if(it == _slotById.end()) {
+        return {};
+    }
+
+    return ServiceHandle{it->second, _slots[it->second].generation};
+}
+
+void Ichor::ServiceRegistry::updateState(ILifecycleManager const &manager) noexcept {
+    auto it = _slotById.find(manager.serviceId());
+    if(it == _slotById.end()) {
+        return;
+    }
+
+    _states[_slots[it->second].denseIndex] = manager.getServiceState();
+}
@@ -0,0 +1,67 @@
+#include <ichor/event_queues/BucketEventQueue.h>
+#include <mutex>
+
+Ichor::BucketEventQueue::BucketEventQueue(std::pmr::memory_resource *rsrc) : _eventQueue(rsrc) {
+
+}
+
+void Ichor::BucketEventQueue::pushEvent(uint64_t priority, EventStackUniquePtr &&event) {
+    std::lock_guard lck(_eventQueueMutex);
+    _eventQueue.push(priority, std::move(event));
+    if(priority < _highestPriority.load(std::memory_order_relaxed)) {
+        _highestPriority.store(priority, std::memory_order_release);
+    }
+}
+
+void Ichor::BucketEventQueue::pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) {
+    if(events.empty()) {
+        return;
+    }
+
+    std::lock_guard lck(_eventQueueMutex);
+    for(auto &event : events) {
+        _eventQueue.push(priority, std::move(event));
+    }
+    if(priority < _highestPriority.load(std::memory_order_relaxed)) {
+        _highestPriority.store(priority, std::memory_order_release);
+    }
+}
+
+Ichor::EventStackUniquePtr Ichor::BucketEventQueue::popEvent() {
+    std::lock_guard lck(_eventQueueMutex);
+    if(_eventQueue.empty()) {
+        return {};
+    }
+
+    auto evt = _eventQueue.pop();
+    _highestPriority.store(_eventQueue.empty() ? std::numeric_limits<uint64_t>::max() : _eventQueue.topPriority(), std::memory_order_release);
+    return evt;
+}
+
+void Ichor::BucketEventQueue::popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) {
+    std::lock_guard lck(_eventQueueMutex);
+    for(uint64_t i = 0; i < max && !_eventQueue.empty(); i++) {
+        events.emplace_back(_eventQueue.pop());
+    }
+    _highestPriority.store(_eventQueue.empty() ? std::numeric_limits<uint64_t>::max() : _eventQueue.topPriority(), std::memory_order_release);
+}
+
+uint64_t Ichor::BucketEventQueue::peekHighestPriority() {
+    return _highestPriority.load(std::memory_order_acquire);
+}
+
+bool Ichor::BucketEventQueue::empty() const {
+    std::lock_guard lck(_eventQueueMutex);
+    return _eventQueue.empty();
+}
+
+uint64_t Ichor::BucketEventQueue::size() const {
+    std::lock_guard lck(_eventQueueMutex);
+    return _eventQueue.size();
+}
+
+void Ichor::BucketEventQueue::clear() {
+    std::lock_guard lck(_eventQueueMutex);
+    _eventQueue.clear();
+    _highestPriority.store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+}
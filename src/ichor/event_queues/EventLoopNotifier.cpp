@@ -0,0 +1,135 @@
+#include <ichor/event_queues/EventLoopNotifier.h>
+#include <algorithm>
+#include <stdexcept>
+#ifdef __linux__
+#include <array>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <ctime>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#else
+#include <mutex>
+#endif
+
+#ifdef __linux__
+Ichor::EventLoopNotifier::EventLoopNotifier() {
+    _eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(_eventFd < 0) {
+        throw std::runtime_error(std::string{"Couldn't create eventfd: "} + std::strerror(errno));
+    }
+
+    // steady_clock uses CLOCK_MONOTONIC on linux, so its time points can be used as absolute expiries
+    _timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(_timerFd < 0) {
+        ::close(_eventFd);
+        throw std::runtime_error(std::string{"Couldn't create timerfd: "} + std::strerror(errno));
+    }
+
+    _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if(_epollFd < 0) {
+        ::close(_timerFd);
+        ::close(_eventFd);
+        throw std::runtime_error(std::string{"Couldn't create epoll: "} + std::strerror(errno));
+    }
+
+    for(int fd : {_eventFd, _timerFd}) {
+        epoll_event evt{};
+        evt.events = EPOLLIN;
+        evt.data.fd = fd;
+        if(::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &evt) != 0) {
+            ::close(_epollFd);
+            ::close(_timerFd);
+            ::close(_eventFd);
+            throw std::runtime_error(std::string{"Couldn't add fd to epoll: "} + std::strerror(errno));
+        }
+    }
+}
+
+Ichor::EventLoopNotifier::~EventLoopNotifier() {
+    ::close(_epollFd);
+    ::close(_timerFd);
+    ::close(_eventFd);
+}
+
+void Ichor::EventLoopNotifier::addWakeupFd(int fd) {
+    epoll_event evt{};
+    evt.events = EPOLLIN;
+    evt.data.fd = fd;
+    if(::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &evt) != 0 && errno != EEXIST) {
+        throw std::runtime_error(std::string{"Couldn't add fd to epoll: "} + std::strerror(errno));
+    }
+}
+
+void Ichor::EventLoopNotifier::removeWakeupFd(int fd) noexcept {
+    ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void Ichor::EventLoopNotifier::park(std::chrono::steady_clock::time_point deadline) {
+    _parks.fetch_add(1, std::memory_order_relaxed);
+
+    // an armed timer that is further away than the deadline would wake us up too late, one that is earlier only causes a spurious wakeup. Re-arming costs a syscall, so only do it when needed.
+    if(deadline != _armedDeadline && (deadline < _armedDeadline || _armedDeadline < std::chrono::steady_clock::now())) {
+        itimerspec spec{};
+        if(deadline != std::chrono::steady_clock::time_point::max()) {
+            auto sinceEpoch = std::max<std::chrono::nanoseconds>(deadline.time_since_epoch(), std::chrono::nanoseconds(1));
+            spec.it_value.tv_sec = static_cast<time_t>(sinceEpoch.count() / 1'000'000'000);
+            spec.it_value.tv_nsec = static_cast<long>(sinceEpoch.count() % 1'000'000'000);
+        }
+        if(::timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0) {
+            _armedDeadline = deadline;
+        }
+    }
+
+    std::array<epoll_event, 4> events{};
+    int ret = ::epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), -1);
+
+    for(int i = 0; i < ret; i++) {
+        auto fd = events[static_cast<uint64_t>(i)].data.fd;
+        if(fd == _eventFd) {
+            uint64_t count{};
+            [[maybe_unused]] auto readRet = ::read(_eventFd, &count, sizeof(count));
+        } else if(fd == _timerFd) {
+            uint64_t expirations{};
+            [[maybe_unused]] auto readRet = ::read(_timerFd, &expirations, sizeof(expirations));
+            _armedDeadline = std::chrono::steady_clock::time_point::max();
+            _timerWakeups.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Ichor::EventLoopNotifier::wake() noexcept {
+    _notifications.fetch_add(1, std::memory_order_relaxed);
+    uint64_t one = 1;
+    [[maybe_unused]] auto ret = ::write(_eventFd, &one, sizeof(one));
+}
+#else
+Ichor::EventLoopNotifier::EventLoopNotifier() = default;
+Ichor::EventLoopNotifier::~EventLoopNotifier() = default;
+
+void Ichor::EventLoopNotifier::park(std::chrono::steady_clock::time_point deadline) {
+    _parks.fetch_add(1, std::memory_order_relaxed);
+
+    // without a file descriptor to wake up on SIGINT, never sleep longer than 100ms
+    auto now = std::chrono::steady_clock::now();
+    auto timeout = std::min<std::chrono::nanoseconds>(deadline - std::min(deadline, now), std::chrono::milliseconds(100));
+
+    std::unique_lock lck(_mutex);
+    if(!_cv.wait_for(lck, timeout, [this] { return _signaled; }) && deadline <= std::chrono::steady_clock::now()) {
+        _timerWakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+    _signaled = false;
+}
+
+void Ichor::EventLoopNotifier::wake() noexcept {
+    _notifications.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::unique_lock lck(_mutex);
+        _signaled = true;
+    }
+    _cv.notify_all();
+}
+#endif
@@ -0,0 +1,180 @@
+#include <ichor/event_queues/MpscEventQueue.h>
+#include <bit>
+#include <mutex>
+
+Ichor::MpscEventQueue::MpscEventQueue(std::pmr::memory_resource *rsrc, uint64_t capacity) : _rsrc(rsrc), _ring(), _mask(std::bit_ceil(std::max<uint64_t>(capacity, 2)) - 1), _local(rsrc) {
+    _ring = static_cast<Cell*>(_rsrc->allocate(sizeof(Cell) * (_mask + 1), alignof(Cell)));
+    for(uint64_t i = 0; i <= _mask; i++) {
+        new (&_ring[i]) Cell{};
+        _ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Ichor::MpscEventQueue::~MpscEventQueue() {
+    for(uint64_t i = 0; i <= _mask; i++) {
+        _ring[i].~Cell();
+    }
+    _rsrc->deallocate(_ring, sizeof(Cell) * (_mask + 1), alignof(Cell));
+}
+
+void Ichor::MpscEventQueue::pushEvent(uint64_t priority, EventStackUniquePtr &&event) {
+    if(std::this_thread::get_id() == _consumerThreadId.load(std::memory_order_acquire)) {
+        // preserve ordering with respect to events that other threads already finished inserting
+        drainToLocal();
+        _local.push(priority, std::move(event));
+        return;
+    }
+
+    if(!_overflowing.load(std::memory_order_acquire) && tryPushRing(priority, std::span<EventStackUniquePtr>{&event, 1})) {
+        return;
+    }
+
+    std::lock_guard lck(_overflowMutex);
+    _overflowing.store(true, std::memory_order_release);
+    _overflow.emplace_back(priority, std::move(event));
+}
+
+void Ichor::MpscEventQueue::pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) {
+    if(events.empty()) {
+        return;
+    }
+
+    if(std::this_thread::get_id() == _consumerThreadId.load(std::memory_order_acquire)) {
+        drainToLocal();
+        for(auto &event : events) {
+            _local.push(priority, std::move(event));
+        }
+        return;
+    }
+
+    if(!_overflowing.load(std::memory_order_acquire) && tryPushRing(priority, events)) {
+        return;
+    }
+
+    std::lock_guard lck(_overflowMutex);
+    _overflowing.store(true, std::memory_order_release);
+    for(auto &event : events) {
+        _overflow.emplace_back(priority, std::move(event));
+    }
+}
+
+Ichor::EventStackUniquePtr Ichor::MpscEventQueue::popEvent() {
+    if(_consumerThreadId.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+        _consumerThreadId.store(std::this_thread::get_id(), std::memory_order_release);
+    }
+
+    drainToLocal();
+
+    if(_local.empty()) {
+        return {};
+    }
+
+    return _local.pop();
+}
+
+void Ichor::MpscEventQueue::popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) {
+    if(_consumerThreadId.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+        _consumerThreadId.store(std::this_thread::get_id(), std::memory_order_release);
+    }
+
+    drainToLocal();
+
+    for(uint64_t i = 0; i < max && !_local.empty(); i++) {
+        events.emplace_back(_local.pop());
+    }
+}
+
+uint64_t Ichor::MpscEventQueue::peekHighestPriority() {
+    drainToLocal();
+
+    return _local.empty() ? std::numeric_limits<uint64_t>::max() : _local.topPriority();
+}
+
+bool Ichor::MpscEventQueue::empty() const {
+    if(!_local.empty() || _overflowing.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    auto const &cell = _ring[_dequeuePos & _mask];
+    return cell.sequence.load(std::memory_order_acquire) != _dequeuePos + 1;
+}
+
+uint64_t Ichor::MpscEventQueue::size() const {
+    std::lock_guard lck(_overflowMutex);
+    return _local.size() + _overflow.size() + (_enqueuePos.load(std::memory_order_acquire) - _dequeuePos);
+}
+
+void Ichor::MpscEventQueue::clear() {
+    drainToLocal();
+    _local.clear();
+}
+
+bool Ichor::MpscEventQueue::tryPushRing(uint64_t priority, std::span<EventStackUniquePtr> events) noexcept {
+    uint64_t count = events.size();
+    if(count > _mask + 1) {
+        return false;
+    }
+
+    uint64_t pos = _enqueuePos.load(std::memory_order_relaxed);
+
+    while(true) {
+        // the consumer frees cells in order, so if the last cell of the range is free, all of them are
+        uint64_t lastPos = pos + count - 1;
+        auto seq = _ring[lastPos & _mask].sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(lastPos);
+
+        if(diff == 0) {
+            if(_enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(diff < 0) {
+            return false;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    for(uint64_t i = 0; i < count; i++) {
+        auto &cell = _ring[(pos + i) & _mask];
+        cell.priority = priority;
+        cell.event = std::move(events[i]);
+        cell.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+void Ichor::MpscEventQueue::drainRing() {
+    while(true) {
+        auto &cell = _ring[_dequeuePos & _mask];
+        if(cell.sequence.load(std::memory_order_acquire) != _dequeuePos + 1) {
+            return;
+        }
+
+        _local.push(cell.priority, std::move(cell.event));
+        cell.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+        _dequeuePos++;
+    }
+}
+
+void Ichor::MpscEventQueue::drainToLocal() {
+    if(!_overflowing.load(std::memory_order_acquire)) {
+        drainRing();
+        return;
+    }
+
+    // Events in the ring were inserted before the ones in the overflow by the same producer, so drain the ring while holding the lock.
+    // A producer might still be publishing a cell it claimed before another producer overflowed, in which case drainRing() stops in front of it,
+    // so wait until every cell claimed before taking the lock has been published, or later cells of the overflowing producer end up behind its overflowed events.
+    std::lock_guard lck(_overflowMutex);
+    auto const claimedPos = _enqueuePos.load(std::memory_order_acquire);
+    drainRing();
+    while(_dequeuePos < claimedPos) {
+        std::this_thread::yield();
+        drainRing();
+    }
+    for(auto &[priority, event] : _overflow) {
+        _local.push(priority, std::move(event));
+    }
+    _overflow.clear();
+    _overflowing.store(false, std::memory_order_release);
+}
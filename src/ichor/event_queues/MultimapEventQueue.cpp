@@ -0,0 +1,70 @@
+#include <ichor/event_queues/MultimapEventQueue.h>
+#include <mutex>
+#include <shared_mutex>
+
+Ichor::MultimapEventQueue::MultimapEventQueue(std::pmr::memory_resource *rsrc) : _eventQueue(rsrc) {
+
+}
+
+void Ichor::MultimapEventQueue::pushEvent(uint64_t priority, EventStackUniquePtr &&event) {
+    std::unique_lock lck(_eventQueueMutex);
+    _eventQueue.emplace(priority, std::move(event));
+    if(priority < _highestPriority.load(std::memory_order_relaxed)) {
+        _highestPriority.store(priority, std::memory_order_release);
+    }
+}
+
+void Ichor::MultimapEventQueue::pushEvents(uint64_t priority, std::span<EventStackUniquePtr> events) {
+    if(events.empty()) {
+        return;
+    }
+
+    std::unique_lock lck(_eventQueueMutex);
+    for(auto &event : events) {
+        _eventQueue.emplace(priority, std::move(event));
+    }
+    if(priority < _highestPriority.load(std::memory_order_relaxed)) {
+        _highestPriority.store(priority, std::memory_order_release);
+    }
+}
+
+Ichor::EventStackUniquePtr Ichor::MultimapEventQueue::popEvent() {
+    // only the consumer modifies the tree without the exclusive lock, producers are kept out by the shared lock
+    std::shared_lock lck(_eventQueueMutex);
+    if(_eventQueue.empty()) {
+        return {};
+    }
+
+    auto evtNode = _eventQueue.extract(_eventQueue.begin());
+    _highestPriority.store(_eventQueue.empty() ? std::numeric_limits<uint64_t>::max() : _eventQueue.begin()->first, std::memory_order_release);
+    return std::move(evtNode.mapped());
+}
+
+void Ichor::MultimapEventQueue::popEvents(std::pmr::vector<EventStackUniquePtr> &events, uint64_t max) {
+    std::shared_lock lck(_eventQueueMutex);
+    for(uint64_t i = 0; i < max && !_eventQueue.empty(); i++) {
+        auto evtNode = _eventQueue.extract(_eventQueue.begin());
+        events.emplace_back(std::move(evtNode.mapped()));
+    }
+    _highestPriority.store(_eventQueue.empty() ? std::numeric_limits<uint64_t>::max() : _eventQueue.begin()->first, std::memory_order_release);
+}
+
+uint64_t Ichor::MultimapEventQueue::peekHighestPriority() {
+    return _highestPriority.load(std::memory_order_acquire);
+}
+
+bool Ichor::MultimapEventQueue::empty() const {
+    std::shared_lock lck(_eventQueueMutex);
+    return _eventQueue.empty();
+}
+
+uint64_t Ichor::MultimapEventQueue::size() const {
+    std::shared_lock lck(_eventQueueMutex);
+    return _eventQueue.size();
+}
+
+void Ichor::MultimapEventQueue::clear() {
+    std::unique_lock lck(_eventQueueMutex);
+    _eventQueue.clear();
+    _highestPriority.store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+}
@@ -0,0 +1,331 @@
+#include <ichor/event_queues/TimerWheel.h>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+    constexpr uint64_t SLOT_MASK = Ichor::TimerWheel::SLOTS - 1;
+
+    /// \return distance from start to the first set bit, going around if necessary. SLOTS if no bit is set.
+    uint64_t distanceToOccupiedSlot(std::array<uint64_t, Ichor::TimerWheel::SLOTS / 64> const &bits, uint64_t start) noexcept {
+        constexpr uint64_t WORDS = Ichor::TimerWheel::SLOTS / 64;
+        uint64_t word = start >> 6;
+        uint64_t bit = start & 63;
+
+        uint64_t masked = bits[word] & (~0ull << bit);
+        if(masked != 0) {
+            return static_cast<uint64_t>(std::countr_zero(masked)) - bit;
+        }
+
+        for(uint64_t i = 1; i <= WORDS; i++) {
+            uint64_t w = (word + i) % WORDS;
+            if(bits[w] != 0) {
+                uint64_t pos = w * 64 + static_cast<uint64_t>(std::countr_zero(bits[w]));
+                return (pos - start) & SLOT_MASK;
+            }
+        }
+
+        return Ichor::TimerWheel::SLOTS;
+    }
+}
+
+Ichor::TimerWheel::TimerWheel(std::pmr::memory_resource *rsrc, clock::time_point epoch) : _nodes(rsrc), _freeNodes(rsrc), _epoch(epoch) {
+    _heads.fill(NONE);
+}
+
+Ichor::TimerHandle Ichor::TimerWheel::add(clock::time_point expiry, std::chrono::nanoseconds interval, Ichor::function<void()> fn) {
+    uint32_t idx;
+    if(!_freeNodes.empty()) {
+        idx = _freeNodes.back();
+        _freeNodes.pop_back();
+    } else {
+        idx = static_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+        _nodes.back().generation = 0;
+    }
+
+    auto &node = _nodes[idx];
+    node.interval = interval;
+    node.fn = std::move(fn);
+    node.slot = NONE;
+    node.active = true;
+    _size++;
+    schedule(idx, expiry);
+
+    return TimerHandle{idx, node.generation};
+}
+
+void Ichor::TimerWheel::setResolution(std::chrono::nanoseconds resolution) {
+    if(_size != 0) {
+        throw std::runtime_error("Cannot change the resolution of a timing wheel containing timers");
+    }
+    if(resolution < std::chrono::microseconds(1)) {
+        throw std::runtime_error("Timer resolution has to be at least 1 microsecond");
+    }
+
+    // keep the same amount of time processed
+    _currentTick = static_cast<uint64_t>(_tick * _currentTick / resolution);
+    _tick = resolution;
+}
+
+bool Ichor::TimerWheel::cancel(TimerHandle handle) noexcept {
+    auto *node = find(handle);
+    if(node == nullptr) {
+        return false;
+    }
+
+    if(node->slot != NONE) {
+        unlink(handle.index);
+    }
+    release(handle.index);
+    return true;
+}
+
+bool Ichor::TimerWheel::setInterval(TimerHandle handle, std::chrono::nanoseconds interval) noexcept {
+    auto *node = find(handle);
+    if(node == nullptr) {
+        return false;
+    }
+
+    auto previousInterval = node->interval;
+    node->interval = interval;
+
+    // timers that are currently firing are scheduled with the new interval once their function returns
+    if(node->slot != NONE && previousInterval.count() > 0 && interval.count() > 0) {
+        unlink(handle.index);
+        schedule(handle.index, node->expiry - previousInterval + interval);
+    }
+    return true;
+}
+
+bool Ichor::TimerWheel::reschedule(TimerHandle handle, clock::time_point expiry, std::chrono::nanoseconds interval) noexcept {
+    auto *node = find(handle);
+    if(node == nullptr) {
+        return false;
+    }
+
+    if(node->slot != NONE) {
+        unlink(handle.index);
+    }
+    node->interval = interval;
+    schedule(handle.index, expiry);
+    return true;
+}
+
+uint64_t Ichor::TimerWheel::expire(clock::time_point now) {
+    if(now < _epoch) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>((now - _epoch) / _tick);
+    uint64_t fired = 0;
+
+    while(_currentTick < target) {
+        // skip over ticks without anything to do
+        uint64_t next = _size == 0 ? std::numeric_limits<uint64_t>::max() : nextEventTick();
+        if(next > target) {
+            _currentTick = target;
+            break;
+        }
+        _currentTick = next;
+
+        // when a level wraps around, the next slot of the level above moves down
+        if((_currentTick & SLOT_MASK) == 0) {
+            for(uint64_t level = 1; level < LEVELS; level++) {
+                uint64_t slotIdx = (_currentTick >> (level * SLOT_BITS)) & SLOT_MASK;
+                cascade(level, slotIdx);
+                if(slotIdx != 0) {
+                    break;
+                }
+            }
+        }
+
+        // fired timers are unlinked one by one, as their functions can cancel other timers in the same slot
+        auto &head = _heads[_currentTick & SLOT_MASK];
+        while(head != NONE) {
+            auto idx = head;
+            unlink(idx);
+            fire(idx, now);
+            fired++;
+        }
+    }
+
+    return fired;
+}
+
+Ichor::TimerWheel::clock::time_point Ichor::TimerWheel::nextDeadline() const noexcept {
+    if(_size == 0) {
+        return clock::time_point::max();
+    }
+
+    return _epoch + _tick * nextEventTick();
+}
+
+void Ichor::TimerWheel::clear() noexcept {
+    for(uint32_t idx = 0; idx < _nodes.size(); idx++) {
+        if(_nodes[idx].active) {
+            release(idx);
+        }
+    }
+    _heads.fill(NONE);
+    for(auto &level : _occupied) {
+        level.fill(0);
+    }
+}
+
+uint64_t Ichor::TimerWheel::tickOf(clock::time_point t) const noexcept {
+    if(t <= _epoch) {
+        return 0;
+    }
+
+    // round up, timers never fire early
+    auto sinceEpoch = t - _epoch;
+    return static_cast<uint64_t>((sinceEpoch + _tick - std::chrono::nanoseconds(1)) / _tick);
+}
+
+uint64_t Ichor::TimerWheel::nextEventTick() const noexcept {
+    // level 0 slots hold exactly one tick each, the slot of the current tick has been processed already
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    uint64_t distance = distanceToOccupiedSlot(_occupied[0], (_currentTick + 1) & SLOT_MASK);
+    if(distance != SLOTS) {
+        best = _currentTick + 1 + distance;
+    }
+
+    // higher levels have work to do when the lower level wraps around into one of their occupied slots
+    for(uint64_t level = 1; level < LEVELS; level++) {
+        uint64_t shift = level * SLOT_BITS;
+        uint64_t block = _currentTick >> shift;
+        distance = distanceToOccupiedSlot(_occupied[level], (block + 1) & SLOT_MASK);
+        if(distance != SLOTS) {
+            best = std::min(best, (block + 1 + distance) << shift);
+        }
+    }
+
+    return best;
+}
+
+Ichor::TimerWheel::Node* Ichor::TimerWheel::find(TimerHandle handle) noexcept {
+    if(!handle.valid() || handle.index >= _nodes.size()) {
+        return nullptr;
+    }
+
+    auto &node = _nodes[handle.index];
+    if(!node.active || node.generation != handle.generation) {
+        return nullptr;
+    }
+
+    return &node;
+}
+
+void Ichor::TimerWheel::link(uint32_t idx, uint64_t tick) noexcept {
+    uint64_t delta = tick - _currentTick;
+    uint64_t level = 0;
+    while(level < LEVELS - 1 && delta >= (1ull << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+
+    uint64_t slotIdx;
+    if(delta >= (1ull << (LEVELS * SLOT_BITS))) {
+        // too far away, park it in the last slot of the top level and re-insert it when that slot comes around
+        slotIdx = ((_currentTick >> ((LEVELS - 1) * SLOT_BITS)) + SLOTS - 1) & SLOT_MASK;
+    } else {
+        slotIdx = (tick >> (level * SLOT_BITS)) & SLOT_MASK;
+    }
+
+    auto slot = static_cast<uint32_t>(level * SLOTS + slotIdx);
+    auto &node = _nodes[idx];
+    node.slot = slot;
+    node.prev = NONE;
+    node.next = _heads[slot];
+    if(node.next != NONE) {
+        _nodes[node.next].prev = idx;
+    }
+    _heads[slot] = idx;
+    _occupied[level][slotIdx >> 6] |= 1ull << (slotIdx & 63);
+}
+
+void Ichor::TimerWheel::unlink(uint32_t idx) noexcept {
+    auto &node = _nodes[idx];
+    if(node.prev != NONE) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _heads[node.slot] = node.next;
+        if(node.next == NONE) {
+            uint64_t level = node.slot / SLOTS;
+            uint64_t slotIdx = node.slot & SLOT_MASK;
+            _occupied[level][slotIdx >> 6] &= ~(1ull << (slotIdx & 63));
+        }
+    }
+    if(node.next != NONE) {
+        _nodes[node.next].prev = node.prev;
+    }
+    node.slot = NONE;
+}
+
+void Ichor::TimerWheel::release(uint32_t idx) noexcept {
+    auto &node = _nodes[idx];
+    node.fn = {};
+    node.active = false;
+    node.slot = NONE;
+    node.generation++;
+    _freeNodes.push_back(idx);
+    _size--;
+}
+
+void Ichor::TimerWheel::cascade(uint64_t level, uint64_t slotIdx) noexcept {
+    auto slot = level * SLOTS + slotIdx;
+    while(_heads[slot] != NONE) {
+        auto idx = _heads[slot];
+        unlink(idx);
+        // timers expiring in the current tick end up in the level 0 slot that is processed next
+        link(idx, std::max(_nodes[idx].expiryTick, _currentTick));
+    }
+}
+
+void Ichor::TimerWheel::fire(uint32_t idx, clock::time_point now) {
+    auto &node = _nodes[idx];
+    auto generation = node.generation;
+
+    auto lateness = static_cast<uint64_t>(std::max<std::chrono::nanoseconds>(now - node.expiry, std::chrono::nanoseconds::zero()).count());
+    _statistics.fired++;
+    _statistics.totalLatenessNanosec += lateness;
+    _statistics.maxLatenessNanosec = std::max(_statistics.maxLatenessNanosec, lateness);
+
+    if(node.interval.count() <= 0) {
+        auto fn = std::move(node.fn);
+        release(idx);
+        fn();
+        return;
+    }
+
+    // the function is moved out while running, it could add timers and reallocate _nodes
+    auto fn = std::move(node.fn);
+    fn();
+
+    auto &firedNode = _nodes[idx];
+    if(!firedNode.active || firedNode.generation != generation) {
+        return;
+    }
+    firedNode.fn = std::move(fn);
+
+    // the function may have rescheduled its own timer
+    if(firedNode.slot != NONE) {
+        return;
+    }
+    if(firedNode.interval.count() <= 0) {
+        release(idx);
+        return;
+    }
+
+    auto missed = std::max<int64_t>((now - firedNode.expiry) / firedNode.interval, 0) + 1;
+    schedule(idx, firedNode.expiry + firedNode.interval * missed);
+}
+
+void Ichor::TimerWheel::schedule(uint32_t idx, clock::time_point expiry) noexcept {
+    auto &node = _nodes[idx];
+    node.expiry = expiry;
+    node.expiryTick = tickOf(expiry);
+
+    // the current tick has already been processed
+    link(idx, std::max(node.expiryTick, _currentTick + 1));
+}
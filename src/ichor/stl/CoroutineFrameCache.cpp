@@ -0,0 +1,86 @@
+#include <ichor/stl/CoroutineFrameCache.h>
+#include <new>
+
+Ichor::CoroutineFrameCache::CoroutineFrameCache(std::pmr::memory_resource *upstream) noexcept : _upstream(upstream) {
+
+}
+
+Ichor::CoroutineFrameCache::~CoroutineFrameCache() {
+    for(uint64_t i = 0; i < _sizeCount; i++) {
+        auto &sizeClass = _sizes[i];
+        while(sizeClass.head != nullptr) {
+            auto *next = sizeClass.head->next;
+            _upstream->deallocate(sizeClass.head, sizeClass.size, alignof(std::max_align_t));
+            sizeClass.head = next;
+        }
+    }
+}
+
+Ichor::CoroutineFrameStatistics Ichor::CoroutineFrameCache::getStatistics() const noexcept {
+    return CoroutineFrameStatistics{_allocations, _recycled, _live, _peakLive, _cached};
+}
+
+void* Ichor::CoroutineFrameCache::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void *ret;
+    auto *sizeClass = findSizeClass(bytes, alignment, false);
+    if(sizeClass != nullptr && sizeClass->head != nullptr) {
+        ret = sizeClass->head;
+        sizeClass->head = sizeClass->head->next;
+        sizeClass->count--;
+        _cached--;
+        _recycled++;
+    } else {
+        ret = _upstream->allocate(bytes, alignment);
+    }
+
+    _allocations++;
+    _live++;
+    if(_live > _peakLive) {
+        _peakLive = _live;
+    }
+
+    return ret;
+}
+
+void Ichor::CoroutineFrameCache::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+    _live--;
+
+    auto *sizeClass = findSizeClass(bytes, alignment, true);
+    if(sizeClass == nullptr || sizeClass->count == MAX_CACHED_FRAMES_PER_SIZE) {
+        _upstream->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    sizeClass->head = new (p) FreeFrame{sizeClass->head};
+    sizeClass->count++;
+    _cached++;
+}
+
+bool Ichor::CoroutineFrameCache::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+Ichor::CoroutineFrameCache::SizeClass* Ichor::CoroutineFrameCache::findSizeClass(std::size_t bytes, std::size_t alignment, bool create) noexcept {
+    if(bytes < sizeof(FreeFrame) || bytes > MAX_FRAME_SIZE || alignment > alignof(std::max_align_t)) {
+        return nullptr;
+    }
+
+    if(_lastSizeIdx < _sizeCount && _sizes[_lastSizeIdx].size == bytes) {
+        return &_sizes[_lastSizeIdx];
+    }
+
+    for(uint64_t i = 0; i < _sizeCount; i++) {
+        if(_sizes[i].size == bytes) {
+            _lastSizeIdx = i;
+            return &_sizes[i];
+        }
+    }
+
+    if(!create || _sizeCount == MAX_SIZES) {
+        return nullptr;
+    }
+
+    _sizes[_sizeCount] = SizeClass{bytes, nullptr, 0};
+    _lastSizeIdx = _sizeCount;
+    return &_sizes[_sizeCount++];
+}
@@ -0,0 +1,160 @@
+#include <ichor/stl/EventSlabAllocator.h>
+#include <bit>
+#include <mutex>
+#include <new>
+
+namespace {
+    constexpr uint64_t sizeClassFor(std::size_t bytes) noexcept {
+        if(bytes <= Ichor::EventSlabAllocator::MIN_BLOCK_SIZE) {
+            return 0;
+        }
+        return static_cast<uint64_t>(std::bit_width(bytes - 1) - std::bit_width(Ichor::EventSlabAllocator::MIN_BLOCK_SIZE - 1));
+    }
+
+    constexpr uint64_t blockSizeFor(uint64_t sizeClass) noexcept {
+        return Ichor::EventSlabAllocator::MIN_BLOCK_SIZE << sizeClass;
+    }
+
+    static_assert(sizeClassFor(Ichor::EventSlabAllocator::MAX_BLOCK_SIZE) == Ichor::EventSlabAllocator::SIZE_CLASSES - 1);
+}
+
+Ichor::EventSlabAllocator::EventSlabAllocator(std::pmr::memory_resource *upstream) noexcept : _upstream(upstream) {
+
+}
+
+Ichor::EventSlabAllocator::~EventSlabAllocator() {
+    for(uint64_t sizeClass = 0; sizeClass < SIZE_CLASSES; sizeClass++) {
+        auto &cls = _classes[sizeClass];
+        uint64_t stride = HEADER_SIZE + blockSizeFor(sizeClass);
+        for(uint64_t k = 0; k < cls.slabCount; k++) {
+            _upstream->deallocate(cls.slabs[k].load(std::memory_order_relaxed), (FIRST_SLAB_BLOCKS << k) * stride, HEADER_SIZE);
+        }
+    }
+}
+
+std::vector<Ichor::EventSlabStatistics> Ichor::EventSlabAllocator::getStatistics() const {
+    std::vector<EventSlabStatistics> ret;
+    ret.reserve(SIZE_CLASSES);
+    for(uint64_t sizeClass = 0; sizeClass < SIZE_CLASSES; sizeClass++) {
+        auto &cls = _classes[sizeClass];
+        ret.push_back(EventSlabStatistics{blockSizeFor(sizeClass), cls.allocations.load(std::memory_order_relaxed), cls.hits.load(std::memory_order_relaxed),
+                                          cls.inUse.load(std::memory_order_relaxed), cls.highWaterMark.load(std::memory_order_relaxed), cls.capacity.load(std::memory_order_relaxed)});
+    }
+    return ret;
+}
+
+void* Ichor::EventSlabAllocator::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if(bytes > MAX_BLOCK_SIZE || alignment > HEADER_SIZE) {
+        return _upstream->allocate(bytes, alignment);
+    }
+
+    auto sizeClass = sizeClassFor(bytes);
+    auto &cls = _classes[sizeClass];
+    cls.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    BlockHeader *block = popFree(sizeClass);
+    if(block != nullptr) {
+        cls.hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        block = grow(sizeClass);
+    }
+
+    auto inUse = cls.inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto highWaterMark = cls.highWaterMark.load(std::memory_order_relaxed);
+    while(inUse > highWaterMark && !cls.highWaterMark.compare_exchange_weak(highWaterMark, inUse, std::memory_order_relaxed)) {
+    }
+
+    return reinterpret_cast<std::byte*>(block) + HEADER_SIZE;
+}
+
+void Ichor::EventSlabAllocator::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+    if(bytes > MAX_BLOCK_SIZE || alignment > HEADER_SIZE) {
+        _upstream->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    auto sizeClass = sizeClassFor(bytes);
+    auto *block = reinterpret_cast<BlockHeader*>(static_cast<std::byte*>(p) - HEADER_SIZE);
+    _classes[sizeClass].inUse.fetch_sub(1, std::memory_order_relaxed);
+    pushFree(sizeClass, block, block);
+}
+
+bool Ichor::EventSlabAllocator::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+Ichor::EventSlabAllocator::BlockHeader* Ichor::EventSlabAllocator::blockAt(uint64_t sizeClass, uint32_t index) const noexcept {
+    // slab k contains FIRST_SLAB_BLOCKS << k blocks, so slab k starts at index FIRST_SLAB_BLOCKS * (2^k - 1)
+    uint64_t group = index / FIRST_SLAB_BLOCKS + 1;
+    auto k = static_cast<uint64_t>(std::bit_width(group) - 1);
+    uint64_t offset = index - FIRST_SLAB_BLOCKS * ((1ull << k) - 1);
+    auto *slab = _classes[sizeClass].slabs[k].load(std::memory_order_acquire);
+    return reinterpret_cast<BlockHeader*>(slab + offset * (HEADER_SIZE + blockSizeFor(sizeClass)));
+}
+
+Ichor::EventSlabAllocator::BlockHeader* Ichor::EventSlabAllocator::popFree(uint64_t sizeClass) noexcept {
+    auto &cls = _classes[sizeClass];
+    uint64_t head = cls.freeHead.load(std::memory_order_acquire);
+
+    while(true) {
+        auto first = static_cast<uint32_t>(head);
+        if(first == 0) {
+            return nullptr;
+        }
+
+        // the block might be popped and handed out by another thread in the meantime, in which case the tag makes the exchange fail
+        auto *block = blockAt(sizeClass, first - 1);
+        uint64_t newHead = (((head >> 32) + 1) << 32) | block->next.load(std::memory_order_relaxed);
+        if(cls.freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+            return block;
+        }
+    }
+}
+
+void Ichor::EventSlabAllocator::pushFree(uint64_t sizeClass, BlockHeader *first, BlockHeader *last) noexcept {
+    auto &cls = _classes[sizeClass];
+    uint64_t head = cls.freeHead.load(std::memory_order_relaxed);
+
+    while(true) {
+        last->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        uint64_t newHead = (((head >> 32) + 1) << 32) | (first->index + 1);
+        if(cls.freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+Ichor::EventSlabAllocator::BlockHeader* Ichor::EventSlabAllocator::grow(uint64_t sizeClass) {
+    auto &cls = _classes[sizeClass];
+    std::lock_guard lck(cls.growMutex);
+
+    // another thread might have grown the size class while we were waiting
+    if(auto *block = popFree(sizeClass); block != nullptr) {
+        return block;
+    }
+
+    if(cls.slabCount == MAX_SLABS) {
+        throw std::bad_alloc();
+    }
+
+    uint64_t k = cls.slabCount;
+    uint64_t blocks = FIRST_SLAB_BLOCKS << k;
+    uint64_t stride = HEADER_SIZE + blockSizeFor(sizeClass);
+    auto *slab = static_cast<std::byte*>(_upstream->allocate(blocks * stride, HEADER_SIZE));
+    auto firstIndex = static_cast<uint32_t>(FIRST_SLAB_BLOCKS * ((1ull << k) - 1));
+
+    for(uint64_t i = 0; i < blocks; i++) {
+        auto *block = new (slab + i * stride) BlockHeader{};
+        block->index = firstIndex + static_cast<uint32_t>(i);
+        block->next.store(i + 1 < blocks ? firstIndex + static_cast<uint32_t>(i) + 2 : 0, std::memory_order_relaxed);
+    }
+
+    cls.slabs[k].store(slab, std::memory_order_release);
+    cls.slabCount++;
+    cls.capacity.fetch_add(blocks, std::memory_order_relaxed);
+
+    // hand out the first block, the rest goes to the free list
+    auto *first = reinterpret_cast<BlockHeader*>(slab);
+    pushFree(sizeClass, reinterpret_cast<BlockHeader*>(slab + stride), reinterpret_cast<BlockHeader*>(slab + (blocks - 1) * stride));
+    return first;
+}
@@ -0,0 +1,184 @@
+#include <ichor/optional_bundles/network_bundle/NetworkBuffer.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace Ichor::Detail {
+    struct NetworkBufferPoolState final {
+        NetworkBufferPoolState(std::pmr::memory_resource *_rsrc, uint32_t _minSize, uint32_t _maxSize) : rsrc(_rsrc), free(_rsrc), minSize(_minSize), maxSize(_maxSize), bufferSize(_minSize) {}
+
+        std::pmr::memory_resource *rsrc;
+        std::pmr::vector<NetworkBufferBlock*> free;
+        uint32_t minSize;
+        uint32_t maxSize;
+        uint32_t bufferSize;
+        uint32_t smallReads{};
+        bool poolAlive{true};
+        uint64_t allocations{};
+        uint64_t recycled{};
+        uint64_t live{};
+    };
+
+    static NetworkBufferBlock* allocateBlock(std::pmr::memory_resource *rsrc, NetworkBufferPoolState *pool, uint32_t capacity) {
+        auto *mem = rsrc->allocate(sizeof(NetworkBufferBlock) + capacity, alignof(NetworkBufferBlock));
+        return new (mem) NetworkBufferBlock{pool, rsrc, 1, capacity};
+    }
+
+    static void deallocateBlock(NetworkBufferBlock *block) noexcept {
+        block->rsrc->deallocate(block, sizeof(NetworkBufferBlock) + block->capacity, alignof(NetworkBufferBlock));
+    }
+
+    static void destroyState(NetworkBufferPoolState *state) noexcept {
+        auto *rsrc = state->rsrc;
+        state->~NetworkBufferPoolState();
+        rsrc->deallocate(state, sizeof(NetworkBufferPoolState), alignof(NetworkBufferPoolState));
+    }
+}
+
+Ichor::NetworkBuffer::NetworkBuffer(const NetworkBuffer &o) noexcept : _block(o._block), _size(o._size) {
+    if(_block != nullptr) {
+        _block->refs++;
+    }
+}
+
+Ichor::NetworkBuffer::NetworkBuffer(NetworkBuffer &&o) noexcept : _block(o._block), _size(o._size) {
+    o._block = nullptr;
+    o._size = 0;
+}
+
+Ichor::NetworkBuffer& Ichor::NetworkBuffer::operator=(const NetworkBuffer &o) noexcept {
+    if(this != &o) {
+        if(o._block != nullptr) {
+            o._block->refs++;
+        }
+        release();
+        _block = o._block;
+        _size = o._size;
+    }
+    return *this;
+}
+
+Ichor::NetworkBuffer& Ichor::NetworkBuffer::operator=(NetworkBuffer &&o) noexcept {
+    if(this != &o) {
+        release();
+        _block = o._block;
+        _size = o._size;
+        o._block = nullptr;
+        o._size = 0;
+    }
+    return *this;
+}
+
+Ichor::NetworkBuffer::~NetworkBuffer() {
+    release();
+}
+
+Ichor::NetworkBuffer Ichor::NetworkBuffer::copyOf(std::span<uint8_t const> bytes, std::pmr::memory_resource *rsrc) {
+    auto *block = Detail::allocateBlock(rsrc, nullptr, static_cast<uint32_t>(bytes.size()));
+    std::memcpy(block->bytes(), bytes.data(), bytes.size());
+    return NetworkBuffer{block, static_cast<uint32_t>(bytes.size())};
+}
+
+void Ichor::NetworkBuffer::release() noexcept {
+    if(_block == nullptr) {
+        return;
+    }
+
+    auto *block = _block;
+    _block = nullptr;
+    _size = 0;
+
+    if(--block->refs != 0) {
+        return;
+    }
+
+    auto *pool = block->pool;
+    if(pool == nullptr) {
+        Detail::deallocateBlock(block);
+        return;
+    }
+
+    pool->live--;
+
+    if(pool->poolAlive && block->capacity == pool->bufferSize && pool->free.size() < NetworkBufferPool::MAX_CACHED_BUFFERS) {
+        pool->free.push_back(block);
+        return;
+    }
+
+    Detail::deallocateBlock(block);
+
+    // the last outstanding buffer of a destroyed pool cleans up after it
+    if(!pool->poolAlive && pool->live == 0) {
+        Detail::destroyState(pool);
+    }
+}
+
+Ichor::NetworkBufferPool::NetworkBufferPool(std::pmr::memory_resource *rsrc, uint32_t minSize, uint32_t maxSize) {
+    if(minSize == 0 || maxSize < minSize) {
+        throw std::runtime_error("NetworkBufferPool requires 0 < minSize <= maxSize");
+    }
+
+    auto *mem = rsrc->allocate(sizeof(Detail::NetworkBufferPoolState), alignof(Detail::NetworkBufferPoolState));
+    _state = new (mem) Detail::NetworkBufferPoolState(rsrc, minSize, maxSize);
+    _state->free.reserve(MAX_CACHED_BUFFERS);
+}
+
+Ichor::NetworkBufferPool::~NetworkBufferPool() {
+    for(auto *block : _state->free) {
+        Detail::deallocateBlock(block);
+    }
+    _state->free.clear();
+    _state->poolAlive = false;
+
+    if(_state->live == 0) {
+        Detail::destroyState(_state);
+    }
+}
+
+Ichor::NetworkBuffer Ichor::NetworkBufferPool::acquire() {
+    _state->allocations++;
+    _state->live++;
+
+    if(!_state->free.empty()) {
+        auto *block = _state->free.back();
+        _state->free.pop_back();
+        block->refs = 1;
+        _state->recycled++;
+        return NetworkBuffer{block, block->capacity};
+    }
+
+    auto *block = Detail::allocateBlock(_state->rsrc, _state, _state->bufferSize);
+    return NetworkBuffer{block, block->capacity};
+}
+
+void Ichor::NetworkBufferPool::commit(NetworkBuffer &buffer, uint32_t received) noexcept {
+    buffer._size = std::min(received, buffer.capacity());
+
+    auto const capacity = buffer.capacity();
+    auto const oldSize = _state->bufferSize;
+    if(received >= capacity) {
+        _state->smallReads = 0;
+        _state->bufferSize = static_cast<uint32_t>(std::min<uint64_t>(uint64_t{std::max(capacity, oldSize)} * 2, _state->maxSize));
+    } else if(received < capacity / 4) {
+        if(++_state->smallReads >= SHRINK_AFTER) {
+            _state->smallReads = 0;
+            _state->bufferSize = std::max(oldSize / 2, _state->minSize);
+        }
+    } else {
+        _state->smallReads = 0;
+    }
+
+    // cached buffers of the old size would never be handed out again
+    if(_state->bufferSize != oldSize) {
+        for(auto *block : _state->free) {
+            Detail::deallocateBlock(block);
+        }
+        _state->free.clear();
+    }
+}
+
+Ichor::NetworkBufferPoolStatistics Ichor::NetworkBufferPool::getStatistics() const noexcept {
+    return NetworkBufferPoolStatistics{_state->allocations, _state->recycled, _state->live, _state->free.size(), _state->bufferSize};
+}
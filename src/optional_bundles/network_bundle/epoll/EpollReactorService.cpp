@@ -0,0 +1,153 @@
+#include <ichor/DependencyManager.h>
+#include <ichor/optional_bundles/network_bundle/epoll/EpollReactorService.h>
+#include <array>
+#include <cstring>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+    uint32_t toEpollEvents(uint32_t interest) noexcept {
+        uint32_t events = EPOLLET | EPOLLRDHUP;
+        if(interest & Ichor::IReactor::READABLE) {
+            events |= EPOLLIN;
+        }
+        if(interest & Ichor::IReactor::WRITABLE) {
+            events |= EPOLLOUT;
+        }
+        return events;
+    }
+
+    uint64_t toEpollData(int fd, uint32_t generation) noexcept {
+        return static_cast<uint64_t>(static_cast<uint32_t>(fd)) | (static_cast<uint64_t>(generation) << 32);
+    }
+}
+
+Ichor::EpollReactorService::EpollReactorService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _registrations(getMemoryResource()) {
+    reg.registerDependency<ILogger>(this, false);
+}
+
+Ichor::EpollReactorService::~EpollReactorService() {
+    if(_epollFd >= 0) {
+        ::close(_epollFd);
+    }
+}
+
+Ichor::StartBehaviour Ichor::EpollReactorService::start() {
+    _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if(_epollFd < 0) {
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Couldn't create epoll: errno = " + std::to_string(errno));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    _ioSourceId = getManager()->addIoSource(_epollFd, Ichor::function<void()>{[this]() { poll(); }, getMemoryResource()});
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::StartBehaviour Ichor::EpollReactorService::stop() {
+    getManager()->removeIoSource(_ioSourceId);
+    _registrations.clear();
+    ::close(_epollFd);
+    _epollFd = -1;
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+void Ichor::EpollReactorService::addDependencyInstance(ILogger *logger, IService *) {
+    _logger = logger;
+}
+
+void Ichor::EpollReactorService::removeDependencyInstance(ILogger *logger, IService *) {
+    _logger = nullptr;
+}
+
+void Ichor::EpollReactorService::addFd(int fd, uint32_t interest, Ichor::function<void(uint32_t)> onReady) {
+    if(fd < 0) {
+        throw std::runtime_error("Invalid file descriptor");
+    }
+
+    auto idx = static_cast<uint64_t>(fd);
+    if(idx >= _registrations.size()) {
+        _registrations.resize(idx + 1);
+    }
+
+    auto &registration = _registrations[idx];
+    if(registration.active) {
+        throw std::runtime_error("File descriptor already added to reactor");
+    }
+
+    epoll_event evt{};
+    evt.events = toEpollEvents(interest);
+    evt.data.u64 = toEpollData(fd, registration.generation);
+    if(::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &evt) != 0) {
+        throw std::runtime_error(std::string{"Couldn't add fd to epoll: "} + std::strerror(errno));
+    }
+
+    registration.onReady = std::move(onReady);
+    registration.active = true;
+}
+
+void Ichor::EpollReactorService::modifyFd(int fd, uint32_t interest) {
+    auto idx = static_cast<uint64_t>(fd);
+    if(fd < 0 || idx >= _registrations.size() || !_registrations[idx].active) {
+        throw std::runtime_error("File descriptor not added to reactor");
+    }
+
+    epoll_event evt{};
+    evt.events = toEpollEvents(interest);
+    evt.data.u64 = toEpollData(fd, _registrations[idx].generation);
+    if(::epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &evt) != 0) {
+        throw std::runtime_error(std::string{"Couldn't modify fd in epoll: "} + std::strerror(errno));
+    }
+}
+
+void Ichor::EpollReactorService::removeFd(int fd) noexcept {
+    auto idx = static_cast<uint64_t>(fd);
+    if(fd < 0 || idx >= _registrations.size() || !_registrations[idx].active) {
+        return;
+    }
+
+    ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    auto &registration = _registrations[idx];
+    registration.onReady = {};
+    registration.active = false;
+    // events for fd that were already returned by epoll_wait are ignored from now on
+    registration.generation++;
+}
+
+void Ichor::EpollReactorService::poll() {
+    std::array<epoll_event, 64> events{};
+    int ret = ::epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), 0);
+    if(ret < 0 && errno != EINTR) {
+        ICHOR_LOG_ERROR(_logger, "epoll_wait failed: {}", errno);
+        return;
+    }
+
+    for(int i = 0; i < ret; i++) {
+        auto &evt = events[static_cast<uint64_t>(i)];
+        auto fd = static_cast<uint64_t>(evt.data.u64 & 0xFFFF'FFFFu);
+        auto generation = static_cast<uint32_t>(evt.data.u64 >> 32);
+        if(fd >= _registrations.size() || !_registrations[fd].active || _registrations[fd].generation != generation) {
+            continue;
+        }
+
+        uint32_t ready{};
+        if(evt.events & EPOLLIN) {
+            ready |= READABLE;
+        }
+        if(evt.events & EPOLLOUT) {
+            ready |= WRITABLE;
+        }
+        if(evt.events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            ready |= CLOSED;
+        }
+
+        // the callback can remove its own registration or add new ones, which reallocates _registrations
+        auto onReady = std::move(_registrations[fd].onReady);
+        onReady(ready);
+
+        if(fd < _registrations.size() && _registrations[fd].active && _registrations[fd].generation == generation) {
+            _registrations[fd].onReady = std::move(onReady);
+        }
+    }
+}
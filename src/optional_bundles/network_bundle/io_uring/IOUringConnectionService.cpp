@@ -0,0 +1,298 @@
+#ifdef ICHOR_USE_IO_URING
+
+#include <ichor/DependencyManager.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringConnectionService.h>
+#include <ichor/optional_bundles/network_bundle/NetworkEvents.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <cstring>
+
+Ichor::IOUringConnectionService::IOUringConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _priority(INTERNAL_EVENT_PRIORITY), _msgIdCounter(), _quit(), _chain(getMemoryResource()), _queued(getMemoryResource()) {
+    reg.registerDependency<ILogger>(this, true);
+    reg.registerDependency<IIOUringQueue>(this, true);
+}
+
+Ichor::StartBehaviour Ichor::IOUringConnectionService::start() {
+    if(getProperties().contains("Priority")) {
+        _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
+    }
+
+    if(!_buffers) {
+        uint32_t minSize = DEFAULT_MIN_RECEIVE_BUFFER_SIZE;
+        uint32_t maxSize = DEFAULT_MAX_RECEIVE_BUFFER_SIZE;
+        if(getProperties().contains("MinReceiveBufferSize")) {
+            minSize = Ichor::any_cast<uint32_t>(getProperties().operator[]("MinReceiveBufferSize"));
+        }
+        if(getProperties().contains("MaxReceiveBufferSize")) {
+            maxSize = Ichor::any_cast<uint32_t>(getProperties().operator[]("MaxReceiveBufferSize"));
+        }
+        _buffers.emplace(getMemoryResource(), minSize, maxSize);
+    }
+    if(getProperties().contains("Socket")) {
+        _socket = Ichor::any_cast<int>(getProperties().operator[]("Socket"));
+        _accepted = true;
+
+        ICHOR_LOG_TRACE(_logger, "Starting io_uring connection for existing socket");
+    } else {
+        if(!getProperties().contains("Address")) {
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Missing \"Address\" in properties");
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        if(!getProperties().contains("Port")) {
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 1, "Missing \"Port\" in properties");
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        // The start function possibly gets called multiple times due to trying to recover from not being able to connect
+        if(_socket == -1) {
+            _socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (_socket == -1) {
+                getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "Couldn't create socket: errno = " + std::to_string(errno));
+                return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+            }
+        }
+
+        _address = {};
+        _address.sin_family = AF_INET;
+        _address.sin_port = htons(Ichor::any_cast<uint16_t>((getProperties())["Port"]));
+
+        int ret = inet_pton(AF_INET, Ichor::any_cast<std::string&>((getProperties())["Address"]).c_str(), &_address.sin_addr);
+        if(ret == 0)
+        {
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "inet_pton invalid address for given address family (has to be ipv4-valid address)");
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        // connecting can take up to the TCP connect timeout, so it is done by the ring instead of blocking the event loop. Until it completes, sent messages stay queued.
+        auto *sqe = _queue->getSqe(_socket, IOUringCompletion{[this](int32_t res, uint32_t) { onConnect(res); }, getMemoryResource()});
+        sqe->opcode = IORING_OP_CONNECT;
+        sqe->addr = reinterpret_cast<uint64_t>(&_address);
+        sqe->off = sizeof(_address);
+        _queue->submit();
+        _connecting = true;
+
+        auto ip = ::inet_ntoa(_address.sin_addr);
+        ICHOR_LOG_TRACE(_logger, "Starting io_uring connection for {}:{}", ip, ::ntohs(_address.sin_port));
+    }
+
+    int setting = 1;
+    ::setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+
+    _quit = false;
+    _readClosed = false;
+    if(!_connecting) {
+        armRecv();
+    }
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::StartBehaviour Ichor::IOUringConnectionService::stop() {
+    _quit = true;
+
+    cancel();
+
+    if(_socket >= 0) {
+        ::shutdown(_socket, SHUT_RDWR);
+        ::close(_socket);
+    }
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+void Ichor::IOUringConnectionService::addDependencyInstance(ILogger *logger, IService *) {
+    _logger = logger;
+}
+
+void Ichor::IOUringConnectionService::removeDependencyInstance(ILogger *logger, IService *) {
+    _logger = nullptr;
+}
+
+void Ichor::IOUringConnectionService::addDependencyInstance(IIOUringQueue *queue, IService *) {
+    _queue = queue;
+}
+
+void Ichor::IOUringConnectionService::removeDependencyInstance(IIOUringQueue *queue, IService *) {
+    // the queue goes away before this service is stopped
+    cancel();
+    _queue = nullptr;
+}
+
+uint64_t Ichor::IOUringConnectionService::sendAsync(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> &&msg) {
+    auto id = ++_msgIdCounter;
+
+    if(_quit || _queue == nullptr) {
+        getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), id);
+        return id;
+    }
+
+    _queued.push_back(Message{id, std::move(msg)});
+    if(_sendsInFlight == 0 && !_connecting) {
+        submitChain();
+    }
+
+    return id;
+}
+
+void Ichor::IOUringConnectionService::setPriority(uint64_t priority) {
+    _priority = priority;
+}
+
+uint64_t Ichor::IOUringConnectionService::getPriority() {
+    return _priority;
+}
+
+void Ichor::IOUringConnectionService::onConnect(int32_t res) {
+    _connecting = false;
+
+    if(res < 0) {
+        ICHOR_LOG_ERROR(_logger, "connect error {}", -res);
+        getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 5, "Couldn't connect. errno = " + std::to_string(-res));
+        _readClosed = true;
+        failQueued();
+        return;
+    }
+
+    ICHOR_LOG_TRACE(_logger, "Connected");
+    armRecv();
+    if(!_queued.empty()) {
+        submitChain();
+    }
+}
+
+void Ichor::IOUringConnectionService::armRecv() {
+    auto *sqe = _queue->getSqe(_socket, IOUringCompletion{[this](int32_t res, uint32_t flags) { onRecv(res, flags); }, getMemoryResource()});
+    sqe->opcode = IORING_OP_RECV;
+    sqe->ioprio |= IORING_RECV_MULTISHOT;
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = _queue->getBufferGroup();
+    _queue->submit();
+    _receiving = true;
+}
+
+void Ichor::IOUringConnectionService::onRecv(int32_t res, uint32_t flags) {
+    if(flags & IORING_CQE_F_BUFFER) {
+        auto bufferId = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        auto received = _queue->getBuffer(bufferId).first(static_cast<uint64_t>(std::max(res, 0)));
+        while(!received.empty()) {
+            auto buf = _buffers->acquire();
+            auto size = std::min<uint64_t>(received.size(), buf.capacity());
+            std::memcpy(buf.data().data(), received.data(), size);
+            _buffers->commit(buf, static_cast<uint32_t>(size));
+            getManager()->pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, std::move(buf));
+            received = received.subspan(size);
+        }
+        _queue->recycleBuffer(bufferId);
+    }
+
+    if(flags & IORING_CQE_F_MORE) {
+        return;
+    }
+    _receiving = false;
+
+    if(res == 0) {
+        ICHOR_LOG_TRACE(_logger, "Peer closed connection");
+        _readClosed = true;
+        removeWhenDone();
+        return;
+    }
+
+    // ran out of provided buffers, the multishot recv stops until it is armed again
+    if(res > 0 || res == -ENOBUFS) {
+        if(!_quit) {
+            armRecv();
+        }
+        return;
+    }
+
+    ICHOR_LOG_ERROR(_logger, "Error receiving from socket: {}", -res);
+    getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Error receiving from socket. errno = " + std::to_string(-res));
+    _readClosed = true;
+    removeWhenDone();
+}
+
+void Ichor::IOUringConnectionService::submitChain() {
+    // a chain cannot span multiple submissions, so it is limited in length
+    auto length = std::min<uint64_t>(_queued.size(), MAX_CHAIN_LENGTH);
+    for(uint64_t i = 0; i < length; i++) {
+        _chain.push_back(std::move(_queued[i]));
+    }
+    _queued.erase(_queued.begin(), _queued.begin() + static_cast<int64_t>(length));
+
+    for(uint64_t i = 0; i < length; i++) {
+        auto &msg = _chain[i];
+        auto *sqe = _queue->getSqe(_socket, IOUringCompletion{[this, i](int32_t res, uint32_t) { onSent(i, res); }, getMemoryResource()});
+        sqe->opcode = IORING_OP_SEND;
+        sqe->addr = reinterpret_cast<uint64_t>(msg.data.data());
+        sqe->len = static_cast<uint32_t>(msg.data.size());
+        // keeps sending until everything is sent, instead of completing with a short count
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        // when a send fails, the rest of the chain is cancelled instead of sending out of order
+        if(i + 1 < length) {
+            sqe->flags |= IOSQE_IO_LINK;
+        }
+    }
+
+    _sendsInFlight = length;
+    _queue->submit();
+}
+
+void Ichor::IOUringConnectionService::onSent(uint64_t idx, int32_t res) {
+    auto &msg = _chain[idx];
+    msg.completed = true;
+    if(res < 0 || static_cast<uint64_t>(res) != msg.data.size()) {
+        getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg.data), msg.id);
+    }
+
+    _sendsInFlight--;
+    if(_sendsInFlight != 0) {
+        return;
+    }
+
+    _chain.clear();
+    if(!_queued.empty() && !_quit) {
+        submitChain();
+        return;
+    }
+
+    removeWhenDone();
+}
+
+void Ichor::IOUringConnectionService::removeWhenDone() {
+    if(!_accepted || !_readClosed || _sendsInFlight != 0 || !_queued.empty() || _removing) {
+        return;
+    }
+
+    // pushed after the data events of this connection, so their handlers still see the connection
+    _removing = true;
+    getManager()->pushPrioritisedEvent<RemoveServiceEvent>(getServiceId(), _priority, getServiceId());
+}
+
+void Ichor::IOUringConnectionService::cancel() {
+    if(_queue != nullptr && (_receiving || _sendsInFlight != 0 || _connecting)) {
+        _queue->cancelFd(_socket);
+    }
+    _receiving = false;
+    _connecting = false;
+    _sendsInFlight = 0;
+    failQueued();
+}
+
+void Ichor::IOUringConnectionService::failQueued() {
+    // the completions of cancelled sends are not called anymore, so the part of the chain that did not complete failed as well
+    for(auto &msg : _chain) {
+        if(!msg.completed) {
+            getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg.data), msg.id);
+        }
+    }
+    _chain.clear();
+    for(auto &msg : _queued) {
+        getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg.data), msg.id);
+    }
+    _queued.clear();
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifdef ICHOR_USE_IO_URING
+
+#include <ichor/DependencyManager.h>
+#include <ichor/optional_bundles/network_bundle/IConnectionService.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringHostService.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <netdb.h>
+
+Ichor::IOUringHostService::IOUringHostService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _priority(INTERNAL_EVENT_PRIORITY), _quit() {
+    reg.registerDependency<ILogger>(this, true);
+    reg.registerDependency<IIOUringQueue>(this, true);
+}
+
+Ichor::StartBehaviour Ichor::IOUringHostService::start() {
+    if(getProperties().contains("Priority")) {
+        _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
+    }
+
+    _socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(_socket == -1) {
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Couldn't create socket: errno = " + std::to_string(errno));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    int setting = 1;
+    ::setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &setting, sizeof(setting));
+    ::setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+
+    if(getProperties().contains("ReusePort") && Ichor::any_cast<bool>(getProperties().operator[]("ReusePort"))) {
+        if(::setsockopt(_socket, SOL_SOCKET, SO_REUSEPORT, &setting, sizeof(setting)) != 0) {
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 5, "Couldn't set SO_REUSEPORT: errno = " + std::to_string(errno));
+            ::close(_socket);
+            _socket = -1;
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+    }
+
+    int backlog = SOMAXCONN;
+    if(getProperties().contains("Backlog")) {
+        backlog = Ichor::any_cast<int>(getProperties().operator[]("Backlog"));
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+
+    auto const addressProp = getProperties().find("Address");
+
+    if(addressProp != cend(getProperties())) {
+        auto hostname = Ichor::any_cast<std::string>(addressProp->second);
+        if(::inet_aton(hostname.c_str(), &address.sin_addr) == 0) {
+            auto hp = ::gethostbyname(hostname.c_str());
+            if (hp == nullptr) {
+                ::close(_socket);
+                _socket = -1;
+                getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "gethostbyname: errno = " + std::to_string(errno));
+                return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+            }
+
+            address.sin_addr = *(struct in_addr *) hp->h_addr;
+        }
+    } else {
+        address.sin_addr.s_addr = INADDR_ANY;
+    }
+    address.sin_port = ::htons(Ichor::any_cast<uint16_t>((getProperties())["Port"]));
+
+    if(::bind(_socket, (sockaddr *)&address, sizeof(address)) == -1) {
+        ::close(_socket);
+        _socket = -1;
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "Couldn't bind socket: errno = " + std::to_string(errno));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    if(::listen(_socket, backlog) != 0) {
+        ::close(_socket);
+        _socket = -1;
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Couldn't listen on socket: errno = " + std::to_string(errno));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    _quit = false;
+    armAccept();
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::StartBehaviour Ichor::IOUringHostService::stop() {
+    _quit = true;
+
+    if(_accepting) {
+        _queue->cancelFd(_socket);
+        _accepting = false;
+    }
+
+    if(_socket >= 0) {
+        ::shutdown(_socket, SHUT_RDWR);
+        ::close(_socket);
+        _socket = -1;
+    }
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+void Ichor::IOUringHostService::addDependencyInstance(ILogger *logger, IService *) {
+    _logger = logger;
+}
+
+void Ichor::IOUringHostService::removeDependencyInstance(ILogger *logger, IService *) {
+    _logger = nullptr;
+}
+
+void Ichor::IOUringHostService::addDependencyInstance(IIOUringQueue *queue, IService *) {
+    _queue = queue;
+}
+
+void Ichor::IOUringHostService::removeDependencyInstance(IIOUringQueue *queue, IService *) {
+    // the queue goes away before this service is stopped
+    if(_accepting) {
+        _queue->cancelFd(_socket);
+        _accepting = false;
+    }
+    _queue = nullptr;
+}
+
+void Ichor::IOUringHostService::setPriority(uint64_t priority) {
+    _priority = priority;
+}
+
+uint64_t Ichor::IOUringHostService::getPriority() {
+    return _priority;
+}
+
+void Ichor::IOUringHostService::armAccept() {
+    auto *sqe = _queue->getSqe(_socket, IOUringCompletion{[this](int32_t res, uint32_t flags) { onAccept(res, flags); }, getMemoryResource()});
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    _queue->submit();
+    _accepting = true;
+}
+
+void Ichor::IOUringHostService::onAccept(int32_t res, uint32_t flags) {
+    if(res >= 0) {
+        ICHOR_LOG_TRACE(_logger, "new connection {}", res);
+
+        Properties props{};
+        props.emplace("Priority", Ichor::make_any<uint64_t>(getMemoryResource(), _priority));
+        props.emplace("Socket", Ichor::make_any<int>(getMemoryResource(), res));
+        getManager()->template createServiceManager<IOUringConnectionService, IConnectionService>(std::move(props));
+    } else if(res != -ECONNABORTED) {
+        ICHOR_LOG_ERROR(_logger, "accept failed: errno {}", -res);
+        if(res == -EINVAL) {
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(-res));
+            _accepting = (flags & IORING_CQE_F_MORE) != 0;
+            return;
+        }
+        getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(-res));
+    }
+
+    if((flags & IORING_CQE_F_MORE) == 0) {
+        _accepting = false;
+        if(!_quit) {
+            armAccept();
+        }
+    }
+}
+
+#endif
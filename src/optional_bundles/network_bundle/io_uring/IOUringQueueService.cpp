@@ -0,0 +1,395 @@
+#ifdef ICHOR_USE_IO_URING
+
+#include <ichor/DependencyManager.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringQueueService.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    // completions of cancel requests are recognised by this bit, operation generations never reach it
+    constexpr uint64_t CANCEL_USER_DATA = 1ull << 63;
+    constexpr uint32_t GENERATION_MASK = 0x7FFF'FFFFu;
+
+    int ioUringSetup(uint32_t entries, io_uring_params *params) noexcept {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int ioUringEnter(int fd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags) noexcept {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    int ioUringRegister(int fd, uint32_t opcode, void *arg, uint32_t nrArgs) noexcept {
+        return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+    }
+
+    // the rings are shared with the kernel
+    uint32_t loadAcquire(uint32_t *p) noexcept {
+        return std::atomic_ref<uint32_t>{*p}.load(std::memory_order_acquire);
+    }
+
+    void storeRelease(uint32_t *p, uint32_t value) noexcept {
+        std::atomic_ref<uint32_t>{*p}.store(value, std::memory_order_release);
+    }
+}
+
+Ichor::IOUringQueueService::IOUringQueueService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _operations(getMemoryResource()), _freeOperations(getMemoryResource()), _pendingCompletions(getMemoryResource()) {
+    reg.registerDependency<ILogger>(this, false);
+}
+
+Ichor::IOUringQueueService::~IOUringQueueService() {
+    unmap();
+}
+
+Ichor::StartBehaviour Ichor::IOUringQueueService::start() {
+    if(getProperties().contains("Entries")) {
+        _entries = Ichor::any_cast<uint32_t>(getProperties().operator[]("Entries"));
+    }
+    if(getProperties().contains("BufferCount")) {
+        _bufferCount = Ichor::any_cast<uint32_t>(getProperties().operator[]("BufferCount"));
+    }
+    if(getProperties().contains("BufferSize")) {
+        _bufferSize = Ichor::any_cast<uint32_t>(getProperties().operator[]("BufferSize"));
+    }
+
+    if(_bufferCount == 0 || _bufferCount > 32768 || (_bufferCount & (_bufferCount - 1)) != 0) {
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "BufferCount has to be a power of two, at most 32768");
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = _entries * 4;
+    _ringFd = ioUringSetup(_entries, &params);
+    if(_ringFd < 0) {
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 1, "Couldn't set up io_uring: errno = " + std::to_string(errno));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    _ringSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+        _ringSize = std::max(_ringSize, _cqRingSize);
+    }
+
+    _ringPtr = ::mmap(nullptr, _ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+    if(_ringPtr == MAP_FAILED) {
+        _ringPtr = nullptr;
+        auto err = errno;
+        unmap();
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "Couldn't map io_uring: errno = " + std::to_string(err));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cqRingPtr = _ringPtr;
+    } else {
+        _cqRingPtr = ::mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+        if(_cqRingPtr == MAP_FAILED) {
+            _cqRingPtr = nullptr;
+            auto err = errno;
+            unmap();
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "Couldn't map io_uring: errno = " + std::to_string(err));
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+    }
+
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    auto *sqes = ::mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) {
+        auto err = errno;
+        unmap();
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "Couldn't map io_uring: errno = " + std::to_string(err));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto *sq = static_cast<uint8_t*>(_ringPtr);
+    _sqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    _sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    _sqFlags = reinterpret_cast<uint32_t*>(sq + params.sq_off.flags);
+    _sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    _sqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    _sqCapacity = params.sq_entries;
+    _sqLocalTail = *_sqTail;
+    _sqSubmittedTail = _sqLocalTail;
+
+    auto *cq = static_cast<uint8_t*>(_cqRingPtr);
+    _cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    _cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    _cqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // provided buffers, the kernel picks one whenever a recv with IOSQE_BUFFER_SELECT has data
+    _bufferRingSize = _bufferCount * sizeof(io_uring_buf);
+    auto *bufferRing = ::mmap(nullptr, _bufferRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    _buffersSize = static_cast<size_t>(_bufferCount) * _bufferSize;
+    auto *buffers = ::mmap(nullptr, _buffersSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if(bufferRing == MAP_FAILED || buffers == MAP_FAILED) {
+        auto err = errno;
+        if(bufferRing != MAP_FAILED) {
+            ::munmap(bufferRing, _bufferRingSize);
+        }
+        if(buffers != MAP_FAILED) {
+            ::munmap(buffers, _buffersSize);
+        }
+        unmap();
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "Couldn't allocate provided buffers: errno = " + std::to_string(err));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+    // the flexible array of io_uring_buf_ring does not start at offset 0 when compiled as C++, so the ring is accessed as an array of entries
+    _bufferRing = static_cast<io_uring_buf*>(bufferRing);
+    _buffers = static_cast<uint8_t*>(buffers);
+
+    io_uring_buf_reg bufferReg{};
+    bufferReg.ring_addr = reinterpret_cast<uint64_t>(_bufferRing);
+    bufferReg.ring_entries = _bufferCount;
+    bufferReg.bgid = getBufferGroup();
+    if(ioUringRegister(_ringFd, IORING_REGISTER_PBUF_RING, &bufferReg, 1) < 0) {
+        auto err = errno;
+        unmap();
+        getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Couldn't register provided buffers: errno = " + std::to_string(err));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    _bufferRingTail = 0;
+    for(uint32_t i = 0; i < _bufferCount; i++) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+
+    _ioSourceId = getManager()->addIoSource(_ringFd, Ichor::function<void()>{[this]() { reap(); }, getMemoryResource()});
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::StartBehaviour Ichor::IOUringQueueService::stop() {
+    getManager()->removeIoSource(_ioSourceId);
+    _operations.clear();
+    _freeOperations.clear();
+    _pendingCompletions.clear();
+    unmap();
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+void Ichor::IOUringQueueService::addDependencyInstance(ILogger *logger, IService *) {
+    _logger = logger;
+}
+
+void Ichor::IOUringQueueService::removeDependencyInstance(ILogger *logger, IService *) {
+    _logger = nullptr;
+}
+
+io_uring_sqe* Ichor::IOUringQueueService::getSqe(int fd, IOUringCompletion onCompletion) {
+    if(_sqLocalTail - loadAcquire(_sqHead) >= _sqCapacity) {
+        submit();
+    }
+
+    uint32_t idx;
+    if(!_freeOperations.empty()) {
+        idx = _freeOperations.back();
+        _freeOperations.pop_back();
+    } else {
+        idx = static_cast<uint32_t>(_operations.size());
+        _operations.emplace_back();
+    }
+
+    auto &operation = _operations[idx];
+    operation.onCompletion = std::move(onCompletion);
+    operation.fd = fd;
+    operation.active = true;
+
+    auto slot = _sqLocalTail & _sqMask;
+    auto *sqe = &_sqes[slot];
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->fd = fd;
+    sqe->user_data = static_cast<uint64_t>(idx) | (static_cast<uint64_t>(operation.generation) << 32);
+    _sqArray[slot] = slot;
+    _sqLocalTail++;
+
+    return sqe;
+}
+
+void Ichor::IOUringQueueService::submit() {
+    storeRelease(_sqTail, _sqLocalTail);
+
+    while(_sqSubmittedTail != _sqLocalTail) {
+        int ret = ioUringEnter(_ringFd, _sqLocalTail - _sqSubmittedTail, 0, 0);
+        if(ret < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            // the completion queue is full, make room before trying again
+            if(errno == EBUSY || errno == EAGAIN) {
+                pullCompletions();
+                continue;
+            }
+            throw std::runtime_error(std::string{"Couldn't submit to io_uring: "} + std::strerror(errno));
+        }
+        _sqSubmittedTail += static_cast<uint32_t>(ret);
+    }
+}
+
+void Ichor::IOUringQueueService::cancelFd(int fd) {
+    for(uint32_t idx = 0; idx < _operations.size(); idx++) {
+        if(_operations[idx].active && _operations[idx].fd == fd) {
+            release(idx);
+        }
+    }
+
+    auto *sqe = getSqe(fd, {});
+    // not an operation, the slot is freed right away
+    release(static_cast<uint32_t>(sqe->user_data & 0xFFFF'FFFFu));
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = CANCEL_USER_DATA | ++_cancelCounter;
+    submit();
+
+    // wait for the cancel request to complete, everything it cancelled has completed by then. Other completions stay queued for the event loop.
+    while(!cancelCompleted()) {
+        auto available = loadAcquire(_cqTail) - *_cqHead;
+        if(available > _cqMask) {
+            pullCompletions();
+            available = 0;
+        }
+        if(ioUringEnter(_ringFd, 0, available + 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            ICHOR_LOG_ERROR(_logger, "Waiting for cancellation failed: {}", errno);
+            return;
+        }
+    }
+}
+
+uint16_t Ichor::IOUringQueueService::getBufferGroup() const noexcept {
+    return 0;
+}
+
+std::span<uint8_t> Ichor::IOUringQueueService::getBuffer(uint16_t bufferId) noexcept {
+    return {_buffers + static_cast<size_t>(bufferId) * _bufferSize, _bufferSize};
+}
+
+void Ichor::IOUringQueueService::recycleBuffer(uint16_t bufferId) noexcept {
+    auto &buf = _bufferRing[_bufferRingTail & (_bufferCount - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(_buffers + static_cast<size_t>(bufferId) * _bufferSize);
+    buf.len = _bufferSize;
+    buf.bid = bufferId;
+    _bufferRingTail++;
+    std::atomic_ref<uint16_t>{_bufferRing[0].resv}.store(_bufferRingTail, std::memory_order_release);
+}
+
+void Ichor::IOUringQueueService::reap() {
+    pullCompletions();
+
+    // completion functions can pull more completions while cancelling, those end up at the back
+    for(uint64_t i = 0; i < _pendingCompletions.size(); i++) {
+        auto completion = _pendingCompletions[i];
+        dispatch(completion);
+    }
+    _pendingCompletions.clear();
+}
+
+void Ichor::IOUringQueueService::pullCompletions() {
+    while(true) {
+        auto head = *_cqHead;
+        auto tail = loadAcquire(_cqTail);
+        for(; head != tail; head++) {
+            auto &cqe = _cqes[head & _cqMask];
+            _pendingCompletions.push_back(Completion{cqe.user_data, cqe.res, cqe.flags});
+        }
+        storeRelease(_cqHead, head);
+
+        // completions that did not fit are kept by the kernel until asked for
+        if((loadAcquire(_sqFlags) & IORING_SQ_CQ_OVERFLOW) == 0) {
+            return;
+        }
+        ioUringEnter(_ringFd, 0, 0, IORING_ENTER_GETEVENTS);
+    }
+}
+
+bool Ichor::IOUringQueueService::cancelCompleted() const noexcept {
+    auto expected = CANCEL_USER_DATA | _cancelCounter;
+    for(auto const &completion : _pendingCompletions) {
+        if(completion.userData == expected) {
+            return true;
+        }
+    }
+
+    auto tail = loadAcquire(_cqTail);
+    for(auto head = *_cqHead; head != tail; head++) {
+        if(_cqes[head & _cqMask].user_data == expected) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Ichor::IOUringQueueService::dispatch(Completion const &completion) {
+    if(completion.userData & CANCEL_USER_DATA) {
+        return;
+    }
+
+    auto idx = static_cast<uint32_t>(completion.userData & 0xFFFF'FFFFu);
+    auto generation = static_cast<uint32_t>(completion.userData >> 32);
+    if(idx >= _operations.size() || !_operations[idx].active || _operations[idx].generation != generation) {
+        // cancelled, nobody is going to give the buffer back
+        if(completion.flags & IORING_CQE_F_BUFFER) {
+            recycleBuffer(static_cast<uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+        return;
+    }
+
+    // the function is moved out while running, it could submit operations and reallocate _operations
+    auto onCompletion = std::move(_operations[idx].onCompletion);
+    bool more = (completion.flags & IORING_CQE_F_MORE) != 0;
+    if(!more) {
+        release(idx);
+    }
+
+    onCompletion(completion.res, completion.flags);
+
+    if(more && _operations[idx].active && _operations[idx].generation == generation) {
+        _operations[idx].onCompletion = std::move(onCompletion);
+    }
+}
+
+void Ichor::IOUringQueueService::release(uint32_t idx) noexcept {
+    auto &operation = _operations[idx];
+    operation.onCompletion = {};
+    operation.active = false;
+    operation.fd = -1;
+    operation.generation = (operation.generation + 1) & GENERATION_MASK;
+    _freeOperations.push_back(idx);
+}
+
+void Ichor::IOUringQueueService::unmap() noexcept {
+    // tears down the ring, and with it everything that is still in flight, before the memory it refers to goes away
+    if(_ringFd >= 0) {
+        ::close(_ringFd);
+        _ringFd = -1;
+    }
+    if(_bufferRing != nullptr) {
+        ::munmap(_bufferRing, _bufferRingSize);
+        _bufferRing = nullptr;
+    }
+    if(_buffers != nullptr) {
+        ::munmap(_buffers, _buffersSize);
+        _buffers = nullptr;
+    }
+    if(_sqes != nullptr) {
+        ::munmap(_sqes, _sqesSize);
+        _sqes = nullptr;
+    }
+    if(_cqRingPtr != nullptr && _cqRingPtr != _ringPtr) {
+        ::munmap(_cqRingPtr, _cqRingSize);
+    }
+    _cqRingPtr = nullptr;
+    if(_ringPtr != nullptr) {
+        ::munmap(_ringPtr, _ringSize);
+        _ringPtr = nullptr;
+    }
+}
+
+#endif
@@ -6,9 +6,21 @@
 #include <netinet/tcp.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 
-Ichor::TcpConnectionService::TcpConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _attempts(), _priority(INTERNAL_EVENT_PRIORITY),  _quit() {
+Ichor::TcpConnectionService::TcpConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _attempts(), _priority(INTERNAL_EVENT_PRIORITY), _msgIdCounter(), _quit(), _queued(getMemoryResource()) {
     reg.registerDependency<ILogger>(this, true);
+    reg.registerDependency<IReactor>(this, true);
+}
+
+Ichor::TcpConnectionService::~TcpConnectionService() {
+    // a service that is still connecting is not active, so it is removed without being stopped
+    if(_connecting) {
+        if(_watching) {
+            _reactor->removeFd(_socket);
+        }
+        ::close(_socket);
+    }
 }
 
 Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
@@ -16,12 +28,33 @@ Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
         _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
     }
 
+    if(!_buffers) {
+        uint32_t minSize = DEFAULT_MIN_RECEIVE_BUFFER_SIZE;
+        uint32_t maxSize = DEFAULT_MAX_RECEIVE_BUFFER_SIZE;
+        if(getProperties().contains("MinReceiveBufferSize")) {
+            minSize = Ichor::any_cast<uint32_t>(getProperties().operator[]("MinReceiveBufferSize"));
+        }
+        if(getProperties().contains("MaxReceiveBufferSize")) {
+            maxSize = Ichor::any_cast<uint32_t>(getProperties().operator[]("MaxReceiveBufferSize"));
+        }
+        _buffers.emplace(getMemoryResource(), minSize, maxSize);
+    }
+
+    if(getProperties().contains("HighWatermark")) {
+        _highWatermark = Ichor::any_cast<uint64_t>(getProperties().operator[]("HighWatermark"));
+    }
+    if(getProperties().contains("LowWatermark")) {
+        _lowWatermark = Ichor::any_cast<uint64_t>(getProperties().operator[]("LowWatermark"));
+    }
 
     if(getProperties().contains("Socket")) {
         _socket = Ichor::any_cast<int>(getProperties().operator[]("Socket"));
+        _accepted = true;
+        auto flags = ::fcntl(_socket, F_GETFL, 0);
+        ::fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
 
         ICHOR_LOG_TRACE(_logger, "Starting TCP connection for existing socket");
-    } else {
+    } else if(!_connected) {
         if(!getProperties().contains("Address")) {
             getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Missing \"Address\" in properties");
             return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
@@ -32,6 +65,11 @@ Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
             return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
         }
 
+        // started again once the reactor reports the outcome of the connection in progress
+        if(_connecting) {
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
         // The start function possibly gets called multiple times due to trying to recover from not being able to connect
         if(_socket == -1) {
             _socket = socket(AF_INET, SOCK_STREAM, 0);
@@ -57,52 +95,52 @@ Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
             return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
         }
 
+        // the socket is non-blocking, so the connection may still be in progress. The service only becomes active once it is established.
         if(connect(_socket, (struct sockaddr *)&address, sizeof(address)) < 0)
         {
-            ICHOR_LOG_ERROR(_logger, "connect error {}", errno);
-            if(_attempts < 5) {
-                _attempts++;
-                return Ichor::StartBehaviour::FAILED_AND_RETRY;
+            if(errno == EINPROGRESS) {
+                _connecting = true;
+                _reactor->addFd(_socket, IReactor::WRITABLE, Ichor::function<void(uint32_t)>{[this](uint32_t ready) { onReady(ready); }, getMemoryResource()});
+                _watching = true;
+                return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
             }
-            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+
+            return connectFailed(errno) ? Ichor::StartBehaviour::FAILED_AND_RETRY : Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
         }
 
         auto ip = ::inet_ntoa(address.sin_addr);
         ICHOR_LOG_TRACE(_logger, "Starting TCP connection for {}:{}", ip, ::ntohs(address.sin_port));
     }
 
-    _timerManager = getManager()->createServiceManager<Timer, ITimer>();
-    _timerManager->setChronoInterval(20ms);
-    _timerManager->setCallback([this](TimerEvent const * const evt) -> Generator<bool> {
-        std::array<char, 1024> buf;
-        auto ret = recv(_socket, buf.data(), buf.size(), 0);
-
-        if (ret == 0) {
-            co_return (bool)PreventOthersHandling;
-        }
-
-        if(ret < 0) {
-            ICHOR_LOG_ERROR(_logger, "Error receiving from socket: {}", errno);
-            getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Error receiving from socket. errno = " + std::to_string(errno));
-            co_return (bool)PreventOthersHandling;
+    if(getProperties().contains("SendBufferSize")) {
+        int sendBufferSize = Ichor::any_cast<int>(getProperties().operator[]("SendBufferSize"));
+        if(::setsockopt(_socket, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize)) != 0) {
+            ICHOR_LOG_ERROR(_logger, "setsockopt SO_SNDBUF error {}", errno);
         }
+    }
 
-        getManager()->pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>{buf.data(), buf.data() + ret, getMemoryResource()});
-        co_return (bool)PreventOthersHandling;
-    });
-    _timerManager->startTimer();
+    _quit = false;
+    _readClosed = false;
+    setWaitingForWritable(false);
 
     return Ichor::StartBehaviour::SUCCEEDED;
 }
 
 Ichor::StartBehaviour Ichor::TcpConnectionService::stop() {
     _quit = true;
-    _timerManager = nullptr;
+
+    if(_watching) {
+        _reactor->removeFd(_socket);
+        _watching = false;
+    }
+    failQueued();
 
     if(_socket >= 0) {
         ::shutdown(_socket, SHUT_RDWR);
         ::close(_socket);
+        _socket = -1;
     }
+    _connected = false;
 
     return Ichor::StartBehaviour::SUCCEEDED;
 }
@@ -115,22 +153,242 @@ void Ichor::TcpConnectionService::removeDependencyInstance(ILogger *logger, ISer
     _logger = nullptr;
 }
 
+void Ichor::TcpConnectionService::addDependencyInstance(IReactor *reactor, IService *) {
+    _reactor = reactor;
+}
+
+void Ichor::TcpConnectionService::removeDependencyInstance(IReactor *reactor, IService *) {
+    // the reactor goes away before this service is stopped
+    if(_watching) {
+        _reactor->removeFd(_socket);
+        _watching = false;
+    }
+    // without the reactor nobody tells us when the rest can be sent
+    failQueued();
+    // nor when the connection is established, so connect again once there is a reactor
+    if(_connecting) {
+        ::close(_socket);
+        _socket = -1;
+        _connecting = false;
+    }
+    _reactor = nullptr;
+}
+
+void Ichor::TcpConnectionService::onConnected() {
+    int error{};
+    socklen_t len = sizeof(error);
+    if(::getsockopt(_socket, SOL_SOCKET, SO_ERROR, &error, &len) != 0) {
+        error = errno;
+    }
+
+    _connecting = false;
+    if(error != 0) {
+        if(connectFailed(error)) {
+            getManager()->pushPrioritisedEvent<StartServiceEvent>(getServiceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY, getServiceId());
+        }
+        return;
+    }
+
+    _connected = true;
+    getManager()->pushPrioritisedEvent<StartServiceEvent>(getServiceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY, getServiceId());
+}
+
+bool Ichor::TcpConnectionService::connectFailed(int error) {
+    ICHOR_LOG_ERROR(_logger, "connect error {}", error);
+
+    if(_watching) {
+        _reactor->removeFd(_socket);
+        _watching = false;
+    }
+    ::close(_socket);
+    _socket = -1;
+
+    if(_attempts < 5) {
+        _attempts++;
+        getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 5, "Couldn't connect, retrying. errno = " + std::to_string(error));
+        return true;
+    }
+
+    getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 5, "Couldn't connect. errno = " + std::to_string(error));
+    return false;
+}
+
+void Ichor::TcpConnectionService::onReady(uint32_t ready) {
+    if(_connecting) {
+        onConnected();
+        return;
+    }
+
+    if((ready & IReactor::WRITABLE) && _waitingForWritable) {
+        flush();
+    }
+
+    if(!_readClosed && (ready & (IReactor::READABLE | IReactor::CLOSED))) {
+        receive(ready);
+    }
+}
+
+void Ichor::TcpConnectionService::receive(uint32_t ready) {
+    // readiness is edge-triggered, so keep reading until the socket is drained
+    while(true) {
+        auto buf = _buffers->acquire();
+        auto ret = ::recv(_socket, buf.data().data(), buf.capacity(), 0);
+
+        if(ret > 0) {
+            // the event takes over the buffer the data was received in
+            _buffers->commit(buf, static_cast<uint32_t>(ret));
+            getManager()->pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, std::move(buf));
+            continue;
+        }
+
+        if(ret < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if(ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if((ready & IReactor::CLOSED) == 0) {
+                return;
+            }
+            ICHOR_LOG_TRACE(_logger, "Socket hung up");
+            break;
+        }
+
+        if(ret < 0) {
+            ICHOR_LOG_ERROR(_logger, "Error receiving from socket: {}", errno);
+            getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Error receiving from socket. errno = " + std::to_string(errno));
+        } else {
+            ICHOR_LOG_TRACE(_logger, "Peer closed connection");
+        }
+        break;
+    }
+
+    // nothing more will arrive, only keep watching the socket to send what is still queued
+    _readClosed = true;
+    setWaitingForWritable(_waitingForWritable);
+    removeWhenDone();
+}
+
 uint64_t Ichor::TcpConnectionService::sendAsync(std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> &&msg) {
     auto id = ++_msgIdCounter;
-    size_t sent_bytes = 0;
 
-    while(sent_bytes < msg.size()) {
-        auto ret = ::send(_socket, msg.data() + sent_bytes, msg.size() - sent_bytes, 0);
+    if(_quit || _reactor == nullptr) {
+        getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), id);
+        return id;
+    }
+
+    _queuedBytes += msg.size();
+    _queued.push_back(Message{id, std::move(msg)});
+
+    // when waiting for the socket to become writable, this message is sent along with the rest of the queue
+    if(!_waitingForWritable) {
+        flush();
+    }
+
+    if(!_aboveHighWatermark && _queuedBytes > _highWatermark) {
+        _aboveHighWatermark = true;
+        getManager()->pushPrioritisedEvent<SendQueueHighWatermarkEvent>(getServiceId(), _priority, _queuedBytes);
+    }
+
+    return id;
+}
+
+void Ichor::TcpConnectionService::flush() {
+    std::array<iovec, MAX_IOVECS> iov{};
+
+    while(!_queued.empty()) {
+        uint64_t count{};
+        for(auto it = _queued.begin(); it != _queued.end() && count < iov.size(); ++it, ++count) {
+            auto offset = count == 0 ? _frontOffset : 0;
+            iov[count].iov_base = it->data.data() + offset;
+            iov[count].iov_len = it->data.size() - offset;
+        }
+
+        msghdr hdr{};
+        hdr.msg_iov = iov.data();
+        hdr.msg_iovlen = count;
+        auto ret = ::sendmsg(_socket, &hdr, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if(ret < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
 
-        if(ret == -1) {
-            getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), id);
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                if(!_waitingForWritable) {
+                    setWaitingForWritable(true);
+                }
+                return;
+            }
+
+            ICHOR_LOG_ERROR(_logger, "Error sending to socket: {}", errno);
+            failQueued();
             break;
         }
 
-        sent_bytes += ret;
+        auto sent = static_cast<uint64_t>(ret);
+        _queuedBytes -= sent;
+        while(!_queued.empty()) {
+            auto remaining = _queued.front().data.size() - _frontOffset;
+            if(sent < remaining) {
+                _frontOffset += sent;
+                break;
+            }
+            sent -= remaining;
+            _frontOffset = 0;
+            _queued.pop_front();
+        }
+    }
+
+    if(_waitingForWritable) {
+        setWaitingForWritable(false);
     }
 
-    return id;
+    if(_aboveHighWatermark && _queuedBytes <= _lowWatermark) {
+        _aboveHighWatermark = false;
+        getManager()->pushPrioritisedEvent<SendQueueLowWatermarkEvent>(getServiceId(), _priority, _queuedBytes);
+    }
+
+    removeWhenDone();
+}
+
+void Ichor::TcpConnectionService::failQueued() {
+    for(auto &msg : _queued) {
+        getManager()->pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg.data), msg.id);
+    }
+    _queued.clear();
+    _queuedBytes = 0;
+    _frontOffset = 0;
+}
+
+void Ichor::TcpConnectionService::setWaitingForWritable(bool waiting) {
+    _waitingForWritable = waiting;
+
+    uint32_t interest = (_readClosed ? 0 : IReactor::READABLE) | (waiting ? IReactor::WRITABLE : 0);
+    if(interest == 0) {
+        if(_watching) {
+            _reactor->removeFd(_socket);
+            _watching = false;
+        }
+        return;
+    }
+
+    if(_watching) {
+        _reactor->modifyFd(_socket, interest);
+        return;
+    }
+
+    _reactor->addFd(_socket, interest, Ichor::function<void(uint32_t)>{[this](uint32_t ready) { onReady(ready); }, getMemoryResource()});
+    _watching = true;
+}
+
+void Ichor::TcpConnectionService::removeWhenDone() {
+    if(!_accepted || !_readClosed || !_queued.empty() || _removing) {
+        return;
+    }
+
+    // pushed after the data events of this connection, so their handlers still see the connection
+    _removing = true;
+    getManager()->pushPrioritisedEvent<RemoveServiceEvent>(getServiceId(), _priority, getServiceId());
 }
 
 void Ichor::TcpConnectionService::setPriority(uint64_t priority) {
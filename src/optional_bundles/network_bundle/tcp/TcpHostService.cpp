@@ -11,6 +11,7 @@
 
 Ichor::TcpHostService::TcpHostService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _bindFd(), _priority(INTERNAL_EVENT_PRIORITY), _quit() {
     reg.registerDependency<ILogger>(this, true);
+    reg.registerDependency<IReactor>(this, true);
 }
 
 Ichor::StartBehaviour Ichor::TcpHostService::start() {
@@ -32,6 +33,21 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
     auto flags = ::fcntl(_socket, F_GETFL, 0);
     ::fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
 
+    // every manager binds its own socket to the same port, the kernel spreads incoming connections over them
+    if(getProperties().contains("ReusePort") && Ichor::any_cast<bool>(getProperties().operator[]("ReusePort"))) {
+        if(::setsockopt(_socket, SOL_SOCKET, SO_REUSEPORT, &setting, sizeof(setting)) != 0) {
+            getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 5, "Couldn't set SO_REUSEPORT: errno = " + std::to_string(errno));
+            ::close(_socket);
+            _socket = -1;
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+    }
+
+    int backlog = SOMAXCONN;
+    if(getProperties().contains("Backlog")) {
+        backlog = Ichor::any_cast<int>(getProperties().operator[]("Backlog"));
+    }
+
     sockaddr_in address{};
     address.sin_family = AF_INET;
 
@@ -39,12 +55,11 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
 
     if(addressProp != cend(getProperties())) {
         auto hostname = Ichor::any_cast<std::string>(addressProp->second);
-        if(::inet_aton(hostname.c_str(), &address.sin_addr) != 0) {
-            getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 1, "inet_aton: errno = " + std::to_string(errno));
+        if(::inet_aton(hostname.c_str(), &address.sin_addr) == 0) {
             auto hp = ::gethostbyname(hostname.c_str());
             if (hp == nullptr) {
+                ::close(_socket);
                 _socket = -1;
-                close(_socket);
                 getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "gethostbyname: errno = " + std::to_string(errno));
                 return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
             }
@@ -59,43 +74,21 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
     _bindFd = ::bind(_socket, (sockaddr *)&address, sizeof(address));
 
     if(_bindFd == -1) {
+        ::close(_socket);
         _socket = -1;
-        close(_socket);
         getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "Couldn't bind socket: errno = " + std::to_string(errno));
         return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
     }
 
-    if(::listen(_socket, 10) != 0) {
+    if(::listen(_socket, backlog) != 0) {
+        ::close(_socket);
         _socket = -1;
-        close(_socket);
         getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Couldn't listen on socket: errno = " + std::to_string(errno));
         return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
     }
 
-    _timerManager = getManager()->createServiceManager<Timer, ITimer>();
-    _timerManager->setChronoInterval(20ms);
-    _timerManager->setCallback([this](TimerEvent const * const evt) -> Generator<bool> {
-        sockaddr_in client_addr{};
-        socklen_t client_addr_size = sizeof(client_addr);
-        int newConnection = ::accept(_socket, (sockaddr *) &client_addr, &client_addr_size);
-
-        if (newConnection == -1) {
-            ICHOR_LOG_ERROR(_logger, "New connection but accept() returned {} errno {}", newConnection, errno);
-            if(errno == EINVAL) {
-                getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(errno));
-                co_return (bool)PreventOthersHandling;
-            }
-            getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(errno));
-            co_return (bool)PreventOthersHandling;
-        }
-
-        auto ip = ::inet_ntoa(client_addr.sin_addr);
-        ICHOR_LOG_TRACE(_logger, "new connection from {}:{}", ip, ::ntohs(client_addr.sin_port));
-
-        getManager()->pushPrioritisedEvent<NewSocketEvent>(getServiceId(), _priority, newConnection);
-        co_return (bool)PreventOthersHandling;
-    });
-    _timerManager->startTimer();
+    _reactor->addFd(_socket, IReactor::READABLE, Ichor::function<void(uint32_t)>{[this](uint32_t) { acceptConnections(); }, getMemoryResource()});
+    _watching = true;
 
     return Ichor::StartBehaviour::SUCCEEDED;
 }
@@ -103,7 +96,10 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
 Ichor::StartBehaviour Ichor::TcpHostService::stop() {
     _quit = true;
 
-    _timerManager = nullptr;
+    if(_watching) {
+        _reactor->removeFd(_socket);
+        _watching = false;
+    }
 
     if(_socket >= 0) {
         ::shutdown(_socket, SHUT_RDWR);
@@ -123,6 +119,51 @@ void Ichor::TcpHostService::removeDependencyInstance(ILogger *logger, IService *
     _logger = nullptr;
 }
 
+void Ichor::TcpHostService::addDependencyInstance(IReactor *reactor, IService *) {
+    _reactor = reactor;
+}
+
+void Ichor::TcpHostService::removeDependencyInstance(IReactor *reactor, IService *) {
+    // the reactor goes away before this service is stopped
+    if(_watching) {
+        _reactor->removeFd(_socket);
+        _watching = false;
+    }
+    _reactor = nullptr;
+}
+
+void Ichor::TcpHostService::acceptConnections() {
+    // readiness is edge-triggered, so accept everything that is queued up
+    while(true) {
+        sockaddr_in client_addr{};
+        socklen_t client_addr_size = sizeof(client_addr);
+        int newConnection = ::accept4(_socket, (sockaddr *) &client_addr, &client_addr_size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (newConnection == -1) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            // the connection was aborted before it could be accepted
+            if(errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+
+            ICHOR_LOG_ERROR(_logger, "New connection but accept() returned {} errno {}", newConnection, errno);
+            if(errno == EINVAL) {
+                getManager()->pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(errno));
+                return;
+            }
+            getManager()->pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(errno));
+            return;
+        }
+
+        auto ip = ::inet_ntoa(client_addr.sin_addr);
+        ICHOR_LOG_TRACE(_logger, "new connection from {}:{}", ip, ::ntohs(client_addr.sin_port));
+
+        getManager()->pushPrioritisedEvent<NewSocketEvent>(getServiceId(), _priority, newConnection);
+    }
+}
+
 void Ichor::TcpHostService::setPriority(uint64_t priority) {
     _priority = priority;
 }
@@ -135,7 +176,7 @@ Ichor::Generator<bool> Ichor::TcpHostService::handleEvent(NewSocketEvent const *
     Properties props{};
     props.emplace("Priority", Ichor::make_any<uint64_t>(getMemoryResource(), _priority));
     props.emplace("Socket", Ichor::make_any<int>(getMemoryResource(), evt->socket));
-    _connections.emplace_back(getManager()->template createServiceManager<TcpConnectionService, IConnectionService>(std::move(props)));
+    getManager()->template createServiceManager<TcpConnectionService, IConnectionService>(std::move(props));
 
     co_return (bool)AllowOthersHandling;
 }
\ No newline at end of file
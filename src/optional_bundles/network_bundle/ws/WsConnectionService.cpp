@@ -280,7 +280,7 @@ void Ichor::WsConnectionService::read(net::yield_context &yield) {
 
         if(_ws->got_text()) {
             auto data = buffer.data();
-            getManager()->pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority,  std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>>{static_cast<char*>(data.data()), static_cast<char*>(data.data()) + data.size(), getMemoryResource()});
+            getManager()->pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, NetworkBuffer::copyOf(std::span<uint8_t const>{static_cast<uint8_t const*>(data.data()), data.size()}, getMemoryResource()));
         }
     }
 
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/Events.h>
+#include "TestEvents.h"
+
+using namespace Ichor;
+
+struct IAwaitingEventHandlerService {
+    virtual std::vector<uint64_t>& getReceivedValues() = 0;
+    virtual uint64_t getCompletedHandlers() const = 0;
+
+protected:
+    ~IAwaitingEventHandlerService() = default;
+};
+
+// Waits for a ValueEvent with a non-zero value for every TestEvent, then pushes a ValueEvent itself and waits until it has been processed
+struct AwaitingEventHandlerService final : public IAwaitingEventHandlerService, public Service<AwaitingEventHandlerService> {
+    AwaitingEventHandlerService() = default;
+
+    StartBehaviour start() final {
+        _handler = getManager()->registerEventHandler<TestEvent>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    Task<bool> handleEvent(TestEvent const * const) {
+        FrameGuard guard{};
+        auto *evt = co_await getManager()->waitForEvent<ValueEvent>([](ValueEvent const * const valueEvt) { return valueEvt->value != 0; });
+        resumedHandlers++;
+        receivedValues.push_back(evt->value);
+
+        auto processedValue = co_await pushAndWait();
+        receivedValues.push_back(processedValue);
+
+        completedHandlers++;
+        co_return (bool)AllowOthersHandling;
+    }
+
+    Task<uint64_t> pushAndWait() {
+        auto eventId = getManager()->pushEvent<ValueEvent>(getServiceId(), 0);
+        auto *evt = co_await getManager()->waitForEventProcessed(eventId);
+        co_return static_cast<ValueEvent const *>(evt)->value;
+    }
+
+    std::vector<uint64_t>& getReceivedValues() final {
+        return receivedValues;
+    }
+
+    uint64_t getCompletedHandlers() const final {
+        return completedHandlers;
+    }
+
+    // counts handler frames that completed or were destroyed while suspended
+    struct FrameGuard {
+        ~FrameGuard() {
+            destroyedFrames++;
+        }
+    };
+
+    EventHandlerRegistration _handler{};
+    std::vector<uint64_t> receivedValues;
+    uint64_t completedHandlers{};
+    // outlive the service, to check what happens to handlers that were suspended when it was removed
+    static inline uint64_t destroyedFrames{};
+    static inline uint64_t resumedHandlers{};
+};
@@ -1,5 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <ichor/stl/Common.h>
+#include <ichor/stl/CoroutineFrameCache.h>
+#include <ichor/optional_bundles/network_bundle/NetworkBuffer.h>
+#include <cstring>
 #include <iostream>
 
 struct x {};
@@ -30,4 +33,99 @@ TEST_CASE("polymorphic_allocator") {
         std::cout << p2->z << std::endl;
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("CoroutineFrameCache") {
+
+    SECTION("Frames of the same size are recycled") {
+        Ichor::CoroutineFrameCache cache{std::pmr::get_default_resource()};
+
+        void *first = cache.allocate(128);
+        void *other = cache.allocate(256);
+        cache.deallocate(first, 128);
+
+        void *second = cache.allocate(128);
+        REQUIRE(second == first);
+
+        auto stats = cache.getStatistics();
+        REQUIRE(stats.allocations == 3);
+        REQUIRE(stats.recycled == 1);
+        REQUIRE(stats.live == 2);
+        REQUIRE(stats.peakLive == 2);
+        REQUIRE(stats.cached == 0);
+
+        cache.deallocate(second, 128);
+        cache.deallocate(other, 256);
+
+        stats = cache.getStatistics();
+        REQUIRE(stats.live == 0);
+        REQUIRE(stats.cached == 2);
+    }
+
+    SECTION("Large frames are not cached") {
+        Ichor::CoroutineFrameCache cache{std::pmr::get_default_resource()};
+
+        void *p = cache.allocate(Ichor::CoroutineFrameCache::MAX_FRAME_SIZE + 1);
+        cache.deallocate(p, Ichor::CoroutineFrameCache::MAX_FRAME_SIZE + 1);
+
+        auto stats = cache.getStatistics();
+        REQUIRE(stats.allocations == 1);
+        REQUIRE(stats.live == 0);
+        REQUIRE(stats.cached == 0);
+    }
+}
+
+TEST_CASE("NetworkBufferPool") {
+
+    SECTION("Released buffers are recycled") {
+        Ichor::NetworkBufferPool pool{std::pmr::get_default_resource(), 1024, 4096};
+
+        auto first = pool.acquire();
+        REQUIRE(first.capacity() == 1024);
+        REQUIRE(first.size() == 1024);
+        auto *bytes = first.data().data();
+        pool.commit(first, 512);
+        REQUIRE(first.size() == 512);
+
+        auto shared = first;
+        REQUIRE(first.useCount() == 2);
+        first = Ichor::NetworkBuffer{};
+        REQUIRE(pool.getStatistics().live == 1);
+        shared = Ichor::NetworkBuffer{};
+
+        auto stats = pool.getStatistics();
+        REQUIRE(stats.live == 0);
+        REQUIRE(stats.cached == 1);
+
+        auto second = pool.acquire();
+        REQUIRE(second.data().data() == bytes);
+        REQUIRE(pool.getStatistics().recycled == 1);
+    }
+
+    SECTION("Buffer size adapts to the amount received") {
+        Ichor::NetworkBufferPool pool{std::pmr::get_default_resource(), 1024, 4096};
+
+        for(uint32_t i = 0; i < 3; i++) {
+            auto buf = pool.acquire();
+            pool.commit(buf, buf.capacity());
+        }
+        REQUIRE(pool.getStatistics().bufferSize == 4096);
+
+        for(uint32_t i = 0; i < Ichor::NetworkBufferPool::SHRINK_AFTER; i++) {
+            auto buf = pool.acquire();
+            pool.commit(buf, 16);
+        }
+        REQUIRE(pool.getStatistics().bufferSize == 2048);
+    }
+
+    SECTION("Buffers outlive their pool") {
+        Ichor::NetworkBuffer buf;
+        {
+            Ichor::NetworkBufferPool pool{std::pmr::get_default_resource(), 1024, 4096};
+            buf = pool.acquire();
+            pool.commit(buf, 3);
+            std::memcpy(buf.data().data(), "abc", 3);
+        }
+        REQUIRE(std::string_view{reinterpret_cast<char const*>(buf.data().data()), buf.size()} == "abc");
+    }
+}
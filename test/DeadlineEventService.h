@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/Events.h>
+#include "TestEvents.h"
+
+using namespace Ichor;
+
+struct IDeadlineEventService {
+    virtual std::vector<uint64_t>& getReceivedValues() = 0;
+    virtual std::vector<uint64_t>& getMissedEventIds() = 0;
+
+protected:
+    ~IDeadlineEventService() = default;
+};
+
+// Records the values of handled ValueEvents and the ids of events that missed their deadline, in the order they arrive
+struct DeadlineEventService final : public IDeadlineEventService, public Service<DeadlineEventService> {
+    DeadlineEventService() = default;
+
+    StartBehaviour start() final {
+        _valueHandler = getManager()->registerEventHandler<ValueEvent>(this);
+        _missedHandler = getManager()->registerEventHandler<DeadlineMissedEvent>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _valueHandler.reset();
+        _missedHandler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    bool handleEvent(ValueEvent const * const evt) {
+        receivedValues.push_back(evt->value);
+        return AllowOthersHandling;
+    }
+
+    bool handleEvent(DeadlineMissedEvent const * const evt) {
+        missedEventIds.push_back(evt->missedEventId);
+        return AllowOthersHandling;
+    }
+
+    std::vector<uint64_t>& getReceivedValues() final {
+        return receivedValues;
+    }
+
+    std::vector<uint64_t>& getMissedEventIds() final {
+        return missedEventIds;
+    }
+
+    EventHandlerRegistration _valueHandler{};
+    EventHandlerRegistration _missedHandler{};
+    std::vector<uint64_t> receivedValues;
+    std::vector<uint64_t> missedEventIds;
+};
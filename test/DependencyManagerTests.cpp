@@ -2,6 +2,7 @@
 #include <ichor/DependencyManager.h>
 #include <ichor/optional_bundles/logging_bundle/NullFrameworkLogger.h>
 #include "UselessService.h"
+#include "TestEvents.h"
 #include "Common.h"
 
 TEST_CASE("DependencyManager") {
@@ -72,4 +73,54 @@ TEST_CASE("DependencyManager") {
 
         REQUIRE_FALSE(dm.isRunning());
     }
-}
\ No newline at end of file
+
+    SECTION("Dense event type indices") {
+        REQUIRE(eventTypeIndex<Event>() == ALL_EVENTS_TYPE_INDEX);
+        REQUIRE(eventTypeIndex<DependencyOnlineEvent>() == builtinEventTypeIndex<DependencyOnlineEvent>);
+        REQUIRE(eventTypeIndex<RunFunctionEvent>() == builtinEventTypeIndex<RunFunctionEvent>);
+        REQUIRE(builtinEventTypeIndex<DependencyOnlineEvent> != ALL_EVENTS_TYPE_INDEX);
+
+        auto testIndex = eventTypeIndex<TestEvent>();
+        REQUIRE(testIndex > builtinEventTypeIndex<RunFunctionEvent>);
+        REQUIRE(eventTypeIndex<TestEvent>() == testIndex);
+        REQUIRE(registerEventType(TestEvent::TYPE) == testIndex);
+        REQUIRE(registerEventType(QuitEvent::TYPE) == builtinEventTypeIndex<QuitEvent>);
+    }
+
+    SECTION("Scheduled functions") {
+        Ichor::DependencyManager dm{};
+        std::vector<uint64_t> order;
+        uint64_t repetitions{};
+
+        dm.createServiceManager<Ichor::NullFrameworkLogger, Ichor::IFrameworkLogger>();
+        dm.createServiceManager<UselessService, IUselessService>();
+        dm.pushEvent<Ichor::RunFunctionEvent>(0, [&order, &repetitions](Ichor::DependencyManager *mng) {
+            auto now = std::chrono::steady_clock::now();
+            mng->scheduleAfter(std::chrono::milliseconds(30), Ichor::INTERNAL_EVENT_PRIORITY, [&order](Ichor::DependencyManager *innerMng) {
+                order.push_back(3);
+                innerMng->pushEvent<Ichor::QuitEvent>(0);
+            });
+            mng->scheduleAt(now + std::chrono::milliseconds(5), Ichor::INTERNAL_EVENT_PRIORITY, [&order](Ichor::DependencyManager *) {
+                order.push_back(1);
+            });
+            auto cancelled = mng->scheduleAfter(std::chrono::milliseconds(10), Ichor::INTERNAL_EVENT_PRIORITY, [&order](Ichor::DependencyManager *) {
+                order.push_back(2);
+            });
+            REQUIRE(mng->cancelScheduled(cancelled));
+            REQUIRE_FALSE(mng->cancelScheduled(cancelled));
+
+            auto repeating = std::make_shared<Ichor::TimerHandle>();
+            *repeating = mng->scheduleEvery(std::chrono::milliseconds(2), Ichor::INTERNAL_EVENT_PRIORITY, [&repetitions, repeating](Ichor::DependencyManager *innerMng) {
+                repetitions++;
+                if(repetitions == 3) {
+                    REQUIRE(innerMng->cancelScheduled(*repeating));
+                }
+            });
+        });
+
+        dm.start();
+
+        REQUIRE(order == std::vector<uint64_t>{1, 3});
+        REQUIRE(repetitions == 3);
+    }
+}
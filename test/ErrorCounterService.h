@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/Events.h>
+
+using namespace Ichor;
+
+struct IErrorCounterService {
+    virtual uint64_t getRecoverableErrors() = 0;
+    virtual uint64_t getUnrecoverableErrors() = 0;
+
+protected:
+    ~IErrorCounterService() = default;
+};
+
+// Counts the error events of all services, without depending on any of them
+struct ErrorCounterService final : public IErrorCounterService, public Service<ErrorCounterService> {
+    ErrorCounterService() = default;
+
+    StartBehaviour start() final {
+        _recoverableHandler = getManager()->registerEventHandler<RecoverableErrorEvent>(this);
+        _unrecoverableHandler = getManager()->registerEventHandler<UnrecoverableErrorEvent>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _recoverableHandler.reset();
+        _unrecoverableHandler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    bool handleEvent(RecoverableErrorEvent const * const) {
+        _recoverableErrors++;
+
+        return AllowOthersHandling;
+    }
+
+    bool handleEvent(UnrecoverableErrorEvent const * const) {
+        _unrecoverableErrors++;
+
+        return AllowOthersHandling;
+    }
+
+    uint64_t getRecoverableErrors() final {
+        return _recoverableErrors;
+    }
+
+    uint64_t getUnrecoverableErrors() final {
+        return _unrecoverableErrors;
+    }
+
+    EventHandlerRegistration _recoverableHandler{};
+    EventHandlerRegistration _unrecoverableHandler{};
+    uint64_t _recoverableErrors{};
+    uint64_t _unrecoverableErrors{};
+};
@@ -12,8 +12,8 @@ protected:
     ~IEventHandlerService() = default;
 };
 
-template <Derived<Event> EventT>
-struct EventHandlerService final : public IEventHandlerService, public Service<EventHandlerService<EventT>> {
+template <Derived<Event> EventT, bool Synchronous = false>
+struct EventHandlerService final : public IEventHandlerService, public Service<EventHandlerService<EventT, Synchronous>> {
     EventHandlerService() = default;
 
     StartBehaviour start() final {
@@ -28,7 +28,17 @@ struct EventHandlerService final : public IEventHandlerService, public Service<E
         return StartBehaviour::SUCCEEDED;
     }
 
-    Generator<bool> handleEvent(EventT const * const evt) {
+    Generator<bool> handleEvent(EventT const * const evt) requires (!Synchronous) {
+        countEvent(evt);
+        co_return (bool)AllowOthersHandling;
+    }
+
+    bool handleEvent(EventT const * const evt) requires Synchronous {
+        countEvent(evt);
+        return AllowOthersHandling;
+    }
+
+    void countEvent(EventT const * const evt) {
         auto counter = handledEvents.find(evt->type);
 
         if(counter == end(handledEvents)) {
@@ -36,8 +46,6 @@ struct EventHandlerService final : public IEventHandlerService, public Service<E
         } else {
             counter->second++;
         }
-
-        co_return (bool)AllowOthersHandling;
     }
 
     std::unordered_map<uint64_t, uint64_t>& getHandledEvents() final {
@@ -0,0 +1,699 @@
+#include "Common.h"
+#include <cstring>
+#include "TestEvents.h"
+#include "UselessService.h"
+#include <ichor/event_queues/MultimapEventQueue.h>
+#include <ichor/event_queues/MpscEventQueue.h>
+#include <ichor/event_queues/BucketEventQueue.h>
+#include <ichor/stl/EventSlabAllocator.h>
+#include <ichor/event_queues/TimerWheel.h>
+#include <ichor/optional_bundles/timer_bundle/TimerService.h>
+
+using namespace Ichor;
+
+struct BigTestEvent final : public Event {
+    explicit BigTestEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority) {}
+    ~BigTestEvent() final = default;
+
+    std::array<uint8_t, 256> payload{};
+    static constexpr uint64_t TYPE = typeNameHash<BigTestEvent>();
+    static constexpr std::string_view NAME = typeName<BigTestEvent>();
+};
+
+// Stalls the first move after being armed until released. Producers move events into a ring cell after claiming it, so this keeps a claimed cell unpublished.
+struct StallingTestEvent final : public Event {
+    explicit StallingTestEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority) {}
+    StallingTestEvent(StallingTestEvent &&o) noexcept : Event(o) {
+        if(armed.exchange(false)) {
+            stalled = true;
+            while(!released) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    ~StallingTestEvent() final = default;
+
+    static inline std::atomic<bool> armed{};
+    static inline std::atomic<bool> stalled{};
+    static inline std::atomic<bool> released{};
+    static constexpr uint64_t TYPE = typeNameHash<StallingTestEvent>();
+    static constexpr std::string_view NAME = typeName<StallingTestEvent>();
+};
+
+void pushTestEvent(IEventQueue &queue, uint64_t id, uint64_t originatingService, uint64_t priority) {
+    queue.pushEvent(priority, EventStackUniquePtr::create<TestEvent>(std::pmr::new_delete_resource(), id, originatingService, priority));
+}
+
+void requireOrdering(IEventQueue &queue) {
+    pushTestEvent(queue, 1, 0, 1000);
+    pushTestEvent(queue, 2, 0, 10);
+    pushTestEvent(queue, 3, 0, 1000);
+    pushTestEvent(queue, 4, 0, 10);
+
+    REQUIRE(!queue.empty());
+    REQUIRE(queue.size() == 4);
+
+    for(uint64_t expectedId : {2, 4, 1, 3}) {
+        auto evt = queue.popEvent();
+        REQUIRE(evt);
+        REQUIRE(evt->id == expectedId);
+    }
+
+    REQUIRE(queue.empty());
+    REQUIRE(!queue.popEvent());
+}
+
+void requireBatchOrdering(IEventQueue &queue) {
+    std::pmr::vector<EventStackUniquePtr> events{std::pmr::new_delete_resource()};
+    REQUIRE(queue.peekHighestPriority() == std::numeric_limits<uint64_t>::max());
+
+    pushTestEvent(queue, 1, 0, 1000);
+    pushTestEvent(queue, 2, 0, 10);
+    pushTestEvent(queue, 3, 0, 1000);
+    pushTestEvent(queue, 4, 0, 10);
+    REQUIRE(queue.peekHighestPriority() == 10);
+
+    queue.popEvents(events, 3);
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0]->id == 2);
+    REQUIRE(events[1]->id == 4);
+    REQUIRE(events[2]->id == 1);
+    REQUIRE(queue.peekHighestPriority() == 1000);
+
+    pushTestEvent(queue, 5, 0, 5);
+    REQUIRE(queue.peekHighestPriority() == 5);
+
+    events.clear();
+    queue.popEvents(events, 10);
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0]->id == 5);
+    REQUIRE(events[1]->id == 3);
+    REQUIRE(queue.peekHighestPriority() == std::numeric_limits<uint64_t>::max());
+    REQUIRE(queue.empty());
+}
+
+void requireMultipleProducers(IEventQueue &queue) {
+    constexpr uint64_t producerCount = 4;
+    constexpr uint64_t eventsPerProducer = 10'000;
+    std::vector<std::thread> producers{};
+
+    for(uint64_t producer = 0; producer < producerCount; producer++) {
+        producers.emplace_back([&queue, producer] {
+            for(uint64_t i = 0; i < eventsPerProducer; i++) {
+                pushTestEvent(queue, i, producer, INTERNAL_EVENT_PRIORITY);
+            }
+        });
+    }
+
+    std::array<uint64_t, producerCount> nextIds{};
+    uint64_t received{};
+    while(received < producerCount * eventsPerProducer) {
+        auto evt = queue.popEvent();
+        if(!evt) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // events from the same producer have to keep their insertion order
+        REQUIRE(evt->id == nextIds[evt->originatingService]);
+        nextIds[evt->originatingService]++;
+        received++;
+    }
+
+    for(auto &producer : producers) {
+        producer.join();
+    }
+
+    REQUIRE(queue.empty());
+}
+
+void pushTestEvents(IEventQueue &queue, uint64_t firstId, uint64_t count, uint64_t originatingService, uint64_t priority) {
+    std::vector<EventStackUniquePtr> events{};
+    for(uint64_t i = 0; i < count; i++) {
+        events.emplace_back(EventStackUniquePtr::create<TestEvent>(std::pmr::new_delete_resource(), firstId + i, originatingService, priority));
+    }
+    queue.pushEvents(priority, events);
+}
+
+void requireBulkOrdering(IEventQueue &queue) {
+    pushTestEvent(queue, 1, 0, 1000);
+    pushTestEvents(queue, 2, 3, 0, 10);
+    pushTestEvents(queue, 5, 3, 0, 1000);
+    pushTestEvents(queue, 8, 0, 0, 10);
+
+    REQUIRE(queue.size() == 7);
+
+    for(uint64_t expectedId : {2, 3, 4, 1, 5, 6, 7}) {
+        auto evt = queue.popEvent();
+        REQUIRE(evt);
+        REQUIRE(evt->id == expectedId);
+    }
+
+    REQUIRE(queue.empty());
+}
+
+void requireMultipleBulkProducers(IEventQueue &queue) {
+    constexpr uint64_t producerCount = 4;
+    constexpr uint64_t batchesPerProducer = 1'000;
+    constexpr uint64_t batchSize = 8;
+    std::vector<std::thread> producers{};
+
+    for(uint64_t producer = 0; producer < producerCount; producer++) {
+        producers.emplace_back([&queue, producer] {
+            for(uint64_t i = 0; i < batchesPerProducer; i++) {
+                pushTestEvents(queue, i * batchSize, batchSize, producer, INTERNAL_EVENT_PRIORITY);
+            }
+        });
+    }
+
+    std::array<uint64_t, producerCount> nextIds{};
+    uint64_t received{};
+    uint64_t previousProducer{};
+    while(received < producerCount * batchesPerProducer * batchSize) {
+        auto evt = queue.popEvent();
+        if(!evt) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // batches are never interleaved with events of other producers
+        if(received % batchSize != 0) {
+            REQUIRE(evt->originatingService == previousProducer);
+        }
+        REQUIRE(evt->id == nextIds[evt->originatingService]);
+        nextIds[evt->originatingService]++;
+        previousProducer = evt->originatingService;
+        received++;
+    }
+
+    for(auto &producer : producers) {
+        producer.join();
+    }
+
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("EventQueue Tests") {
+
+    ensureInternalLoggerExists();
+
+    SECTION("Multimap queue ordering") {
+        MultimapEventQueue queue{std::pmr::new_delete_resource()};
+        requireOrdering(queue);
+    }
+
+    SECTION("Bucket queue ordering") {
+        BucketEventQueue queue{std::pmr::new_delete_resource()};
+        requireOrdering(queue);
+    }
+
+    SECTION("Mpsc queue ordering") {
+        MpscEventQueue queue{std::pmr::new_delete_resource()};
+        requireOrdering(queue);
+    }
+
+    SECTION("Mpsc queue ordering with full ring") {
+        MpscEventQueue queue{std::pmr::new_delete_resource(), 2};
+        requireOrdering(queue);
+    }
+
+    SECTION("Batch ordering") {
+        MultimapEventQueue multimapQueue{std::pmr::new_delete_resource()};
+        requireBatchOrdering(multimapQueue);
+        BucketEventQueue bucketQueue{std::pmr::new_delete_resource()};
+        requireBatchOrdering(bucketQueue);
+        MpscEventQueue mpscQueue{std::pmr::new_delete_resource()};
+        requireBatchOrdering(mpscQueue);
+    }
+
+    SECTION("Bulk push ordering") {
+        MultimapEventQueue multimapQueue{std::pmr::new_delete_resource()};
+        requireBulkOrdering(multimapQueue);
+        BucketEventQueue bucketQueue{std::pmr::new_delete_resource()};
+        requireBulkOrdering(bucketQueue);
+        MpscEventQueue mpscQueue{std::pmr::new_delete_resource()};
+        requireBulkOrdering(mpscQueue);
+        MpscEventQueue smallMpscQueue{std::pmr::new_delete_resource(), 2};
+        requireBulkOrdering(smallMpscQueue);
+    }
+
+    SECTION("Multiple bulk producers") {
+        BucketEventQueue bucketQueue{std::pmr::new_delete_resource()};
+        requireMultipleBulkProducers(bucketQueue);
+        MpscEventQueue mpscQueue{std::pmr::new_delete_resource(), 64};
+        requireMultipleBulkProducers(mpscQueue);
+    }
+
+    SECTION("Multimap queue multiple producers") {
+        MultimapEventQueue queue{std::pmr::new_delete_resource()};
+        requireMultipleProducers(queue);
+    }
+
+    SECTION("Bucket queue multiple producers") {
+        BucketEventQueue queue{std::pmr::new_delete_resource()};
+        requireMultipleProducers(queue);
+    }
+
+    SECTION("Mpsc queue multiple producers") {
+        MpscEventQueue queue{std::pmr::new_delete_resource(), 64};
+        requireMultipleProducers(queue);
+    }
+
+    SECTION("Mpsc queue keeps producer order when overflowing behind an unpublished cell") {
+        MpscEventQueue queue{std::pmr::new_delete_resource(), 2};
+        REQUIRE(!queue.popEvent());
+
+        StallingTestEvent::released = false;
+        StallingTestEvent::stalled = false;
+        std::thread stalledProducer([&queue] {
+            auto evt = EventStackUniquePtr::create<StallingTestEvent>(std::pmr::new_delete_resource(), 0, 1, INTERNAL_EVENT_PRIORITY);
+            StallingTestEvent::armed = true;
+            queue.pushEvent(INTERNAL_EVENT_PRIORITY, std::move(evt));
+        });
+        while(!StallingTestEvent::stalled) {
+            std::this_thread::yield();
+        }
+
+        // the first event goes into the ring behind the claimed cell, the second finds the ring full and overflows
+        std::thread producer([&queue] {
+            pushTestEvent(queue, 1, 0, INTERNAL_EVENT_PRIORITY);
+            pushTestEvent(queue, 2, 0, INTERNAL_EVENT_PRIORITY);
+        });
+        producer.join();
+
+        std::thread releaser([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            StallingTestEvent::released = true;
+        });
+
+        std::vector<std::pair<uint64_t, uint64_t>> received{};
+        while(received.size() < 3) {
+            auto evt = queue.popEvent();
+            if(!evt) {
+                std::this_thread::yield();
+                continue;
+            }
+            received.emplace_back(evt->originatingService, evt->id);
+        }
+        releaser.join();
+        stalledProducer.join();
+
+        REQUIRE(received == std::vector<std::pair<uint64_t, uint64_t>>{{1, 0}, {0, 1}, {0, 2}});
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("Mpsc queue consumer pushes after producers") {
+        MpscEventQueue queue{std::pmr::new_delete_resource()};
+        REQUIRE(!queue.popEvent());
+
+        std::thread producer([&queue] {
+            pushTestEvent(queue, 1, 0, INTERNAL_EVENT_PRIORITY);
+        });
+        producer.join();
+
+        // pushed from the consumer thread, but has to be ordered after the event of the other thread
+        pushTestEvent(queue, 2, 0, INTERNAL_EVENT_PRIORITY);
+
+        auto evt = queue.popEvent();
+        REQUIRE(evt->id == 1);
+        evt = queue.popEvent();
+        REQUIRE(evt->id == 2);
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("PriorityBuckets levels") {
+        PriorityBuckets<uint64_t> buckets{std::pmr::new_delete_resource()};
+
+        // insert in reverse order to force shifting levels, and enough elements to force the ring buffers to grow
+        for(uint64_t i = 0; i < 100; i++) {
+            for(uint64_t prio = PriorityBuckets<uint64_t>::MAX_LEVELS; prio > 0; prio--) {
+                buckets.push(prio, prio * 1000 + i);
+            }
+        }
+
+        REQUIRE(buckets.size() == 100 * PriorityBuckets<uint64_t>::MAX_LEVELS);
+
+        // all levels are in use, so these priorities go into the overflow, ordered with respect to the levels
+        buckets.push(12345, 1);
+        buckets.push(0, 2);
+        buckets.push(12345, 3);
+        buckets.push(0, 4);
+        REQUIRE(buckets.size() == 100 * PriorityBuckets<uint64_t>::MAX_LEVELS + 4);
+        REQUIRE(buckets.topPriority() == 0);
+        REQUIRE(buckets.pop() == 2);
+        REQUIRE(buckets.pop() == 4);
+
+        for(uint64_t prio = 1; prio <= PriorityBuckets<uint64_t>::MAX_LEVELS; prio++) {
+            for(uint64_t i = 0; i < 100; i++) {
+                REQUIRE(buckets.topPriority() == prio);
+                REQUIRE(buckets.pop() == prio * 1000 + i);
+            }
+        }
+
+        // pushing a priority that is still in the overflow keeps using the overflow, even though levels can be reclaimed now
+        buckets.push(12345, 5);
+        REQUIRE(buckets.topPriority() == 12345);
+        REQUIRE(buckets.pop() == 1);
+        REQUIRE(buckets.pop() == 3);
+        REQUIRE(buckets.pop() == 5);
+        REQUIRE(buckets.empty());
+
+        // all levels are empty now, so they can be reclaimed for new priorities
+        buckets.push(12345, 1);
+        buckets.push(5, 2);
+        REQUIRE(buckets.pop() == 2);
+        REQUIRE(buckets.pop() == 1);
+        REQUIRE(buckets.empty());
+    }
+
+    SECTION("Bucket queues with more priorities than levels") {
+        BucketEventQueue bucketQueue{std::pmr::new_delete_resource()};
+        MpscEventQueue mpscQueue{std::pmr::new_delete_resource()};
+        constexpr uint64_t priorities = 3 * PriorityBuckets<EventStackUniquePtr>::MAX_LEVELS;
+
+        for(IEventQueue *queue : std::initializer_list<IEventQueue*>{&bucketQueue, &mpscQueue}) {
+            for(uint64_t i = 0; i < 2; i++) {
+                for(uint64_t prio = priorities; prio > 0; prio--) {
+                    pushTestEvent(*queue, prio * 10 + i, 0, prio);
+                }
+            }
+
+            for(uint64_t prio = 1; prio <= priorities; prio++) {
+                for(uint64_t i = 0; i < 2; i++) {
+                    REQUIRE(queue->peekHighestPriority() == prio);
+                    auto evt = queue->popEvent();
+                    REQUIRE(evt->id == prio * 10 + i);
+                }
+            }
+            REQUIRE(queue->empty());
+        }
+    }
+
+    SECTION("DependencyManager with mpsc queue") {
+        Ichor::DependencyManager dm{std::pmr::new_delete_resource(), std::pmr::new_delete_resource(), EventQueueType::LOCK_FREE_MPSC};
+        std::atomic<uint64_t> count{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService, IUselessService>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        std::vector<std::thread> producers{};
+        for(uint64_t i = 0; i < 4; i++) {
+            producers.emplace_back([&dm, &count] {
+                for(uint64_t j = 0; j < 100; j++) {
+                    dm.pushEvent<RunFunctionEvent>(0, [&count](DependencyManager*) {
+                        count.fetch_add(1, std::memory_order_acq_rel);
+                    });
+                }
+            });
+        }
+
+        for(auto &producer : producers) {
+            producer.join();
+        }
+
+        while(count.load(std::memory_order_acquire) != 400) {
+            dm.waitForEmptyQueue();
+        }
+
+        dm.pushEvent<QuitEvent>(0);
+
+        t.join();
+    }
+
+    SECTION("DependencyManager bulk push") {
+        Ichor::DependencyManager dm{};
+        std::vector<uint64_t> values{};
+
+        dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+        dm.createServiceManager<UselessService, IUselessService>();
+
+        auto firstId = dm.pushEvents<RunFunctionEvent>(0, 10, [&values](uint64_t i) {
+            return std::tuple{[&values, i](DependencyManager*) {
+                values.push_back(i);
+            }};
+        });
+        REQUIRE(firstId != 0);
+        dm.pushEvent<QuitEvent>(0);
+
+        dm.start();
+
+        REQUIRE(values == std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        REQUIRE(dm.pushEvents<RunFunctionEvent>(0, 10, [](uint64_t) { return std::tuple{[](DependencyManager*) {}}; }) == 0);
+    }
+
+    SECTION("Higher priority event preempts batch") {
+        Ichor::DependencyManager dm{};
+        std::vector<uint64_t> order{};
+
+        dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+        dm.createServiceManager<UselessService, IUselessService>();
+        dm.pushEvent<RunFunctionEvent>(0, [&order](DependencyManager *mng) {
+            order.push_back(1);
+            mng->pushPrioritisedEvent<RunFunctionEvent>(0, 10, [&order](DependencyManager*) {
+                order.push_back(2);
+            });
+        });
+        dm.pushEvent<RunFunctionEvent>(0, [&order](DependencyManager *mng) {
+            order.push_back(3);
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        // all events above fit in a single batch
+        dm.start();
+
+        REQUIRE(order == std::vector<uint64_t>{1, 2, 3});
+    }
+
+    SECTION("EventSlabAllocator recycles blocks") {
+        EventSlabAllocator allocator{};
+        std::vector<std::thread> threads{};
+
+        for(uint64_t i = 0; i < 4; i++) {
+            threads.emplace_back([&allocator] {
+                std::vector<void*> blocks{};
+                for(uint64_t round = 0; round < 100; round++) {
+                    for(uint64_t j = 0; j < 50; j++) {
+                        auto *p = allocator.allocate(200);
+                        std::memset(p, 0xAB, 200);
+                        blocks.push_back(p);
+                    }
+                    for(auto *p : blocks) {
+                        allocator.deallocate(p, 200);
+                    }
+                    blocks.clear();
+                }
+            });
+        }
+
+        for(auto &thread : threads) {
+            thread.join();
+        }
+
+        auto stats = allocator.getStatistics();
+        REQUIRE(stats.size() == EventSlabAllocator::SIZE_CLASSES);
+        auto &cls = stats[2];
+        REQUIRE(cls.blockSize == 256);
+        REQUIRE(cls.allocations == 4 * 100 * 50);
+        REQUIRE(cls.inUse == 0);
+        REQUIRE(cls.highWaterMark >= 50);
+        REQUIRE(cls.highWaterMark <= 200);
+        REQUIRE(cls.capacity >= cls.highWaterMark);
+        REQUIRE(cls.hits >= cls.allocations - cls.capacity);
+        REQUIRE(stats[0].allocations == 0);
+    }
+
+    SECTION("Big events use the event allocator") {
+        Ichor::DependencyManager dm{};
+
+        dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+        dm.createServiceManager<UselessService, IUselessService>();
+        for(uint64_t i = 0; i < 10; i++) {
+            dm.pushEvent<BigTestEvent>(0);
+            dm.pushEvent<TestEvent>(0);
+        }
+        dm.pushEvent<QuitEvent>(0);
+        dm.start();
+
+        auto stats = dm.getEventAllocatorStatistics();
+        uint64_t allocations{};
+        for(auto &cls : stats) {
+            allocations += cls.allocations;
+            REQUIRE(cls.inUse == 0);
+        }
+        REQUIRE(allocations == 10);
+    }
+
+    SECTION("TimerWheel fires timers in order of expiry") {
+        auto epoch = std::chrono::steady_clock::now();
+        TimerWheel wheel{std::pmr::new_delete_resource(), epoch};
+        std::vector<uint64_t> fired;
+
+        // one timer per level, plus one that does not fit in the wheel at all
+        wheel.add(epoch + 70s, {}, Ichor::function<void()>{[&fired]() { fired.push_back(3); }, std::pmr::new_delete_resource()});
+        wheel.add(epoch + 300ms, {}, Ichor::function<void()>{[&fired]() { fired.push_back(2); }, std::pmr::new_delete_resource()});
+        wheel.add(epoch + 5ms, {}, Ichor::function<void()>{[&fired]() { fired.push_back(1); }, std::pmr::new_delete_resource()});
+        wheel.add(epoch + std::chrono::hours(24 * 60), {}, Ichor::function<void()>{[&fired]() { fired.push_back(4); }, std::pmr::new_delete_resource()});
+        REQUIRE(wheel.size() == 4);
+        REQUIRE(wheel.nextDeadline() == epoch + 5ms);
+
+        REQUIRE(wheel.expire(epoch + 4ms) == 0);
+        REQUIRE(wheel.expire(epoch + 5ms) == 1);
+        REQUIRE(wheel.expire(epoch + 299ms) == 0);
+        REQUIRE(wheel.expire(epoch + 69s) == 1);
+        REQUIRE(wheel.expire(epoch + 70s) == 1);
+        REQUIRE(wheel.nextDeadline() <= epoch + std::chrono::hours(24 * 60));
+        REQUIRE(wheel.expire(epoch + std::chrono::hours(24 * 60) - 1ms) == 0);
+        REQUIRE(wheel.expire(epoch + std::chrono::hours(24 * 60)) == 1);
+
+        REQUIRE(fired == std::vector<uint64_t>{1, 2, 3, 4});
+        REQUIRE(wheel.empty());
+        REQUIRE(wheel.nextDeadline() == std::chrono::steady_clock::time_point::max());
+    }
+
+    SECTION("TimerWheel periodic and cancelled timers") {
+        auto epoch = std::chrono::steady_clock::now();
+        TimerWheel wheel{std::pmr::new_delete_resource(), epoch};
+        uint64_t periodicCount{};
+        uint64_t cancelledCount{};
+
+        auto periodic = wheel.add(epoch + 10ms, 10ms, Ichor::function<void()>{[&periodicCount]() { periodicCount++; }, std::pmr::new_delete_resource()});
+        auto cancelled = wheel.add(epoch + 20ms, {}, Ichor::function<void()>{[&cancelledCount]() { cancelledCount++; }, std::pmr::new_delete_resource()});
+        REQUIRE(wheel.cancel(cancelled));
+        REQUIRE_FALSE(wheel.cancel(cancelled));
+
+        // missed expiries are skipped, the timer keeps its phase
+        REQUIRE(wheel.expire(epoch + 35ms) == 1);
+        REQUIRE(wheel.nextDeadline() == epoch + 40ms);
+        REQUIRE(wheel.expire(epoch + 40ms) == 1);
+
+        // the pending expiry at 50ms moves along with the interval
+        REQUIRE(wheel.setInterval(periodic, 100ms));
+        REQUIRE(wheel.expire(epoch + 50ms) == 0);
+        REQUIRE(wheel.expire(epoch + 139ms) == 0);
+        REQUIRE(wheel.expire(epoch + 140ms) == 1);
+        REQUIRE(wheel.nextDeadline() <= epoch + 240ms);
+
+        REQUIRE(wheel.reschedule(periodic, epoch + 300ms, 5ms));
+        REQUIRE(wheel.expire(epoch + 299ms) == 0);
+        REQUIRE(wheel.expire(epoch + 300ms) == 1);
+        REQUIRE(wheel.nextDeadline() == epoch + 305ms);
+
+        REQUIRE(wheel.cancel(periodic));
+        REQUIRE(wheel.expire(epoch + 1s) == 0);
+        REQUIRE(periodicCount == 4);
+        REQUIRE(cancelledCount == 0);
+        REQUIRE(wheel.empty());
+
+        // a timer cancelling itself while firing
+        TimerHandle self{};
+        self = wheel.add(epoch + 2s, 1ms, Ichor::function<void()>{[&wheel, &self, &periodicCount]() { periodicCount++; REQUIRE(wheel.cancel(self)); }, std::pmr::new_delete_resource()});
+        REQUIRE(wheel.expire(epoch + 3s) == 1);
+        REQUIRE(periodicCount == 5);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("TimerWheel coalesces timers within its resolution") {
+        auto epoch = std::chrono::steady_clock::now();
+        TimerWheel wheel{std::pmr::new_delete_resource(), epoch};
+        wheel.setResolution(10ms);
+        uint64_t fired{};
+
+        wheel.add(epoch + 1ms, {}, Ichor::function<void()>{[&fired]() { fired++; }, std::pmr::new_delete_resource()});
+        wheel.add(epoch + 9ms, {}, Ichor::function<void()>{[&fired]() { fired++; }, std::pmr::new_delete_resource()});
+        REQUIRE_THROWS(wheel.setResolution(1ms));
+        REQUIRE(wheel.nextDeadline() == epoch + 10ms);
+
+        REQUIRE(wheel.expire(epoch + 9ms) == 0);
+        REQUIRE(wheel.expire(epoch + 10ms) == 2);
+        REQUIRE(fired == 2);
+
+        auto stats = wheel.getStatistics();
+        REQUIRE(stats.fired == 2);
+        REQUIRE(stats.totalLatenessNanosec == 10'000'000);
+        REQUIRE(stats.maxLatenessNanosec == 9'000'000);
+
+        // a periodic timer changing its own interval
+        TimerHandle handle{};
+        handle = wheel.add(epoch + 20ms, 10ms, Ichor::function<void()>{[&wheel, &handle, &fired]() { fired++; wheel.setInterval(handle, 50ms); }, std::pmr::new_delete_resource()});
+        REQUIRE(wheel.expire(epoch + 20ms) == 1);
+        REQUIRE(wheel.nextDeadline() == epoch + 70ms);
+    }
+
+    SECTION("Timers share the timing wheel of their manager") {
+        Ichor::DependencyManager dm{};
+        uint64_t ticks{};
+
+        dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+        dm.createServiceManager<UselessService, IUselessService>();
+        dm.pushEvent<RunFunctionEvent>(0, [&ticks](DependencyManager *mng) {
+            for(uint64_t i = 0; i < 2; i++) {
+                auto timer = mng->createServiceManager<Timer, ITimer>();
+                timer->setChronoInterval(5ms);
+                timer->setCallback([mng, &ticks](TimerEvent const * const) -> Generator<bool> {
+                    ticks++;
+                    if(ticks == 6) {
+                        mng->pushEvent<QuitEvent>(0);
+                    }
+                    co_return (bool)AllowOthersHandling;
+                });
+                timer->startTimer();
+            }
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        dm.start();
+
+        REQUIRE(ticks >= 6);
+        REQUIRE(std::chrono::steady_clock::now() - start >= 15ms);
+        REQUIRE(dm.getTimerStatistics().fired >= 6);
+        REQUIRE(dm.getEventLoopStatistics().timerWakeups > 0);
+    }
+
+    SECTION("Changing the interval of a timer moves its pending expiry") {
+        for(bool fromOtherThread : {false, true}) {
+            Ichor::DependencyManager dm{};
+            ITimer *timer{};
+            std::chrono::steady_clock::time_point started{};
+            std::chrono::steady_clock::time_point fired{};
+
+            std::thread t([&]() {
+                dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+                auto *timerSvc = dm.createServiceManager<Timer, ITimer>();
+                timer = timerSvc;
+                timerSvc->setChronoInterval(10s);
+                timerSvc->setCallback([&dm, &fired](TimerEvent const * const) -> Generator<bool> {
+                    fired = std::chrono::steady_clock::now();
+                    dm.pushEvent<QuitEvent>(0);
+                    co_return (bool)AllowOthersHandling;
+                });
+                dm.pushEvent<RunFunctionEvent>(0, [&started, timerSvc, fromOtherThread](DependencyManager *mng) {
+                    started = std::chrono::steady_clock::now();
+                    timerSvc->startTimer();
+                    if(!fromOtherThread) {
+                        mng->scheduleAfter(5ms, INTERNAL_EVENT_PRIORITY, [timerSvc](DependencyManager*) { timerSvc->setChronoInterval(20ms); });
+                    }
+                });
+                dm.start();
+            });
+
+            waitForRunning(dm);
+            dm.waitForEmptyQueue();
+            if(fromOtherThread) {
+                timer->setChronoInterval(20ms);
+            }
+
+            t.join();
+
+            // the first expiry is now 20ms after starting, instead of after the old interval of 10s
+            REQUIRE(fired - started >= 20ms);
+            REQUIRE(fired - started < 5s);
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/Events.h>
+#include <ichor/optional_bundles/network_bundle/NetworkEvents.h>
+
+using namespace Ichor;
+
+struct IFailedSendCounterService {
+    virtual std::vector<uint64_t>& getFailedMessageIds() = 0;
+
+protected:
+    ~IFailedSendCounterService() = default;
+};
+
+// Keeps track of the FailedSendMessageEvents of all connections, without depending on any of them so it keeps running while they stop
+struct FailedSendCounterService final : public IFailedSendCounterService, public Service<FailedSendCounterService> {
+    FailedSendCounterService() = default;
+
+    StartBehaviour start() final {
+        _failedHandler = getManager()->registerEventHandler<FailedSendMessageEvent>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _failedHandler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    bool handleEvent(FailedSendMessageEvent const * const evt) {
+        _failedMessageIds.push_back(evt->msgId);
+
+        return AllowOthersHandling;
+    }
+
+    std::vector<uint64_t>& getFailedMessageIds() final {
+        return _failedMessageIds;
+    }
+
+    EventHandlerRegistration _failedHandler{};
+    std::vector<uint64_t> _failedMessageIds{};
+};
@@ -4,6 +4,94 @@
 #include "DependencyService.h"
 #include "MixingInterfacesService.h"
 #include "StartStopOnSecondAttemptService.h"
+#include "EventHandlerService.h"
+#include "YieldingEventHandlerService.h"
+#include "AwaitingEventHandlerService.h"
+#include "DeadlineEventService.h"
+#include "TestEvents.h"
+#ifdef __linux__
+#include "EchoService.h"
+#include "ThrottledSenderService.h"
+#include "ErrorCounterService.h"
+#include <ichor/optional_bundles/logging_bundle/LoggerAdmin.h>
+#include <ichor/optional_bundles/logging_bundle/NullLogger.h>
+#include <ichor/optional_bundles/network_bundle/epoll/EpollReactorService.h>
+#include <ichor/optional_bundles/network_bundle/tcp/TcpHostService.h>
+#include <ichor/optional_bundles/network_bundle/tcp/TcpConnectionService.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <future>
+#endif
+#ifdef ICHOR_USE_IO_URING
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringQueueService.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringHostService.h>
+#include <ichor/optional_bundles/network_bundle/io_uring/IOUringConnectionService.h>
+#include "FailedSendCounterService.h"
+#endif
+
+#ifdef __linux__
+// Starts a manager with the given host service and echoes a message through it, using a plain blocking socket as client
+template <typename HostT, typename QueueT, typename QueueInterfaceT>
+void echoThroughHost(uint16_t port) {
+    Ichor::DependencyManager dm{};
+
+    std::thread t([&]() {
+        dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        dm.createServiceManager<QueueT, QueueInterfaceT>();
+        dm.createServiceManager<HostT, IHostService>(Properties{{"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})}, {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)}});
+        dm.createServiceManager<EchoService>();
+        dm.start();
+    });
+
+    waitForRunning(dm);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = -1;
+    // the host starts listening asynchronously
+    while(fd < 0) {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if(::connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+            ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    std::array<uint8_t, 5> msg{'h', 'e', 'l', 'l', 'o'};
+    REQUIRE(::send(fd, msg.data(), msg.size(), 0) == 5);
+
+    std::array<uint8_t, 5> echoed{};
+    uint64_t received = 0;
+    while(received < echoed.size()) {
+        auto ret = ::recv(fd, echoed.data() + received, echoed.size() - received, 0);
+        REQUIRE(ret > 0);
+        received += static_cast<uint64_t>(ret);
+    }
+    REQUIRE(echoed == msg);
+
+    ::close(fd);
+    dm.pushEvent<QuitEvent>(0);
+    t.join();
+}
+
+// Counts the started services implementing Interface on the thread of the manager
+template <typename Interface>
+uint64_t countStartedServices(DependencyManager &dm) {
+    std::promise<uint64_t> count;
+    auto future = count.get_future();
+    dm.pushEvent<RunFunctionEvent>(0, [&count](DependencyManager* mng) {
+        count.set_value(mng->getStartedServices<Interface>().size());
+    });
+    return future.get();
+}
+#endif
 
 TEST_CASE("DependencyServices") {
 
@@ -164,4 +252,588 @@ TEST_CASE("DependencyServices") {
 
         t.join();
     }
-}
\ No newline at end of file
+
+    SECTION("Coroutine and synchronous event handlers") {
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<EventHandlerService<TestEvent>, IEventHandlerService>();
+            dm.createServiceManager<EventHandlerService<TestEvent, true>, IEventHandlerService>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvent<TestEvent>(0);
+        dm.pushEvent<TestEvent>(0);
+
+        dm.waitForEmptyQueue();
+
+        dm.pushEvent<RunFunctionEvent>(0, [](DependencyManager* mng){
+            auto eventHandlerServices = mng->getStartedServices<IEventHandlerService>();
+
+            REQUIRE(eventHandlerServices.size() == 2);
+
+            for(auto *svc : eventHandlerServices) {
+                auto &handled = svc->getHandledEvents();
+                REQUIRE(handled.find(TestEvent::TYPE) != end(handled));
+                REQUIRE(handled.find(TestEvent::TYPE)->second == 2);
+            }
+
+            // the frame of the first coroutine handler call is reused for the second call
+            auto frameStats = mng->getCoroutineFrameStatistics();
+            REQUIRE(frameStats.allocations >= 2);
+            REQUIRE(frameStats.recycled >= 1);
+
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Yielding event handlers take turns with other events") {
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<YieldingEventHandlerService<TestEvent>, IYieldingEventHandlerService>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvents<TestEvent>(0, 2, [](uint64_t) { return std::tuple<>{}; });
+
+        dm.waitForEmptyQueue();
+
+        dm.pushEvent<RunFunctionEvent>(0, [](DependencyManager* mng){
+            auto services = mng->getStartedServices<IYieldingEventHandlerService>();
+
+            REQUIRE(services.size() == 1);
+
+            auto &steps = services[0]->getSteps();
+            REQUIRE(steps.size() == 2 * (YieldingEventHandlerService<TestEvent>::YIELDS + 1));
+
+            auto firstId = steps.front().first;
+            auto firstDone = std::find(steps.begin(), steps.end(), std::make_pair(firstId, YieldingEventHandlerService<TestEvent>::YIELDS));
+            auto secondStarted = std::find_if(steps.begin(), steps.end(), [firstId](auto const &step) { return step.first != firstId && step.second == 0; });
+            REQUIRE(firstDone != steps.end());
+            REQUIRE(secondStarted != steps.end());
+            // the second event is handled while the handler of the first one is still suspended
+            REQUIRE(secondStarted < firstDone);
+
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Resumed event handlers keep their place in the event queue") {
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<YieldingEventHandlerService<TestEvent>, IYieldingEventHandlerService>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        auto firstId = dm.pushEvents<TestEvent>(0, 2, [](uint64_t) { return std::tuple<>{}; });
+        auto secondId = firstId + 1;
+
+        dm.waitForEmptyQueue();
+
+        dm.pushEvent<RunFunctionEvent>(0, [firstId, secondId](DependencyManager* mng){
+            auto services = mng->getStartedServices<IYieldingEventHandlerService>();
+
+            REQUIRE(services.size() == 1);
+
+            // the second event was queued before the first handler yielded, so it goes before every resume. Afterwards both handlers take turns.
+            std::vector<std::pair<uint64_t, uint64_t>> expected{};
+            for(uint64_t i = 0; i <= YieldingEventHandlerService<TestEvent>::YIELDS; i++) {
+                expected.emplace_back(firstId, i);
+                expected.emplace_back(secondId, i);
+            }
+            REQUIRE(services[0]->getSteps() == expected);
+
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Event handlers can await events") {
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<AwaitingEventHandlerService, IAwaitingEventHandlerService>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvent<TestEvent>(0);
+        dm.waitForEmptyQueue();
+        dm.pushEvent<ValueEvent>(0, 0ul);
+        dm.pushEvent<ValueEvent>(0, 42ul);
+        dm.waitForEmptyQueue();
+
+        dm.pushEvent<RunFunctionEvent>(0, [](DependencyManager* mng){
+            auto services = mng->getStartedServices<IAwaitingEventHandlerService>();
+
+            REQUIRE(services.size() == 1);
+            REQUIRE(services[0]->getCompletedHandlers() == 1);
+            REQUIRE(services[0]->getReceivedValues() == std::vector<uint64_t>{42, 0});
+
+            // left suspended when quitting, has to be cleaned up by the manager
+            mng->pushEvent<TestEvent>(0);
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Suspended event handlers are destroyed with their service") {
+        Ichor::DependencyManager dm{};
+        uint64_t awaitingServiceId{};
+        AwaitingEventHandlerService::destroyedFrames = 0;
+        AwaitingEventHandlerService::resumedHandlers = 0;
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            awaitingServiceId = dm.createServiceManager<AwaitingEventHandlerService, IAwaitingEventHandlerService>()->getServiceId();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvent<TestEvent>(0);
+        dm.waitForEmptyQueue();
+        dm.pushEvent<RemoveServiceEvent>(0, awaitingServiceId);
+        dm.waitForEmptyQueue();
+
+        // would resume the handler of the removed service if it were still waiting
+        dm.pushEvent<ValueEvent>(0, 42ul);
+        dm.waitForEmptyQueue();
+
+        dm.pushEvent<RunFunctionEvent>(0, [](DependencyManager* mng){
+            REQUIRE(mng->getStartedServices<IAwaitingEventHandlerService>().empty());
+            REQUIRE(AwaitingEventHandlerService::destroyedFrames == 1);
+            REQUIRE(AwaitingEventHandlerService::resumedHandlers == 0);
+
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Events past their deadline are dropped") {
+        for(bool earliestDeadlineFirst : {false, true}) {
+            Ichor::DependencyManager dm{};
+            dm.setEarliestDeadlineFirst(earliestDeadlineFirst);
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<DeadlineEventService, IDeadlineEventService>();
+            // the event with the highest priority goes first regardless, events without deadline go last with earliest deadline first ordering
+            std::vector<uint64_t> expectedValues = earliestDeadlineFirst ? std::vector<uint64_t>{5, 4, 3, 1} : std::vector<uint64_t>{5, 1, 3, 4};
+
+            dm.pushEvent<RunFunctionEvent>(0, [&expectedValues](DependencyManager* mng) {
+                // all pushed before any of them is processed
+                auto now = std::chrono::steady_clock::now();
+                mng->pushEvent<ValueEvent>(0, 1ul);
+                auto missedId = mng->pushPrioritisedEventWithDeadline<ValueEvent>(0, INTERNAL_EVENT_PRIORITY, now - 1ms, 2ul);
+                mng->pushPrioritisedEventWithDeadline<ValueEvent>(0, INTERNAL_EVENT_PRIORITY, now + 2h, 3ul);
+                mng->pushPrioritisedEventWithDeadline<ValueEvent>(0, INTERNAL_EVENT_PRIORITY, now + 1h, 4ul);
+                mng->pushPrioritisedEventWithDeadline<ValueEvent>(0, INTERNAL_EVENT_PRIORITY - 1, now + 3h, 5ul);
+
+                mng->scheduleAfter(5ms, INTERNAL_EVENT_PRIORITY, [&expectedValues, missedId](DependencyManager* innerMng) {
+                    auto services = innerMng->getStartedServices<IDeadlineEventService>();
+
+                    REQUIRE(services.size() == 1);
+                    REQUIRE(services[0]->getReceivedValues() == expectedValues);
+                    REQUIRE(services[0]->getMissedEventIds() == std::vector<uint64_t>{missedId});
+
+                    innerMng->pushEvent<QuitEvent>(0);
+                });
+            });
+
+            dm.start();
+
+            REQUIRE(dm.getMissedDeadlineCount<ValueEvent>() == 1);
+            REQUIRE(dm.getMissedDeadlineCount<TestEvent>() == 0);
+            REQUIRE(dm.getMissedDeadlineCount<Event>() == 1);
+        }
+    }
+
+#ifdef __linux__
+    SECTION("Reactor calls back when a file descriptor becomes readable") {
+        Ichor::DependencyManager dm{};
+        std::array<int, 2> fds{};
+        REQUIRE(::pipe2(fds.data(), O_NONBLOCK | O_CLOEXEC) == 0);
+        std::vector<uint8_t> received;
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<EpollReactorService, IReactor>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager* mng) {
+            auto reactors = mng->getStartedServices<IReactor>();
+            REQUIRE(reactors.size() == 1);
+
+            reactors[0]->addFd(fds[0], IReactor::READABLE, Ichor::function<void(uint32_t)>{[&, mng, reactor = reactors[0]](uint32_t ready) {
+                REQUIRE((ready & IReactor::READABLE) == IReactor::READABLE);
+
+                std::array<uint8_t, 16> buf{};
+                ssize_t ret;
+                while((ret = ::read(fds[0], buf.data(), buf.size())) > 0) {
+                    received.insert(received.end(), buf.data(), buf.data() + ret);
+                }
+
+                reactor->removeFd(fds[0]);
+                mng->pushEvent<QuitEvent>(0);
+            }, mng->getMemoryResource()});
+        });
+
+        dm.waitForEmptyQueue();
+
+        // written from another thread, the reactor has to wake up the sleeping event loop
+        std::array<uint8_t, 3> data{1, 2, 3};
+        REQUIRE(::write(fds[1], data.data(), data.size()) == 3);
+
+        t.join();
+
+        REQUIRE(received == std::vector<uint8_t>{1, 2, 3});
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+#endif
+
+#ifdef __linux__
+    SECTION("TCP host with epoll reactor echoes data") {
+        echoThroughHost<TcpHostService, EpollReactorService, IReactor>(8031);
+    }
+#endif
+
+#ifdef __linux__
+    SECTION("TCP connection queues sends and signals watermarks") {
+        constexpr uint16_t port = 8033;
+        int listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int setting = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &setting, sizeof(setting));
+        // small kernel buffers on both ends, so they cannot absorb the stream and sends have to be queued. Accepted sockets inherit them.
+        int socketBufferSize = 16 * 1024;
+        ::setsockopt(listener, SOL_SOCKET, SO_RCVBUF, &socketBufferSize, sizeof(socketBufferSize));
+        ::setsockopt(listener, SOL_SOCKET, SO_SNDBUF, &socketBufferSize, sizeof(socketBufferSize));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        REQUIRE(::bind(listener, (sockaddr *)&address, sizeof(address)) == 0);
+        REQUIRE(::listen(listener, 1) == 0);
+
+        constexpr uint64_t highWatermark = 256 * 1024;
+        ThrottleStatistics stats{};
+        ThrottledSenderService::throttledOnce = false;
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<EpollReactorService, IReactor>();
+            dm.createServiceManager<TcpConnectionService, IConnectionService>(Properties{
+                {"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})},
+                {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)},
+                {"HighWatermark", Ichor::make_any<uint64_t>(dm.getMemoryResource(), highWatermark)},
+                {"LowWatermark", Ichor::make_any<uint64_t>(dm.getMemoryResource(), highWatermark / 4)},
+                {"SendBufferSize", Ichor::make_any<int>(dm.getMemoryResource(), socketBufferSize)}});
+            dm.createServiceManager<ThrottledSenderService, IThrottledSenderService>();
+            dm.start();
+        });
+
+        int fd = ::accept(listener, nullptr, nullptr);
+        REQUIRE(fd >= 0);
+
+        // nothing is read until the sender crossed the high watermark, which the kernel buffers are too small to prevent
+        auto waitStart = std::chrono::steady_clock::now();
+        while(!ThrottledSenderService::throttledOnce && std::chrono::steady_clock::now() - waitStart < 10s) {
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(ThrottledSenderService::throttledOnce);
+
+        std::vector<uint8_t> buf(65536);
+        uint64_t received = 0;
+        bool intact = true;
+        while(received < ThrottledSenderService::TOTAL_BYTES) {
+            auto ret = ::recv(fd, buf.data(), buf.size(), 0);
+            REQUIRE(ret > 0);
+            for(int64_t i = 0; i < ret; i++) {
+                intact &= buf[static_cast<uint64_t>(i)] == static_cast<uint8_t>((received + static_cast<uint64_t>(i)) % 251);
+            }
+            received += static_cast<uint64_t>(ret);
+        }
+
+        // the last bytes can arrive before the flush that sent them pushed the low watermark event, pushing again from the event loop queues behind it
+        dm.pushEvent<RunFunctionEvent>(0, [&stats](DependencyManager* mng) {
+            mng->pushEvent<RunFunctionEvent>(0, [&stats](DependencyManager* mng) {
+                auto senders = mng->getStartedServices<IThrottledSenderService>();
+                REQUIRE(senders.size() == 1);
+                stats = senders[0]->getStatistics();
+                mng->pushEvent<QuitEvent>(0);
+            });
+        });
+        t.join();
+        ::close(fd);
+        ::close(listener);
+
+        REQUIRE(intact);
+        REQUIRE(stats.failedSends == 0);
+        REQUIRE(stats.highWatermarks >= 1);
+        REQUIRE(stats.lowWatermarks == stats.highWatermarks);
+        // the sender stops at the first chunk that crosses the high watermark
+        REQUIRE(stats.maxQueuedBytes <= highWatermark + ThrottledSenderService::CHUNK_SIZE);
+    }
+#endif
+
+#ifdef __linux__
+    SECTION("TCP hosts on multiple managers share a port") {
+        constexpr uint16_t port = 8034;
+        constexpr uint64_t clients = 32;
+        std::array<Ichor::DependencyManager, 2> managers{};
+        std::vector<std::thread> threads{};
+
+        for(auto &dm : managers) {
+            threads.emplace_back([&dm, port]() {
+                dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+                dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+                dm.createServiceManager<EpollReactorService, IReactor>();
+                dm.createServiceManager<TcpHostService, IHostService>(Properties{
+                    {"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})},
+                    {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)},
+                    {"ReusePort", Ichor::make_any<bool>(dm.getMemoryResource(), true)},
+                    {"Backlog", Ichor::make_any<int>(dm.getMemoryResource(), 64)}});
+                dm.createServiceManager<EchoService>();
+                dm.start();
+            });
+        }
+
+        for(auto &dm : managers) {
+            waitForRunning(dm);
+            while(countStartedServices<IHostService>(dm) != 1) {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+        std::vector<int> fds{};
+        for(uint64_t i = 0; i < clients; i++) {
+            int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            REQUIRE(::connect(fd, (sockaddr *)&address, sizeof(address)) == 0);
+
+            std::array<uint8_t, 2> msg{'h', static_cast<uint8_t>(i)};
+            REQUIRE(::send(fd, msg.data(), msg.size(), 0) == 2);
+            std::array<uint8_t, 2> echoed{};
+            REQUIRE(::recv(fd, echoed.data(), echoed.size(), MSG_WAITALL) == 2);
+            REQUIRE(echoed == msg);
+            fds.push_back(fd);
+        }
+
+        // every connection lives on the manager that accepted it, the kernel spreads them over both
+        auto first = countStartedServices<IConnectionService>(managers[0]);
+        auto second = countStartedServices<IConnectionService>(managers[1]);
+        REQUIRE(first + second == clients);
+        REQUIRE(first > 0);
+        REQUIRE(second > 0);
+
+        for(auto fd : fds) {
+            ::close(fd);
+        }
+
+        // connections remove themselves once the peer closed them
+        for(auto &dm : managers) {
+            while(countStartedServices<IConnectionService>(dm) != 0) {
+                std::this_thread::sleep_for(1ms);
+            }
+            dm.pushEvent<QuitEvent>(0);
+        }
+
+        for(auto &t : threads) {
+            t.join();
+        }
+    }
+#endif
+
+#ifdef __linux__
+    SECTION("TCP connection retries a refused connection and then fails") {
+        // nothing listens on this port, so every connection attempt is refused
+        constexpr uint16_t port = 8037;
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<ErrorCounterService, IErrorCounterService>();
+            dm.createServiceManager<EpollReactorService, IReactor>();
+            dm.createServiceManager<TcpConnectionService, IConnectionService>(Properties{
+                {"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})},
+                {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)}});
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        std::atomic<uint64_t> recoverableErrors{};
+        std::atomic<uint64_t> unrecoverableErrors{};
+        std::atomic<uint64_t> connections{};
+        auto waitStart = std::chrono::steady_clock::now();
+        while(unrecoverableErrors == 0 && std::chrono::steady_clock::now() - waitStart < 10s) {
+            dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager* mng) {
+                auto counters = mng->getStartedServices<IErrorCounterService>();
+                REQUIRE(counters.size() == 1);
+                recoverableErrors = counters[0]->getRecoverableErrors();
+                unrecoverableErrors = counters[0]->getUnrecoverableErrors();
+                connections = mng->getStartedServices<IConnectionService>().size();
+            });
+            std::this_thread::sleep_for(1ms);
+        }
+
+        dm.pushEvent<QuitEvent>(0);
+        t.join();
+
+        REQUIRE(recoverableErrors == 5);
+        REQUIRE(unrecoverableErrors == 1);
+        REQUIRE(connections == 0);
+    }
+#endif
+
+#ifdef ICHOR_USE_IO_URING
+    SECTION("io_uring host echoes data") {
+        echoThroughHost<IOUringHostService, IOUringQueueService, IIOUringQueue>(8032);
+    }
+
+    SECTION("io_uring connection sends once connected") {
+        constexpr uint16_t port = 8035;
+        int listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int setting = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &setting, sizeof(setting));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        REQUIRE(::bind(listener, (sockaddr *)&address, sizeof(address)) == 0);
+        REQUIRE(::listen(listener, 1) == 0);
+
+        Ichor::DependencyManager dm{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<IOUringQueueService, IIOUringQueue>();
+            dm.createServiceManager<IOUringConnectionService, IConnectionService>(Properties{
+                {"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})},
+                {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)}});
+            dm.start();
+        });
+
+        waitForRunning(dm);
+
+        // sent right away, while the connection might still be in progress
+        dm.pushEvent<RunFunctionEvent>(0, [](DependencyManager* mng) {
+            auto connections = mng->getStartedServices<IConnectionService>();
+            REQUIRE(connections.size() == 1);
+            std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> msg{mng->getMemoryResource()};
+            msg.assign({'h', 'e', 'l', 'l', 'o'});
+            connections[0]->sendAsync(std::move(msg));
+        });
+
+        int fd = ::accept(listener, nullptr, nullptr);
+        REQUIRE(fd >= 0);
+
+        std::array<uint8_t, 5> received{};
+        uint64_t receivedBytes = 0;
+        while(receivedBytes < received.size()) {
+            auto ret = ::recv(fd, received.data() + receivedBytes, received.size() - receivedBytes, 0);
+            REQUIRE(ret > 0);
+            receivedBytes += static_cast<uint64_t>(ret);
+        }
+        REQUIRE(received == std::array<uint8_t, 5>{'h', 'e', 'l', 'l', 'o'});
+
+        dm.pushEvent<QuitEvent>(0);
+        t.join();
+        ::close(fd);
+        ::close(listener);
+    }
+
+    SECTION("io_uring connection fails unsent messages when stopped while connecting") {
+        constexpr uint16_t port = 8036;
+        int listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int setting = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &setting, sizeof(setting));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        REQUIRE(::bind(listener, (sockaddr *)&address, sizeof(address)) == 0);
+        REQUIRE(::listen(listener, 0) == 0);
+
+        // fills the accept queue, so the SYN of the next connection is dropped and its connect stays in progress.
+        // A blocking connect would stall the event loop here, instead of letting the rest of the test run.
+        int filler = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        REQUIRE(::connect(filler, (sockaddr *)&address, sizeof(address)) == 0);
+
+        Ichor::DependencyManager dm{};
+        uint64_t connectionId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<NullFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<IOUringQueueService, IIOUringQueue>();
+            connectionId = dm.createServiceManager<IOUringConnectionService, IConnectionService>(Properties{
+                {"Address", Ichor::make_any<std::string>(dm.getMemoryResource(), std::string{"127.0.0.1"})},
+                {"Port", Ichor::make_any<uint16_t>(dm.getMemoryResource(), port)}})->getServiceId();
+            dm.createServiceManager<FailedSendCounterService, IFailedSendCounterService>();
+            dm.start();
+        });
+
+        waitForRunning(dm);
+        dm.waitForEmptyQueue();
+
+        std::vector<uint64_t> sentIds{};
+        dm.pushEvent<RunFunctionEvent>(0, [&sentIds](DependencyManager* mng) {
+            auto connections = mng->getStartedServices<IConnectionService>();
+            REQUIRE(connections.size() == 1);
+            for(uint8_t i = 0; i < 3; i++) {
+                std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> msg{mng->getMemoryResource()};
+                msg.push_back(i);
+                sentIds.push_back(connections[0]->sendAsync(std::move(msg)));
+            }
+        });
+        dm.waitForEmptyQueue();
+        dm.pushEvent<StopServiceEvent>(0, connectionId);
+        dm.waitForEmptyQueue();
+
+        std::vector<uint64_t> failedIds{};
+        dm.pushEvent<RunFunctionEvent>(0, [&failedIds](DependencyManager* mng) {
+            auto counters = mng->getStartedServices<IFailedSendCounterService>();
+            REQUIRE(counters.size() == 1);
+            failedIds = counters[0]->getFailedMessageIds();
+            mng->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+        ::close(filler);
+        ::close(listener);
+
+        REQUIRE(failedIds == sentIds);
+    }
+#endif
+}
@@ -11,4 +11,14 @@ struct TestEvent final : public Event {
 
     static constexpr uint64_t TYPE = typeNameHash<TestEvent>();
     static constexpr std::string_view NAME = typeName<TestEvent>();
-};
\ No newline at end of file
+};
+
+struct ValueEvent final : public Event {
+    explicit ValueEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _value) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority), value(_value) {}
+    ~ValueEvent() final = default;
+
+    uint64_t value;
+    static constexpr uint64_t TYPE = typeNameHash<ValueEvent>();
+    static constexpr std::string_view NAME = typeName<ValueEvent>();
+};
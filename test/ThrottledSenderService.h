@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <ichor/Service.h>
+#include <ichor/Events.h>
+#include <ichor/optional_bundles/network_bundle/NetworkEvents.h>
+#include <ichor/optional_bundles/network_bundle/IConnectionService.h>
+
+using namespace Ichor;
+
+struct ThrottleStatistics {
+    uint64_t highWatermarks{};
+    uint64_t lowWatermarks{};
+    uint64_t maxQueuedBytes{};
+    uint64_t failedSends{};
+};
+
+struct IThrottledSenderService {
+    virtual ThrottleStatistics& getStatistics() = 0;
+
+protected:
+    ~IThrottledSenderService() = default;
+};
+
+// Sends TOTAL_BYTES over its connection, one chunk per event loop iteration, pausing between a high and low watermark event.
+// Byte i of the stream is i % 251, so the receiver can check nothing got lost or reordered.
+struct ThrottledSenderService final : public IThrottledSenderService, public Service<ThrottledSenderService> {
+    static constexpr uint64_t TOTAL_BYTES = 32 * 1024 * 1024;
+    static constexpr uint64_t CHUNK_SIZE = 64 * 1024;
+
+    ThrottledSenderService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        reg.registerDependency<IConnectionService>(this, true);
+    }
+
+    StartBehaviour start() final {
+        _highHandler = getManager()->registerEventHandler<SendQueueHighWatermarkEvent>(this);
+        _lowHandler = getManager()->registerEventHandler<SendQueueLowWatermarkEvent>(this);
+        _failedHandler = getManager()->registerEventHandler<FailedSendMessageEvent>(this);
+        sendChunk();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _highHandler.reset();
+        _lowHandler.reset();
+        _failedHandler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    void addDependencyInstance(IConnectionService *connectionService, IService *) {
+        _connection = connectionService;
+    }
+
+    void removeDependencyInstance(IConnectionService *, IService *) {
+        _connection = nullptr;
+    }
+
+    bool handleEvent(SendQueueHighWatermarkEvent const * const evt) {
+        _stats.highWatermarks++;
+        _stats.maxQueuedBytes = std::max(_stats.maxQueuedBytes, evt->queuedBytes);
+        _throttled = true;
+        throttledOnce = true;
+
+        return PreventOthersHandling;
+    }
+
+    bool handleEvent(SendQueueLowWatermarkEvent const * const) {
+        _stats.lowWatermarks++;
+        _throttled = false;
+        sendChunk();
+
+        return PreventOthersHandling;
+    }
+
+    bool handleEvent(FailedSendMessageEvent const * const) {
+        _stats.failedSends++;
+
+        return PreventOthersHandling;
+    }
+
+    ThrottleStatistics& getStatistics() final {
+        return _stats;
+    }
+
+    void sendChunk() {
+        if(_throttled || _connection == nullptr || _sent == TOTAL_BYTES) {
+            return;
+        }
+
+        std::vector<uint8_t, Ichor::PolymorphicAllocator<uint8_t>> chunk{getMemoryResource()};
+        chunk.reserve(CHUNK_SIZE);
+        for(uint64_t i = 0; i < CHUNK_SIZE; i++) {
+            chunk.push_back(static_cast<uint8_t>((_sent + i) % 251));
+        }
+        _sent += CHUNK_SIZE;
+        _connection->sendAsync(std::move(chunk));
+
+        getManager()->pushEvent<RunFunctionEvent>(getServiceId(), [this](DependencyManager*) { sendChunk(); });
+    }
+
+    EventHandlerRegistration _highHandler{};
+    EventHandlerRegistration _lowHandler{};
+    EventHandlerRegistration _failedHandler{};
+    IConnectionService *_connection{};
+    ThrottleStatistics _stats{};
+    uint64_t _sent{};
+    bool _throttled{};
+    // lets the receiving side of the test hold off reading until sends had to be queued
+    static inline std::atomic<bool> throttledOnce{};
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/Events.h>
+
+using namespace Ichor;
+
+struct IYieldingEventHandlerService {
+    // every step of every handled event, as (event id, step)
+    virtual std::vector<std::pair<uint64_t, uint64_t>>& getSteps() = 0;
+
+protected:
+    ~IYieldingEventHandlerService() = default;
+};
+
+template <Derived<Event> EventT>
+struct YieldingEventHandlerService final : public IYieldingEventHandlerService, public Service<YieldingEventHandlerService<EventT>> {
+    static constexpr uint64_t YIELDS = 3;
+
+    YieldingEventHandlerService() = default;
+
+    StartBehaviour start() final {
+        _handler = this->getManager()->template registerEventHandler<EventT>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    Generator<bool> handleEvent(EventT const * const evt) {
+        auto id = evt->id;
+        for(uint64_t i = 0; i < YIELDS; i++) {
+            steps.emplace_back(id, i);
+            co_yield (bool)AllowOthersHandling;
+        }
+
+        steps.emplace_back(id, YIELDS);
+        co_return (bool)AllowOthersHandling;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>>& getSteps() final {
+        return steps;
+    }
+
+    EventHandlerRegistration _handler{};
+    std::vector<std::pair<uint64_t, uint64_t>> steps;
+};